@@ -0,0 +1,129 @@
+/* mirror_ring.c */
+
+/* A ring buffer mapped twice, back to back, so that every window is contiguous, see mirror_ring.h */
+
+#define _GNU_SOURCE    /* needed for memfd_create() */
+
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>    /* needed for ftruncate(), close() and sysconf() */
+#include <sys/mman.h>  /* needed for mmap() and memfd_create() */
+
+#include "mirror_ring.h"
+
+/*-----------------------------------------------------------------------------*/
+
+int mr_init(struct mirror_ring *mr, size_t min_bytes)
+{
+    size_t         page = (size_t) sysconf(_SC_PAGESIZE);
+    size_t         size = page;
+    unsigned char *base;
+    int            fd;
+
+    memset(mr, 0, sizeof(*mr));
+    while(size < min_bytes) size <<= 1; /* a power of two, and so a whole number of pages */
+
+    fd = memfd_create("mirror_ring", MFD_CLOEXEC);
+    if(fd < 0)
+        {
+            perror("mr_init(): memfd_create()");
+            return 1;
+        }
+    if(ftruncate(fd, (off_t) size) != 0)
+        {
+            perror("mr_init(): ftruncate()");
+            close(fd);
+            return 1;
+        }
+
+    /* reserve twice the address space, then map the memfd over each half of it */
+    base = (unsigned char *) mmap(NULL, 2 * size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if(base == MAP_FAILED)
+        {
+            perror("mr_init(): mmap() of the address space");
+            close(fd);
+            return 1;
+        }
+    if((mmap(base, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0) == MAP_FAILED)
+            || (mmap(base + size, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0) == MAP_FAILED))
+        {
+            perror("mr_init(): mmap() of the mirror");
+            munmap(base, 2 * size);
+            close(fd);
+            return 1;
+        }
+    close(fd); /* the mappings keep the memory */
+
+    mr->base = base;
+    mr->size = size;
+    mr->mask = size - 1;
+    return 0;
+}
+
+/*-----------------------------------------------------------------------------*/
+
+void mr_free(struct mirror_ring *mr)
+{
+    if(mr->base != NULL) munmap(mr->base, 2 * mr->size);
+    mr->base = NULL;
+}
+
+/*-----------------------------------------------------------------------------*/
+
+size_t mr_count(const struct mirror_ring *mr)
+{
+    return mr->head - mr->tail;
+}
+
+/*-----------------------------------------------------------------------------*/
+
+size_t mr_space(const struct mirror_ring *mr)
+{
+    return mr->size - (mr->head - mr->tail);
+}
+
+/*-----------------------------------------------------------------------------*/
+
+int mr_put(struct mirror_ring *mr, const void *data, size_t n)
+{
+    if(n > mr_space(mr)) return 1;
+    memcpy(mr->base + (mr->head & mr->mask), data, n); /* one copy, even across the wrap */
+    mr->head += n;
+    return 0;
+}
+
+/*-----------------------------------------------------------------------------*/
+
+unsigned char *mr_write_pointer(const struct mirror_ring *mr)
+{
+    return mr->base + (mr->head & mr->mask);
+}
+
+/*-----------------------------------------------------------------------------*/
+
+void mr_commit(struct mirror_ring *mr, size_t n)
+{
+    mr->head += n;
+}
+
+/*-----------------------------------------------------------------------------*/
+
+unsigned char *mr_read_pointer(const struct mirror_ring *mr)
+{
+    return mr->base + (mr->tail & mr->mask);
+}
+
+/*-----------------------------------------------------------------------------*/
+
+void mr_consume(struct mirror_ring *mr, size_t n)
+{
+    mr->tail += n;
+}
+
+/*-----------------------------------------------------------------------------*/
+
+unsigned char *mr_latest(const struct mirror_ring *mr, size_t n)
+{
+    return mr->base + ((mr->head - n) & mr->mask);
+}
+/*-----------------------------------------------------------------------------*/
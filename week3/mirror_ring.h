@@ -0,0 +1,56 @@
+/* mirror_ring.h */
+
+/* A ring buffer whose store is mapped into memory twice, one copy straight after the other.
+
+   A reader of the circular queues in the workshops must find each item by
+   (next_sub + MAX_LENGTH - k) % MAX_LENGTH, and anything that wants the items as one block,
+   write(), or a loop over an array, must deal with the wrap-around, in two parts, or by copying.
+
+   Here the same physical pages, of a memfd, are mapped at base, and again at base + size,
+   so the byte at base + size + i is the byte at base + i. Any run of up to size bytes, starting
+   anywhere in the first copy, is contiguous in virtual memory, however it wraps in the ring,
+   and a reader can hand a single pointer, and a length, to write(), or to a loop, without any copy.
+   A writer can do the same, filling the space up to the tail in place, and then committing it.
+
+   size is a power of two, at least a page, so that offsets are found with a mask.
+   head and tail count bytes, and are never wrapped themselves, as in ring_buffer.h.
+
+   memfd_create() is Linux only. A mirror ring is for one thread, as ring_buffer.h is. */
+
+#ifndef MIRROR_RING_H
+#define MIRROR_RING_H
+
+#include <stddef.h>    /* needed for size_t */
+
+struct mirror_ring
+{
+    unsigned char *base;  /* 2 * size bytes of address space, the same size bytes twice */
+    size_t         size;  /* a power of two, and a whole number of pages */
+    size_t         mask;  /* size - 1 */
+    size_t         head;  /* bytes ever written */
+    size_t         tail;  /* bytes ever read */
+};
+
+/* map a ring of at least min_bytes, returns 0 on success, or 1 with a message on stderr */
+int            mr_init(struct mirror_ring *mr, size_t min_bytes);
+void           mr_free(struct mirror_ring *mr);
+
+/* the bytes waiting to be read, and the room left */
+size_t         mr_count(const struct mirror_ring *mr);
+size_t         mr_space(const struct mirror_ring *mr);
+
+/* copy n bytes in, returns 0, or 1 if there is not room for them all */
+int            mr_put(struct mirror_ring *mr, const void *data, size_t n);
+
+/* write in place: mr_space() contiguous bytes at the pointer, then commit the n that were written */
+unsigned char *mr_write_pointer(const struct mirror_ring *mr);
+void           mr_commit(struct mirror_ring *mr, size_t n);
+
+/* read in place: mr_count() contiguous bytes at the pointer, then consume the n that were used */
+unsigned char *mr_read_pointer(const struct mirror_ring *mr);
+void           mr_consume(struct mirror_ring *mr, size_t n);
+
+/* the latest n bytes written, n <= mr_count(), contiguous, without consuming them */
+unsigned char *mr_latest(const struct mirror_ring *mr, size_t n);
+
+#endif /* MIRROR_RING_H */
@@ -0,0 +1,152 @@
+/* mirror_ring_01.c */
+
+/*
+   A mirrored ring buffer (see mirror_ring.c), against the % subscripts of the workshop queues.
+
+   Samples are put into the ring, one at a time, as a sampler would, until it has wrapped round
+   many times, so that the window of the latest samples is almost always split across the end of the store.
+
+   1. the mean of the latest WINDOW samples is found, over and over, as the window moves:
+      by the % subscript of print_list_items(), (next_sub + (capacity-k)) % capacity, for each sample,
+      and by one plain loop over a single pointer, from mr_latest(), which the compiler can vectorise.
+   2. everything waiting in the ring is written out with one write(), from mr_read_pointer(),
+      where a circular queue needs two, or a copy first.
+
+   Compilation advice:
+
+   gcc -std=gnu99 -Wall -Wextra -Werror -O2 -o mirror_ring_01 mirror_ring_01.c mirror_ring.c
+
+   An execution suggestion:
+
+   ./mirror_ring_01
+   ./mirror_ring_01 samples.bin
+
+   The optional parameter is a file for the write() of part 2 (default /dev/null).
+
+   Times are in nanoseconds.
+*/
+
+#include <stdio.h>     /* needed for printf() */
+#include <stdlib.h>
+#include <stdint.h>    /* defines some types, including: int64_t */
+#include <fcntl.h>     /* needed for open() */
+#include <time.h>      /* needed for clock_gettime() and CLOCK_MONOTONIC */
+#include <unistd.h>    /* needed for write() */
+
+#include "mirror_ring.h"
+
+#define CAPACITY   4096   /* samples in the ring */
+#define WINDOW     4000   /* samples in each mean */
+#define N_MEANS   20000   /* the number of windows, each one sample on from the last */
+
+/* Set up structures for the starting and stopping times */
+static struct timespec start, end;
+
+/* We are free to define the items that will be in a queue_item */
+typedef struct
+{
+    int64_t time_value;
+    int     sample_value;
+    int     sequence;
+} queue_item;
+
+/* function templates */
+static int64_t timespecDiff(struct timespec *timeA_p, struct timespec *timeB_p);
+static int64_t elapsed_time(void);
+static void    error_exit(char *s);
+
+int main(int argc, char *argv[])
+{
+    struct mirror_ring mr;
+    queue_item        *queue_store;   /* the same samples, in a workshop queue */
+    volatile size_t    capacity = CAPACITY; /* known only at run time, as for a queue of any size */
+    const queue_item  *window;
+    queue_item         item;
+    size_t  next_sub = 0;
+    size_t  sub, k;
+    int64_t sum_modulo = 0, sum_mirror = 0;
+    int64_t ns_modulo  = 0, ns_mirror  = 0;
+    size_t  n_bytes;
+    ssize_t n_written;
+    long    m;
+    int     fd;
+
+    if(mr_init(&mr, CAPACITY * sizeof(queue_item)) != 0) return EXIT_FAILURE;
+    queue_store = (queue_item *) malloc(CAPACITY * sizeof(queue_item));
+    if(queue_store == NULL) error_exit("out of memory");
+
+    /* fill both, and go round a few times, so that the windows wrap */
+    for (m=0; m<N_MEANS + 3*CAPACITY; m++)
+        {
+            item.time_value   = m * 1000;
+            item.sample_value = rand();
+            item.sequence     = (int) m;
+
+            if(mr_space(&mr) < sizeof(item)) mr_consume(&mr, sizeof(item)); /* keep the latest, only */
+            (void) mr_put(&mr, &item, sizeof(item));
+            queue_store[next_sub] = item;
+            next_sub = (next_sub + 1) % capacity;
+
+            if(m < 3*CAPACITY) continue;
+
+            /* 1. the mean of the latest WINDOW, both ways */
+            clock_gettime(CLOCK_MONOTONIC, &start);
+            for (k=1; k<=WINDOW; k++)
+                {
+                    sub = (next_sub + (capacity - k)) % capacity;
+                    sum_modulo += queue_store[sub].sample_value;
+                }
+            ns_modulo += elapsed_time();
+
+            clock_gettime(CLOCK_MONOTONIC, &start);
+            window = (const queue_item *) mr_latest(&mr, WINDOW * sizeof(queue_item));
+            for (k=0; k<WINDOW; k++)
+                sum_mirror += window[k].sample_value;
+            ns_mirror += elapsed_time();
+        }
+
+    printf("the mean of the latest %d of %d samples, %d times, as the window moves round:\n", WINDOW, CAPACITY, N_MEANS);
+    printf("   %% subscripts:    %6.3f ns per sample (sum %ld)\n", (double) ns_modulo / ((double) N_MEANS * WINDOW), (long) sum_modulo);
+    printf("   mirrored ring:   %6.3f ns per sample (sum %ld)\n", (double) ns_mirror / ((double) N_MEANS * WINDOW), (long) sum_mirror);
+    if(sum_modulo != sum_mirror) error_exit("the two sums are different");
+
+    /* 2. everything in the ring, in one write(), although it wraps round */
+    fd = open((argc > 1) ? argv[1] : "/dev/null", O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if(fd < 0) error_exit("unable to open the output file");
+    n_bytes = mr_count(&mr);
+    printf("%ld bytes waiting, from offset %ld in a ring of %ld, written with one write(): ",
+           (long) n_bytes, (long) (mr.tail & mr.mask), (long) mr.size);
+    n_written = write(fd, mr_read_pointer(&mr), n_bytes);
+    printf("%ld bytes\n", (long) n_written);
+    if(n_written > 0) mr_consume(&mr, (size_t) n_written);
+    close(fd);
+
+    free(queue_store);
+    mr_free(&mr);
+    return 0;
+}
+
+/*-----------------------------------------------------------------------------*/
+
+static int64_t timespecDiff(struct timespec *timeA_p, struct timespec *timeB_p)
+{
+    return (int64_t) ((timeA_p->tv_sec * 1000000000) + timeA_p->tv_nsec) -
+           ((timeB_p->tv_sec * 1000000000) + timeB_p->tv_nsec);
+}
+
+/*-----------------------------------------------------------------------------*/
+
+static int64_t elapsed_time(void)
+{
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    return (int64_t) timespecDiff(&end, &start);
+}
+
+/*-----------------------------------------------------------------------------*/
+
+/* A standard formatter for printing eror messages, and exiting */
+static void error_exit(char *s)
+{
+    fprintf(stderr, "\nerror: %s - bye!\n",s);
+    exit(1);
+}
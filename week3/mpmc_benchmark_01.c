@@ -0,0 +1,356 @@
+/* mpmc_benchmark_01.c */
+
+/*
+   Several producers, one queue, one dispatcher: the lock-free MPMC queue (see mpmc_queue.c),
+   against add_list_item() and dispatch_list_item() of circular_queue_example_04.c,
+   made safe for threads in the obvious way, with a mutex round each.
+
+   For each number of producer threads, 1, 2, 4 ... 64, the producers share out the items between
+   them, and put them all into the queue, while the dispatcher threads (one, unless -c says otherwise)
+   take them out. A producer that finds the queue full, or a dispatcher that finds it empty,
+   gives up its processor with sched_yield(), and tries again.
+   All of the threads are released together, by a barrier, and the time is taken until the last has finished.
+
+   Each item carries its producer and its sequence number. The sum of the sequence numbers that
+   come out is checked against the sum that went in, and, with a single dispatcher, each producer's
+   items are checked to come out in the order that they went in.
+
+   With fewer processors than threads, much of the time goes in switching between them, for both queues,
+   and a thread pre-empted while it holds the mutex holds up every other.
+
+   Compilation advice:
+
+   gcc -std=gnu99 -Wall -Wextra -Werror -O2 -o mpmc_benchmark_01 mpmc_benchmark_01.c mpmc_queue.c -pthread
+
+   An execution suggestion:
+
+   ./mpmc_benchmark_01
+   ./mpmc_benchmark_01 -i 4000000 -c 4
+
+   options:
+   -i n_items      the items through the queue, in each test (default 1000000)
+   -c n_consumers  the dispatcher threads (default 1)
+
+   Times are in nanoseconds.
+*/
+
+#include <stdio.h>     /* needed for printf() */
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>    /* defines some types, including: int64_t */
+#include <time.h>      /* needed for clock_gettime() and CLOCK_MONOTONIC */
+#include <sched.h>     /* needed for sched_yield() */
+#include <unistd.h>    /* needed for getopt() */
+#include <pthread.h>
+
+#include "mpmc_queue.h"
+
+#define N_ITEMS      1000000  /* the default */
+#define MAX_THREADS       64  /* producers, at most */
+#define MAX_CONSUMERS     16
+#define MAX_LENGTH      1024  /* both queues have this capacity */
+
+#define USAGE "Usage is: ./mpmc_benchmark_01 [-i n_items] [-c n_consumers]\n"
+
+/* Set up structures for the starting and stopping times */
+static struct timespec start, end;
+
+/* We are free to define the items that will be in a queue_item */
+typedef struct
+{
+    int thing1;  /* the producer */
+    int thing2;  /* its sequence number */
+} queue_item;
+
+/* the workshop queue, global, as it is there, and now with a lock */
+static queue_item      queue_store[MAX_LENGTH];
+static int             next_sub = 0;
+static int             n_items  = 0;
+static pthread_mutex_t queue_lock = PTHREAD_MUTEX_INITIALIZER;
+
+/* the lock-free queue */
+static struct mpmc_queue mpmc;
+
+/* the two queues, behind the same two calls */
+struct queue_kind
+{
+    const char *name;
+    int       (*put)(const queue_item *item);
+    int       (*get)(queue_item *item);
+};
+
+/* one test */
+struct test
+{
+    const struct queue_kind *kind;
+    int                 n_producers;
+    int                 n_consumers;
+    long                per_producer;
+    long                n_total;
+    long                n_taken;       /* by all of the dispatchers, so far */
+    pthread_barrier_t   barrier;
+    int64_t             sum;           /* of the sequence numbers taken out */
+    long                n_out_of_order;
+};
+
+/* one thread of a test */
+struct worker
+{
+    struct test *test;
+    int          id;
+};
+
+/* function templates */
+static int     add_list_item(queue_item input_value);
+static int     dispatch_list_item(queue_item *output_value);
+static int     locked_put(const queue_item *item);
+static int     locked_get(queue_item *item);
+static int     mpmc_put_item(const queue_item *item);
+static int     mpmc_get_item(queue_item *item);
+static int64_t run_test(struct test *t);
+static void   *produce(void *arg);
+static void   *dispatch(void *arg);
+static int64_t timespecDiff(struct timespec *timeA_p, struct timespec *timeB_p);
+static void    error_exit(char *s);
+
+static const struct queue_kind kinds[2] =
+{
+    { "mutex", locked_put,    locked_get    },
+    { "mpmc",  mpmc_put_item, mpmc_get_item },
+};
+
+int main(int argc, char *argv[])
+{
+    static struct test t;
+    long    n_total = N_ITEMS;
+    int     n_consumers = 1;
+    int64_t ns[2];
+    int64_t expected;
+    int     n, k;
+    int     opt;
+
+    while((opt = getopt(argc, argv, "i:c:")) != -1)
+        switch(opt)
+            {
+            case 'i':
+                n_total = atol(optarg);
+                break;
+            case 'c':
+                n_consumers = atoi(optarg);
+                break;
+            default:
+                fprintf(stderr, USAGE);
+                return EXIT_FAILURE;
+            }
+    if((n_total < MAX_THREADS) || (n_consumers < 1) || (n_consumers > MAX_CONSUMERS))
+        {
+            fprintf(stderr, USAGE);
+            return EXIT_FAILURE;
+        }
+    if(mpmc_init(&mpmc, sizeof(queue_item), MAX_LENGTH) != 0) error_exit("out of memory");
+
+    printf("%ld items, %d dispatcher%s, %ld processor%s\n", n_total, n_consumers, (n_consumers > 1) ? "s" : "",
+           sysconf(_SC_NPROCESSORS_ONLN), (sysconf(_SC_NPROCESSORS_ONLN) > 1) ? "s" : "");
+    printf("%10s %16s %16s %10s\n", "producers", "mutex ns/item", "mpmc ns/item", "speed-up");
+
+    for (n=1; n<=MAX_THREADS; n*=2)
+        {
+            for (k=0; k<2; k++)
+                {
+                    memset(&t, 0, sizeof(t));
+                    t.kind         = &kinds[k];
+                    t.n_producers  = n;
+                    t.n_consumers  = n_consumers;
+                    t.per_producer = n_total / n;
+                    t.n_total      = t.per_producer * n;
+                    ns[k] = run_test(&t);
+
+                    /* every item out that went in, and in order, for each producer */
+                    expected = (int64_t) n * ((int64_t) t.per_producer * (t.per_producer - 1) / 2);
+                    if(t.sum != expected) error_exit("the items that came out are not the items that went in");
+                    if(t.n_out_of_order > 0) error_exit("a producer's items came out of order");
+                    ns[k] = ns[k] / t.n_total;
+                }
+            printf("%10d %16ld %16ld %10.2f\n", n, (long) ns[0], (long) ns[1],
+                   (double) ns[0] / (double) (ns[1] > 0 ? ns[1] : 1));
+        }
+
+    mpmc_free(&mpmc);
+    return 0;
+}
+
+/*-----------------------------------------------------------------------------*/
+
+/* Start every thread of a test, release them together, and time them until they have all finished */
+static int64_t run_test(struct test *t)
+{
+    pthread_t     thread[MAX_THREADS + MAX_CONSUMERS];
+    struct worker worker[MAX_THREADS + MAX_CONSUMERS];
+    int n_threads = t->n_producers + t->n_consumers;
+    int i;
+
+    if(pthread_barrier_init(&t->barrier, NULL, (unsigned) n_threads + 1) != 0) error_exit("no barrier");
+    for (i=0; i<n_threads; i++)
+        {
+            worker[i].test = t;
+            worker[i].id   = i;
+            if(pthread_create(&thread[i], NULL, (i < t->n_producers) ? produce : dispatch, &worker[i]) != 0)
+                error_exit("unable to start a thread");
+        }
+
+    (void) pthread_barrier_wait(&t->barrier); /* they are all ready */
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (i=0; i<n_threads; i++) (void) pthread_join(thread[i], NULL);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    (void) pthread_barrier_destroy(&t->barrier);
+    return timespecDiff(&end, &start);
+}
+
+/*-----------------------------------------------------------------------------*/
+
+/* A producer: its share of the items, each with its own id and a sequence number */
+static void *produce(void *arg)
+{
+    struct worker *w = (struct worker *) arg;
+    struct test   *t = w->test;
+    queue_item     item;
+    long           s;
+
+    (void) pthread_barrier_wait(&t->barrier);
+    item.thing1 = w->id;
+    for (s=0; s<t->per_producer; s++)
+        {
+            item.thing2 = (int) s;
+            while(t->kind->put(&item) != 0) sched_yield(); /* full, let a dispatcher run */
+        }
+    return NULL;
+}
+
+/*-----------------------------------------------------------------------------*/
+
+/* A dispatcher: take items until they have all been taken, by this one or the others */
+static void *dispatch(void *arg)
+{
+    struct worker *w = (struct worker *) arg;
+    struct test   *t = w->test;
+    int           *last;
+    queue_item     item;
+    int64_t        sum = 0;
+    long           n_out_of_order = 0;
+
+    last = (int *) malloc((size_t) t->n_producers * sizeof(int));
+    if(last == NULL) error_exit("out of memory");
+    memset(last, 0xff, (size_t) t->n_producers * sizeof(int)); /* -1, nothing seen yet */
+
+    (void) pthread_barrier_wait(&t->barrier);
+    while(__atomic_load_n(&t->n_taken, __ATOMIC_RELAXED) < t->n_total)
+        {
+            if(t->kind->get(&item) != 0)
+                {
+                    sched_yield(); /* empty, let a producer run */
+                    continue;
+                }
+            __atomic_add_fetch(&t->n_taken, 1, __ATOMIC_RELAXED);
+            sum += item.thing2;
+            if(item.thing2 <= last[item.thing1]) n_out_of_order++;
+            last[item.thing1] = item.thing2;
+        }
+
+    __atomic_add_fetch(&t->sum, sum, __ATOMIC_RELAXED);
+    if(t->n_consumers == 1) t->n_out_of_order = n_out_of_order; /* with more, each sees only some of the items */
+    free(last);
+    return NULL;
+}
+
+/*-----------------------------------------------------------------------------*/
+
+/* insert an item into the queue, as in circular_queue_example_04.c */
+static int add_list_item(queue_item input_value)
+{
+    if (n_items < MAX_LENGTH)
+        {
+            queue_store[next_sub].thing1 = input_value.thing1;
+            queue_store[next_sub].thing2 = input_value.thing2;
+
+            next_sub = (next_sub+1) % MAX_LENGTH ; /* increment the next_sub subscript*/
+            n_items++ ;
+            return 0 ; /* normal completion */
+        }
+    else
+        return 1 ; /* return an error code, the queue is full*/
+}
+
+/*-----------------------------------------------------------------------------*/
+
+/* dispatch an item from the queue on an FIFO basis, as in circular_queue_example_04.c */
+static int dispatch_list_item(queue_item *output_value)
+{
+    int sub;
+    if (n_items > 0 )
+        {
+            sub = (next_sub+(MAX_LENGTH-n_items))%MAX_LENGTH ;
+            (*output_value).thing1 = queue_store[sub].thing1;
+            (*output_value).thing2 = queue_store[sub].thing2;
+
+            n_items-- ;
+            return 0 ; /* normal completion */
+        }
+    else
+        return 1 ; /* return an error code, the queue is empty*/
+}
+
+/*-----------------------------------------------------------------------------*/
+
+static int locked_put(const queue_item *item)
+{
+    int error_code;
+
+    pthread_mutex_lock(&queue_lock);
+    error_code = add_list_item(*item);
+    pthread_mutex_unlock(&queue_lock);
+    return error_code;
+}
+
+/*-----------------------------------------------------------------------------*/
+
+static int locked_get(queue_item *item)
+{
+    int error_code;
+
+    pthread_mutex_lock(&queue_lock);
+    error_code = dispatch_list_item(item);
+    pthread_mutex_unlock(&queue_lock);
+    return error_code;
+}
+
+/*-----------------------------------------------------------------------------*/
+
+static int mpmc_put_item(const queue_item *item)
+{
+    return mpmc_put(&mpmc, item);
+}
+
+/*-----------------------------------------------------------------------------*/
+
+static int mpmc_get_item(queue_item *item)
+{
+    return mpmc_get(&mpmc, item);
+}
+
+/*-----------------------------------------------------------------------------*/
+
+static int64_t timespecDiff(struct timespec *timeA_p, struct timespec *timeB_p)
+{
+    return (int64_t) ((timeA_p->tv_sec * 1000000000) + timeA_p->tv_nsec) -
+           ((timeB_p->tv_sec * 1000000000) + timeB_p->tv_nsec);
+}
+
+/*-----------------------------------------------------------------------------*/
+
+/* A standard formatter for printing eror messages, and exiting */
+static void error_exit(char *s)
+{
+    fprintf(stderr, "\nerror: %s - bye!\n",s);
+    exit(1);
+}
@@ -0,0 +1,100 @@
+/* mpmc_queue.c */
+
+/* A bounded lock-free queue, for many producers and many consumers, see mpmc_queue.h */
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>    /* defines some types, including: intptr_t */
+
+#include "mpmc_queue.h"
+
+/* the sequence number of a cell, and its item */
+#define SEQUENCE(q, pos) ((size_t *) ((q)->cells + ((pos) & (q)->mask) * (q)->cell_size))
+#define ITEM(q, pos)     ((q)->cells + ((pos) & (q)->mask) * (q)->cell_size + sizeof(size_t))
+
+/*-----------------------------------------------------------------------------*/
+
+int mpmc_init(struct mpmc_queue *q, size_t element_size, size_t capacity)
+{
+    size_t c = 2;
+    size_t i;
+
+    memset(q, 0, sizeof(*q));
+    while(c < capacity) c <<= 1; /* round up to a power of two, so that the index is a mask */
+
+    q->element_size = element_size;
+    q->cell_size    = (sizeof(size_t) + element_size + 7) & ~(size_t) 7; /* keep the sequence numbers aligned */
+    q->mask         = c - 1;
+    q->cells        = (unsigned char *) calloc(c, q->cell_size);
+    if(q->cells == NULL) return 1;
+
+    for (i=0; i<c; i++) *SEQUENCE(q, i) = i; /* every cell empty, and waiting for its first lap */
+    return 0;
+}
+
+/*-----------------------------------------------------------------------------*/
+
+void mpmc_free(struct mpmc_queue *q)
+{
+    free(q->cells);
+    q->cells = NULL;
+}
+
+/*-----------------------------------------------------------------------------*/
+
+int mpmc_put(struct mpmc_queue *q, const void *item)
+{
+    size_t   pos = __atomic_load_n(&q->enqueue_pos, __ATOMIC_RELAXED);
+    size_t   sequence;
+    intptr_t dif;
+
+    while(1)
+        {
+            sequence = __atomic_load_n(SEQUENCE(q, pos), __ATOMIC_ACQUIRE);
+            dif      = (intptr_t) sequence - (intptr_t) pos;
+            if(dif == 0)
+                {
+                    /* the cell is empty, on this lap: claim it, unless another producer got there first */
+                    if(__atomic_compare_exchange_n(&q->enqueue_pos, &pos, pos + 1, 1, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+                        break;
+                    /* pos now holds the latest enqueue_pos, so try again from there */
+                }
+            else if(dif < 0)
+                return 1; /* the cell still holds the item from the last lap, the queue is full */
+            else
+                pos = __atomic_load_n(&q->enqueue_pos, __ATOMIC_RELAXED); /* someone else took it, move on */
+        }
+
+    memcpy(ITEM(q, pos), item, q->element_size);
+    __atomic_store_n(SEQUENCE(q, pos), pos + 1, __ATOMIC_RELEASE); /* publish the item */
+    return 0;
+}
+
+/*-----------------------------------------------------------------------------*/
+
+int mpmc_get(struct mpmc_queue *q, void *item)
+{
+    size_t   pos = __atomic_load_n(&q->dequeue_pos, __ATOMIC_RELAXED);
+    size_t   sequence;
+    intptr_t dif;
+
+    while(1)
+        {
+            sequence = __atomic_load_n(SEQUENCE(q, pos), __ATOMIC_ACQUIRE);
+            dif      = (intptr_t) sequence - (intptr_t) (pos + 1);
+            if(dif == 0)
+                {
+                    if(__atomic_compare_exchange_n(&q->dequeue_pos, &pos, pos + 1, 1, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+                        break;
+                }
+            else if(dif < 0)
+                return 1; /* not filled yet, the queue is empty */
+            else
+                pos = __atomic_load_n(&q->dequeue_pos, __ATOMIC_RELAXED);
+        }
+
+    memcpy(item, ITEM(q, pos), q->element_size);
+    __atomic_store_n(SEQUENCE(q, pos), pos + q->mask + 1, __ATOMIC_RELEASE); /* empty, for the next lap */
+    return 0;
+}
+/*-----------------------------------------------------------------------------*/
@@ -0,0 +1,50 @@
+/* mpmc_queue.h */
+
+/* A bounded lock-free queue, for any number of producer threads and consumer threads.
+
+   The global queue_store[] of circular_queue_example_04.c is safe for one thread only.
+   Several periodic samplers feeding one dispatcher would need a lock round add_list_item()
+   and dispatch_list_item(), and every sampler would queue up behind it.
+
+   This is D. Vyukov's bounded MPMC queue. Each slot has a sequence number, beside its item,
+   which says whose turn it is:
+
+   sequence == pos        the slot is empty, and the producer that claims position pos may fill it,
+   sequence == pos + 1    the slot is full, and the consumer that claims position pos may empty it,
+                          after which it sets sequence to pos + capacity, ready for the next lap.
+
+   A producer claims a position by a compare-and-swap on enqueue_pos, and a consumer on dequeue_pos,
+   so producers only contend with producers, and consumers with consumers, and each on its own
+   cache line. The item is copied outside of any compare-and-swap, and published by a release store
+   of the sequence number, so no thread ever waits for another to finish its copy, except
+   a consumer that reaches that very slot before its producer has finished filling it, which sees it empty. */
+
+#ifndef MPMC_QUEUE_H
+#define MPMC_QUEUE_H
+
+#include <stddef.h>    /* needed for size_t */
+
+#define MPMC_CACHE_LINE 64
+
+struct mpmc_queue
+{
+    /* set by mpmc_init(), and only read after that */
+    unsigned char *cells;         /* capacity cells, each a sequence number and then an item */
+    size_t         cell_size;     /* sizeof(size_t) + element_size, rounded up to a multiple of 8 */
+    size_t         element_size;
+    size_t         mask;          /* capacity - 1, capacity is a power of two */
+
+    size_t         enqueue_pos __attribute__((aligned(MPMC_CACHE_LINE)));
+    size_t         dequeue_pos __attribute__((aligned(MPMC_CACHE_LINE)));
+    char           pad[MPMC_CACHE_LINE - sizeof(size_t)];  /* nothing else on dequeue_pos's line */
+};
+
+/* allocate the cells, for at least capacity items, at least 2, returns 0 on success, 1 if out of memory */
+int  mpmc_init(struct mpmc_queue *q, size_t element_size, size_t capacity);
+void mpmc_free(struct mpmc_queue *q);
+
+/* one item, from any thread, returns 0, or 1 if the queue is full, or empty */
+int  mpmc_put(struct mpmc_queue *q, const void *item);
+int  mpmc_get(struct mpmc_queue *q, void *item);
+
+#endif /* MPMC_QUEUE_H */
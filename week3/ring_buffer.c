@@ -0,0 +1,126 @@
+/* ring_buffer.c */
+
+/* One circular queue, for any kind of item, see ring_buffer.h */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "ring_buffer.h"
+
+/*-----------------------------------------------------------------------------*/
+
+int rb_init(struct ring_buffer *rb, size_t element_size, size_t capacity)
+{
+    size_t c = 1;
+
+    memset(rb, 0, sizeof(*rb));
+    while(c < capacity) c <<= 1; /* round up to a power of two */
+
+    rb->store = (unsigned char *) malloc(c * element_size);
+    if(rb->store == NULL) return 1;
+
+    rb->element_size = element_size;
+    rb->capacity     = c;
+    rb->mask         = c - 1;
+    return 0;
+}
+
+/*-----------------------------------------------------------------------------*/
+
+void rb_free(struct ring_buffer *rb)
+{
+    free(rb->store);
+    rb->store = NULL;
+}
+
+/*-----------------------------------------------------------------------------*/
+
+int rb_peek(const struct ring_buffer *rb, size_t k, void *item)
+{
+    if(k >= rb->head - rb->tail) return 1;
+    memcpy(item, rb->store + ((rb->tail + k) & rb->mask) * rb->element_size, rb->element_size);
+    return 0;
+}
+
+/*-----------------------------------------------------------------------------*/
+
+void rb_set_overwrite(struct ring_buffer *rb, int overwrite)
+{
+    rb->overwrite = overwrite;
+}
+
+/*-----------------------------------------------------------------------------*/
+
+size_t rb_snapshot(const struct ring_buffer *rb, void *items, size_t n)
+{
+    size_t count = rb->head - rb->tail;
+    size_t from, at, first;
+
+    if(n > count) n = count;
+    from  = rb->head - n;          /* the oldest of the latest n */
+    at    = from & rb->mask;
+    first = rb->capacity - at;
+    if(first > n) first = n;
+
+    memcpy(items, rb->store + at * rb->element_size, first * rb->element_size);
+    memcpy((unsigned char *) items + first * rb->element_size, rb->store, (n - first) * rb->element_size);
+    return n;
+}
+
+/*-----------------------------------------------------------------------------*/
+
+size_t rb_put_bulk(struct ring_buffer *rb, const void *items, size_t n)
+{
+    size_t space = rb->capacity - (rb->head - rb->tail);
+    size_t n_put = n;
+    size_t at, first, skip;
+
+    if(n > space)
+        {
+            if(!rb->overwrite)
+                n = n_put = space;
+            else
+                {
+                    /* a flight recorder: items that would be overwritten in the same call are never copied */
+                    if(n > rb->capacity)
+                        {
+                            skip   = n - rb->capacity;
+                            items  = (const unsigned char *) items + skip * rb->element_size;
+                            n      = rb->capacity;
+                            rb->n_overwritten += (long) skip;
+                        }
+                    if(n > space)
+                        {
+                            rb->tail += n - space; /* drop the oldest, to make room */
+                            rb->n_overwritten += (long) (n - space);
+                        }
+                }
+        }
+    at    = rb->head & rb->mask;
+    first = rb->capacity - at; /* the items that fit before the end of the store */
+    if(first > n) first = n;
+
+    memcpy(rb->store + at * rb->element_size, items, first * rb->element_size);
+    memcpy(rb->store, (const unsigned char *) items + first * rb->element_size, (n - first) * rb->element_size);
+    rb->head += n;
+    return n_put;
+}
+
+/*-----------------------------------------------------------------------------*/
+
+size_t rb_get_bulk(struct ring_buffer *rb, void *items, size_t n)
+{
+    size_t count = rb->head - rb->tail;
+    size_t at    = rb->tail & rb->mask;
+    size_t first;
+
+    if(n > count) n = count;
+    first = rb->capacity - at;
+    if(first > n) first = n;
+
+    memcpy(items, rb->store + at * rb->element_size, first * rb->element_size);
+    memcpy((unsigned char *) items + first * rb->element_size, rb->store, (n - first) * rb->element_size);
+    rb->tail += n;
+    return n;
+}
+/*-----------------------------------------------------------------------------*/
@@ -0,0 +1,134 @@
+/* ring_buffer.h */
+
+/* One circular queue, for any kind of item.
+
+   circular_queue_example_04.c, in week1, week2 and week3, and the sample_time_stamp programs,
+   each have their own copy of the same queue, for their own queue_item, with a fixed MAX_LENGTH,
+   and a % MAX_LENGTH in every add_list_item() and dispatch_list_item().
+   Here the size of an item, and the capacity, are set when the queue is created, and the capacity
+   is rounded up to a power of two, so that a subscript is found by a mask, & (capacity-1),
+   rather than by a division.
+
+   head and tail count every item ever added and removed, and are never wrapped themselves,
+   so head - tail is the number of items in the queue, with no n_items to keep in step,
+   and the queue can be filled to its last slot.
+
+   rb_put() and rb_get() copy element_size bytes, a size known only at run time, which is a call
+   to memcpy() for every item. RB_PUT() and RB_GET() take the size from the type of the item instead,
+   so that the copy is inlined, and are the ones to use when that type is the queue's own.
+
+   rb_put_bulk() and rb_get_bulk() move many items at once, as one memcpy() of the run up to
+   the end of the store, and a second one, if the run wraps round to the start.
+
+   In flight-recorder mode, set by rb_set_overwrite(), a full queue does not refuse the next item:
+   the oldest is dropped to make room for it, and counted, so that a sampler can run for ever in a fixed
+   amount of memory, and the queue always holds the latest capacity items. rb_snapshot() copies out
+   the latest n of them, on demand, without removing them.
+
+   A ring buffer is for one thread, as the queues it replaces are. See spsc_queue.h for a queue
+   between two threads. */
+
+#ifndef RING_BUFFER_H
+#define RING_BUFFER_H
+
+#include <stddef.h>    /* needed for size_t */
+#include <string.h>    /* needed for memcpy() */
+
+struct ring_buffer
+{
+    unsigned char *store;         /* capacity items, of element_size bytes each */
+    size_t         element_size;
+    size_t         capacity;      /* a power of two */
+    size_t         mask;          /* capacity - 1 */
+    size_t         head;          /* the number of items ever added, the next goes at head & mask */
+    size_t         tail;          /* the number of items ever removed, the next comes from tail & mask */
+    int            overwrite;     /* 1 in flight-recorder mode, when a full queue drops its oldest item */
+    long           n_overwritten; /* the items dropped that way */
+};
+
+/* allocate the store, for at least capacity items, returns 0 on success, 1 if out of memory */
+int    rb_init(struct ring_buffer *rb, size_t element_size, size_t capacity);
+void   rb_free(struct ring_buffer *rb);
+
+
+/* the k-th oldest item, without removing it, returns 0, or 1 if there are not that many */
+int    rb_peek(const struct ring_buffer *rb, size_t k, void *item);
+
+/* 1 for flight-recorder mode, in which rb_put() overwrites the oldest item when the queue is full,
+   0 for a queue that refuses, the default */
+void   rb_set_overwrite(struct ring_buffer *rb, int overwrite);
+
+/* copy the latest n items, or as many as there are, oldest first, without removing them,
+   returns the number copied */
+size_t rb_snapshot(const struct ring_buffer *rb, void *items, size_t n);
+
+/* up to n items, as many as there are room for, or as there are, returns the number moved.
+   In flight-recorder mode rb_put_bulk() takes all n, and drops as many of the oldest as it must */
+size_t rb_put_bulk(struct ring_buffer *rb, const void *items, size_t n);
+size_t rb_get_bulk(struct ring_buffer *rb, void *items, size_t n);
+
+/* make room for one more item, returns 1, or 0 if the queue is full.
+   In flight-recorder mode there is always room: the oldest item is dropped, if it must be */
+static inline int rb_make_room(struct ring_buffer *rb)
+{
+    if(rb->head - rb->tail == rb->capacity)
+        {
+            if(!rb->overwrite) return 0; /* full */
+            rb->tail++;                  /* a flight recorder: drop the oldest, whose slot is the one to fill */
+            rb->n_overwritten++;
+        }
+    return 1;
+}
+
+/* one item, returns 0 on success, or 1 if the queue is full, or empty.
+   These are in the header, so that they can be inlined, as the workshop queues are,
+   but the size is only known at run time, so every item costs a call to memcpy() */
+static inline int rb_put(struct ring_buffer *rb, const void *item)
+{
+    if(!rb_make_room(rb)) return 1;
+    memcpy(rb->store + (rb->head & rb->mask) * rb->element_size, item, rb->element_size);
+    rb->head++;
+    return 0;
+}
+
+static inline int rb_get(struct ring_buffer *rb, void *item)
+{
+    if(rb->head == rb->tail) return 1; /* empty */
+    memcpy(item, rb->store + (rb->tail & rb->mask) * rb->element_size, rb->element_size);
+    rb->tail++;
+    return 0;
+}
+
+/* The same, for a pointer to a (non-const) item of the type that the queue holds, as it usually is.
+   The store is indexed as an array of that type, and the item copied by an assignment: the compiler
+   knows the size, so the copy is a load and a store, and knows that the store cannot alias head
+   and tail, so it can keep them in registers, where a memcpy() into the store of bytes would make
+   it read them again after every item. */
+#define RB_PUT(rb, item)                                                                    \
+    ({                                                                                      \
+        struct ring_buffer *rb_ = (rb);                                                     \
+        int rb_room_ = rb_make_room(rb_);                                                   \
+        if(rb_room_) ((__typeof__(*(item)) *) rb_->store)[rb_->head++ & rb_->mask] = *(item); \
+        !rb_room_;                                                                          \
+    })
+
+#define RB_GET(rb, item)                                                                    \
+    ({                                                                                      \
+        struct ring_buffer *rb_ = (rb);                                                     \
+        int rb_empty_ = (rb_->head == rb_->tail);                                           \
+        if(!rb_empty_) *(item) = ((__typeof__(*(item)) *) rb_->store)[rb_->tail++ & rb_->mask]; \
+        rb_empty_;                                                                          \
+    })
+
+/* the number of items in the queue, and the room left */
+static inline size_t rb_count(const struct ring_buffer *rb)
+{
+    return rb->head - rb->tail;
+}
+
+static inline size_t rb_space(const struct ring_buffer *rb)
+{
+    return rb->capacity - (rb->head - rb->tail);
+}
+
+#endif /* RING_BUFFER_H */
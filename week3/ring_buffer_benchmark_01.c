@@ -0,0 +1,312 @@
+/* ring_buffer_benchmark_01.c */
+
+/* How much does a power-of-two capacity, and moving items in bulk, save?
+
+   The same traffic, BATCH items in and then BATCH items out, over and over, is passed through:
+
+   1. add_list_item() and dispatch_list_item(), as in circular_queue_example_04.c, with a
+      MAX_LENGTH of 1000, which is not a power of two, so each % is a division,
+   2. the same queue, but for any item size, with the capacity set at run time, and still %,
+   3. rb_put() and rb_get(), one item at a time, with a mask (see ring_buffer.c),
+   4. RB_PUT() and RB_GET(), the same, with the size of the item known when it is compiled,
+   5. rb_put_bulk() and rb_get_bulk(), BATCH items at a time, one or two memcpy()s each way.
+
+   The time per item is printed for each, along with a checksum of the items that came out,
+   which must be the same for all five.
+
+   The difference between 2 and 3 is the division. Most of the cost of both, and the reason that
+   they are slower than 1, is a call to memcpy() for every item, of a size known only at run time.
+   4 inlines that copy, as 1 does, and keeps the mask. 5 makes one call for a whole batch.
+
+   Compilation advice:
+
+   gcc -std=gnu99 -Wall -Wextra -Werror -O2 -o ring_buffer_benchmark_01 ring_buffer_benchmark_01.c ring_buffer.c
+
+   An execution suggestion:
+
+   ./ring_buffer_benchmark_01
+   ./ring_buffer_benchmark_01 100000000
+
+   The optional parameter is the number of items to pass through each queue.
+
+   Times are in nanoseconds.
+*/
+
+#include <stdio.h>     /* needed for printf() */
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>    /* defines some types, including: int64_t */
+#include <time.h>      /* needed for clock_gettime() and CLOCK_MONOTONIC */
+
+#include "ring_buffer.h"
+
+#define N_ITEMS    20000000  /* the default number of items through each queue */
+#define BATCH            64  /* items in, then out, in each round */
+#define MAX_LENGTH     1000  /* the workshop queue, "You may want to increase MAX_LENGTH, quite a lot..." */
+#define CAPACITY       1000  /* the others, rounded up to 1024 by rb_init() */
+
+/* Set up structures for the starting and stopping times */
+static struct timespec start, end;
+
+/* The items, as in circular_queue_example_04.c */
+typedef struct
+{
+    int thing1;
+    int thing2;
+} queue_item;
+
+/* the workshop queue, global, as it is there */
+static queue_item queue_store[MAX_LENGTH];
+static int next_sub = 0;
+static int n_items  = 0;
+
+/* a queue for any item size, with the capacity set at run time, but still using % */
+struct modulo_queue
+{
+    unsigned char *store;
+    size_t         element_size;
+    size_t         capacity;
+    size_t         next_sub;
+    size_t         n_items;
+};
+
+/* function templates */
+static int64_t timespecDiff(struct timespec *timeA_p, struct timespec *timeB_p);
+static int64_t elapsed_time(void);
+static int     add_list_item(queue_item input_value);
+static int     dispatch_list_item(queue_item *output_value);
+static int     mq_init(struct modulo_queue *q, size_t element_size, size_t capacity) __attribute__((noinline));
+static int     mq_put(struct modulo_queue *q, const void *item);
+static int     mq_get(struct modulo_queue *q, void *item);
+static void    report(const char *name, int64_t ns, long n, long checksum);
+static void    error_exit(char *s);
+
+int main(int argc, char *argv[])
+{
+    static queue_item   batch[BATCH];
+    struct modulo_queue mq;
+    struct ring_buffer  rb;
+    queue_item item;
+    long       n = N_ITEMS;
+    long       rounds;
+    long       checksum;
+    long       r;
+    int        k;
+
+    if(argc > 1) n = atol(argv[1]);
+    rounds = n / BATCH;
+    n      = rounds * BATCH;
+
+    if((mq_init(&mq, sizeof(queue_item), CAPACITY) != 0) || (rb_init(&rb, sizeof(queue_item), CAPACITY) != 0))
+        error_exit("out of memory");
+
+    printf("%ld items of %d bytes, %d at a time, through each queue\n", n, (int) sizeof(queue_item), BATCH);
+    printf("%-40s %10s %16s\n", "", "ns/item", "checksum");
+
+    /* 1. the workshop queue */
+    checksum = 0;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (r=0; r<rounds; r++)
+        {
+            for (k=0; k<BATCH; k++)
+                {
+                    item.thing1 = (int) r;
+                    item.thing2 = k;
+                    (void) add_list_item(item);
+                }
+            for (k=0; k<BATCH; k++)
+                {
+                    (void) dispatch_list_item(&item);
+                    checksum += item.thing1 + item.thing2;
+                }
+        }
+    report("add_list_item(), % MAX_LENGTH", elapsed_time(), n, checksum);
+
+    /* 2. any item size, % capacity */
+    checksum = 0;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (r=0; r<rounds; r++)
+        {
+            for (k=0; k<BATCH; k++)
+                {
+                    item.thing1 = (int) r;
+                    item.thing2 = k;
+                    (void) mq_put(&mq, &item);
+                }
+            for (k=0; k<BATCH; k++)
+                {
+                    (void) mq_get(&mq, &item);
+                    checksum += item.thing1 + item.thing2;
+                }
+        }
+    report("any size, % capacity", elapsed_time(), n, checksum);
+
+    /* 3. any item size, & mask */
+    checksum = 0;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (r=0; r<rounds; r++)
+        {
+            for (k=0; k<BATCH; k++)
+                {
+                    item.thing1 = (int) r;
+                    item.thing2 = k;
+                    (void) rb_put(&rb, &item);
+                }
+            for (k=0; k<BATCH; k++)
+                {
+                    (void) rb_get(&rb, &item);
+                    checksum += item.thing1 + item.thing2;
+                }
+        }
+    report("rb_put(), rb_get(), & mask", elapsed_time(), n, checksum);
+
+    /* 4. & mask, with the size known. The item is a fresh one, whose address is never given to
+          a function, as 2 and 3 give theirs to memcpy(), so that it can stay in registers, as the
+          value passed to add_list_item() does */
+    checksum = 0;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (r=0; r<rounds; r++)
+        {
+            queue_item local;
+
+            for (k=0; k<BATCH; k++)
+                {
+                    local.thing1 = (int) r;
+                    local.thing2 = k;
+                    (void) RB_PUT(&rb, &local);
+                }
+            for (k=0; k<BATCH; k++)
+                {
+                    (void) RB_GET(&rb, &local);
+                    checksum += local.thing1 + local.thing2;
+                }
+        }
+    report("RB_PUT(), RB_GET(), & mask", elapsed_time(), n, checksum);
+
+    /* 5. in bulk */
+    checksum = 0;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (r=0; r<rounds; r++)
+        {
+            for (k=0; k<BATCH; k++)
+                {
+                    batch[k].thing1 = (int) r;
+                    batch[k].thing2 = k;
+                }
+            (void) rb_put_bulk(&rb, batch, BATCH);
+            (void) rb_get_bulk(&rb, batch, BATCH);
+            for (k=0; k<BATCH; k++) checksum += batch[k].thing1 + batch[k].thing2;
+        }
+    report("rb_put_bulk(), rb_get_bulk()", elapsed_time(), n, checksum);
+
+    free(mq.store);
+    rb_free(&rb);
+    return 0;
+}
+
+/*-----------------------------------------------------------------------------*/
+
+static int64_t timespecDiff(struct timespec *timeA_p, struct timespec *timeB_p)
+{
+    return (int64_t) ((timeA_p->tv_sec * 1000000000) + timeA_p->tv_nsec) -
+           ((timeB_p->tv_sec * 1000000000) + timeB_p->tv_nsec);
+}
+
+/*-----------------------------------------------------------------------------*/
+
+static int64_t elapsed_time(void)
+{
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    return (int64_t) timespecDiff(&end, &start);
+}
+
+/*-----------------------------------------------------------------------------*/
+
+/* insert an item into the queue, as in circular_queue_example_04.c */
+static int add_list_item(queue_item input_value)
+{
+    if (n_items < MAX_LENGTH)
+        {
+            queue_store[next_sub].thing1 = input_value.thing1;
+            queue_store[next_sub].thing2 = input_value.thing2;
+
+            next_sub = (next_sub+1) % MAX_LENGTH ; /* increment the next_sub subscript*/
+            n_items++ ;
+            return 0 ; /* normal completion */
+        }
+    else
+        return 1 ; /* return an error code, the queue is full*/
+}
+
+/*-----------------------------------------------------------------------------*/
+
+/* dispatch an item from the queue on an FIFO basis, as in circular_queue_example_04.c */
+static int dispatch_list_item(queue_item *output_value)
+{
+    int sub;
+    if (n_items > 0 )
+        {
+            sub = (next_sub+(MAX_LENGTH-n_items))%MAX_LENGTH ;
+            (*output_value).thing1 = queue_store[sub].thing1;
+            (*output_value).thing2 = queue_store[sub].thing2;
+
+            n_items-- ;
+            return 0 ; /* normal completion */
+        }
+    else
+        return 1 ; /* return an error code, the queue is empty*/
+}
+
+/*-----------------------------------------------------------------------------*/
+
+/* Set up the % queue the same way that rb_init() sets up the ring buffer, out of line,
+   so that the compiler cannot keep one queue in registers and not the other */
+static int mq_init(struct modulo_queue *q, size_t element_size, size_t capacity)
+{
+    q->element_size = element_size;
+    q->capacity     = capacity;
+    q->next_sub     = 0;
+    q->n_items      = 0;
+    q->store        = (unsigned char *) malloc(capacity * element_size);
+    return q->store == NULL;
+}
+
+/*-----------------------------------------------------------------------------*/
+
+static int mq_put(struct modulo_queue *q, const void *item)
+{
+    if(q->n_items == q->capacity) return 1;
+    memcpy(q->store + q->next_sub * q->element_size, item, q->element_size);
+    q->next_sub = (q->next_sub + 1) % q->capacity;
+    q->n_items++;
+    return 0;
+}
+
+/*-----------------------------------------------------------------------------*/
+
+static int mq_get(struct modulo_queue *q, void *item)
+{
+    size_t sub;
+
+    if(q->n_items == 0) return 1;
+    sub = (q->next_sub + (q->capacity - q->n_items)) % q->capacity;
+    memcpy(item, q->store + sub * q->element_size, q->element_size);
+    q->n_items--;
+    return 0;
+}
+
+/*-----------------------------------------------------------------------------*/
+
+static void report(const char *name, int64_t ns, long n, long checksum)
+{
+    printf("%-40s %10.2f %16ld\n", name, (double) ns / (double) n, checksum);
+}
+
+/*-----------------------------------------------------------------------------*/
+
+/* A standard formatter for printing eror messages, and exiting */
+static void error_exit(char *s)
+{
+    fprintf(stderr, "\nerror: %s - bye!\n",s);
+    exit(1);
+}
@@ -0,0 +1,245 @@
+/* sample_log.c */
+
+/* A sample log in a memory-mapped file, that survives a crash of its writer, see sample_log.h */
+
+#include <stdio.h>
+#include <string.h>
+#include <fcntl.h>     /* needed for open() */
+#include <unistd.h>    /* needed for ftruncate(), pread() and close() */
+#include <sys/mman.h>  /* needed for mmap() and msync() */
+#include <sys/stat.h>  /* needed for fstat() */
+
+#include "sample_log.h"
+
+#define HEADER_BYTES 4096        /* the header has a page to itself, on any machine that reads the file */
+#define NO_INDEX     UINT64_MAX  /* in a record that is being written */
+
+/* function templates, for local helpers */
+static int check_header(const struct sample_log_header *h, const char *path);
+static int map_log(struct sample_log *sl, int fd, uint64_t capacity, int writable, const char *path);
+
+/*-----------------------------------------------------------------------------*/
+
+int sl_open(struct sample_log *sl, const char *path, size_t capacity)
+{
+    struct sample_log_header h;
+    struct stat st;
+    uint64_t    c = 1;
+    int         fd;
+
+    memset(sl, 0, sizeof(*sl));
+    fd = open(path, O_RDWR | O_CREAT, 0644);
+    if((fd < 0) || (fstat(fd, &st) != 0))
+        {
+            perror("sl_open(): open()");
+            if(fd >= 0) close(fd);
+            return 1;
+        }
+
+    if(st.st_size == 0)
+        {
+            /* a new log */
+            while(c < capacity) c <<= 1; /* round up to a power of two, so that the index is a mask */
+            if(ftruncate(fd, (off_t) (HEADER_BYTES + c * sizeof(struct sample_log_record))) != 0)
+                {
+                    perror("sl_open(): ftruncate()");
+                    close(fd);
+                    return 1;
+                }
+            if(map_log(sl, fd, c, 1, path) != 0) return 1;
+
+            /* the file is all zeros, so no record yet has a valid index, but record 0.
+               It is not committed until the write index passes it. The magic goes in last,
+               so that a log left half made is refused, rather than trusted */
+            sl->header->version     = SL_VERSION;
+            sl->header->record_size = sizeof(struct sample_log_record);
+            sl->header->capacity    = c;
+            __atomic_thread_fence(__ATOMIC_RELEASE);
+            memcpy(sl->header->magic, SL_MAGIC, sizeof(SL_MAGIC));
+        }
+    else
+        {
+            /* an old log, carried on from where it was left */
+            if(pread(fd, &h, sizeof(h), 0) != (ssize_t) sizeof(h))
+                {
+                    fprintf(stderr, "sl_open(): %s is too short to be a sample log\n", path);
+                    close(fd);
+                    return 1;
+                }
+            if(check_header(&h, path) != 0)
+                {
+                    close(fd);
+                    return 1;
+                }
+            if((uint64_t) st.st_size < HEADER_BYTES + h.capacity * sizeof(struct sample_log_record))
+                {
+                    fprintf(stderr, "sl_open(): %s is cut short\n", path);
+                    close(fd);
+                    return 1;
+                }
+            if(map_log(sl, fd, h.capacity, 1, path) != 0) return 1;
+        }
+
+    sl->header->sequence++; /* a new run */
+    return 0;
+}
+
+/*-----------------------------------------------------------------------------*/
+
+int sl_open_read(struct sample_log *sl, const char *path)
+{
+    struct sample_log_header h;
+    struct stat st;
+    int         fd;
+
+    memset(sl, 0, sizeof(*sl));
+    fd = open(path, O_RDONLY);
+    if((fd < 0) || (fstat(fd, &st) != 0))
+        {
+            perror("sl_open_read(): open()");
+            if(fd >= 0) close(fd);
+            return 1;
+        }
+    if(pread(fd, &h, sizeof(h), 0) != (ssize_t) sizeof(h))
+        {
+            fprintf(stderr, "sl_open_read(): %s is too short to be a sample log\n", path);
+            close(fd);
+            return 1;
+        }
+    if(check_header(&h, path) != 0)
+        {
+            close(fd);
+            return 1;
+        }
+    if((uint64_t) st.st_size < HEADER_BYTES + h.capacity * sizeof(struct sample_log_record))
+        {
+            fprintf(stderr, "sl_open_read(): %s is cut short\n", path);
+            close(fd);
+            return 1;
+        }
+    return map_log(sl, fd, h.capacity, 0, path);
+}
+
+/*-----------------------------------------------------------------------------*/
+
+void sl_close(struct sample_log *sl)
+{
+    if(sl->header != NULL) munmap(sl->header, sl->map_size); /* the file keeps what was written */
+    sl->header = NULL;
+    sl->record = NULL;
+}
+
+/*-----------------------------------------------------------------------------*/
+
+void sl_append(struct sample_log *sl, int64_t time_value, int32_t sample_value)
+{
+    uint64_t i = sl->header->write_index; /* only this thread writes it */
+    struct sample_log_record *r = &sl->record[i & sl->mask];
+
+    /* mark the slot unfinished, fill it in, then mark it finished, and commit it */
+    __atomic_store_n(&r->index, NO_INDEX, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    r->time_value   = time_value;
+    r->sample_value = sample_value;
+    r->sequence     = (uint32_t) sl->header->sequence;
+    __atomic_store_n(&r->index, i, __ATOMIC_RELEASE);
+    __atomic_store_n(&sl->header->write_index, i + 1, __ATOMIC_RELEASE);
+}
+
+/*-----------------------------------------------------------------------------*/
+
+uint64_t sl_write_index(const struct sample_log *sl)
+{
+    return __atomic_load_n(&sl->header->write_index, __ATOMIC_ACQUIRE);
+}
+
+/*-----------------------------------------------------------------------------*/
+
+uint64_t sl_first(const struct sample_log *sl)
+{
+    uint64_t w = sl_write_index(sl);
+
+    return (w > sl->capacity) ? w - sl->capacity : 0;
+}
+
+/*-----------------------------------------------------------------------------*/
+
+int sl_get(const struct sample_log *sl, uint64_t index, struct sample_log_record *r)
+{
+    const struct sample_log_record *slot = &sl->record[index & sl->mask];
+    uint64_t before, after;
+
+    if((index >= sl_write_index(sl)) || (index < sl_first(sl))) return 1;
+
+    /* if the writer touched the slot while it was being copied, the index will have changed */
+    before = __atomic_load_n(&slot->index, __ATOMIC_ACQUIRE);
+    *r = *slot;
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    after = __atomic_load_n(&slot->index, __ATOMIC_RELAXED);
+
+    return ((before == index) && (after == index)) ? 0 : 1;
+}
+
+/*-----------------------------------------------------------------------------*/
+
+int sl_sync(struct sample_log *sl)
+{
+    if(msync(sl->header, sl->map_size, MS_SYNC) != 0)
+        {
+            perror("sl_sync(): msync()");
+            return 1;
+        }
+    return 0;
+}
+
+/*-----------------------------------------------------------------------------*/
+
+/* is this the header of a log that this code can read? */
+static int check_header(const struct sample_log_header *h, const char *path)
+{
+    if(memcmp(h->magic, SL_MAGIC, sizeof(SL_MAGIC)) != 0)
+        {
+            fprintf(stderr, "%s is not a sample log\n", path);
+            return 1;
+        }
+    if((h->version != SL_VERSION) || (h->record_size != sizeof(struct sample_log_record)))
+        {
+            fprintf(stderr, "%s is a sample log of version %u, with %u-byte records, this is version %d, with %d-byte records\n",
+                    path, h->version, h->record_size, SL_VERSION, (int) sizeof(struct sample_log_record));
+            return 1;
+        }
+    if((h->capacity == 0) || ((h->capacity & (h->capacity - 1)) != 0))
+        {
+            fprintf(stderr, "%s has a capacity of %lu, which is not a power of two\n", path, (unsigned long) h->capacity);
+            return 1;
+        }
+    return 0;
+}
+
+/*-----------------------------------------------------------------------------*/
+
+/* map the header, and the records, and close the file, the mapping keeps it open */
+static int map_log(struct sample_log *sl, int fd, uint64_t capacity, int writable, const char *path)
+{
+    size_t map_size = HEADER_BYTES + (size_t) capacity * sizeof(struct sample_log_record);
+    void  *base;
+
+    /* for the writer, fault every page in now, so that the first appends to each do not wait for it */
+    base = mmap(NULL, map_size, writable ? (PROT_READ | PROT_WRITE) : PROT_READ,
+                writable ? (MAP_SHARED | MAP_POPULATE) : MAP_SHARED, fd, 0);
+    close(fd);
+    if(base == MAP_FAILED)
+        {
+            fprintf(stderr, "map_log(): mmap() of %s failed\n", path);
+            return 1;
+        }
+
+    sl->header   = (struct sample_log_header *) base;
+    sl->record   = (struct sample_log_record *) ((unsigned char *) base + HEADER_BYTES);
+    sl->capacity = capacity;
+    sl->mask     = capacity - 1;
+    sl->map_size = map_size;
+    sl->writable = writable;
+    return 0;
+}
+/*-----------------------------------------------------------------------------*/
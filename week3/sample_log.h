@@ -0,0 +1,93 @@
+/* sample_log.h */
+
+/* A sample log, in a file, that outlives the process that writes it.
+
+   The samples of the workshop sampler live in queue_store[], in the memory of the process,
+   until print_list_items(), at the end, so if the process dies first, from a signal, an abort(),
+   or a bug, every sample it took is lost with it.
+
+   Here the samples go into a ring of records in a file, mapped into memory with mmap(MAP_SHARED).
+   The first page of the file is a header: a magic string, the format version, the size of a record,
+   the capacity, the write index, the number of records ever committed, and the sequence,
+   the number of times the log has been opened for writing.
+
+   sl_append() is plain stores into the mapping, and no system call: the record is written,
+   and then the write index is advanced, with a release store, which commits it.
+   The stores are into the page cache, which belongs to the kernel, and not to the process,
+   so once a record is committed it survives the process dying, at any point, and it reaches
+   the disk in the kernel's own time. sl_sync() forces it there, for a log that must also
+   survive the machine going down, but that is a system call, and it may block.
+
+   Each record carries its own index, written last of all. A record whose index is not the one
+   expected, at its place in the ring, was never finished, or has since been overwritten,
+   and sl_get() refuses it. sl_get() checks the index before and after copying the record,
+   so it can read a log that is still being written, as well as one recovered after a crash.
+
+   When the ring is full, the oldest records are overwritten, as in the flight-recorder mode
+   of ring_buffer.h, so the log holds the latest capacity samples.
+
+   The pages are faulted in when the log is opened, but after the kernel writes a page back to
+   the disk, the next store to it takes a minor fault, so an append is not quite always free. */
+
+#ifndef SAMPLE_LOG_H
+#define SAMPLE_LOG_H
+
+#include <stddef.h>    /* needed for size_t */
+#include <stdint.h>    /* defines some types, including: int64_t */
+
+#define SL_MAGIC   "SAMPLOG"  /* 7 characters, and a '\0' */
+#define SL_VERSION 1
+
+/* The first page of the file. The layout is the format: change it, and change SL_VERSION */
+struct sample_log_header
+{
+    char     magic[8];
+    uint32_t version;
+    uint32_t record_size;  /* sizeof(struct sample_log_record) */
+    uint64_t capacity;     /* records, a power of two */
+    uint64_t sequence;     /* the number of times the log has been opened for writing */
+    uint64_t write_index;  /* records ever committed, the next goes at write_index & (capacity-1) */
+};
+
+struct sample_log_record
+{
+    uint64_t index;        /* its place in the log, written last, to mark the record complete */
+    int64_t  time_value;   /* ns, since the start of its run */
+    int32_t  sample_value;
+    uint32_t sequence;     /* the run that wrote it, see the header */
+};
+
+struct sample_log
+{
+    struct sample_log_header *header;  /* in the mapping */
+    struct sample_log_record *record;  /* capacity records, straight after the header page */
+    uint64_t                  capacity;
+    uint64_t                  mask;    /* capacity - 1 */
+    size_t                    map_size;
+    int                       writable;
+};
+
+/* Open the log at path for appending. A new file is made for at least capacity records;
+   an existing log is carried on from its write index, and its capacity is kept.
+   Returns 0 on success, or 1 with a message on stderr. */
+int      sl_open(struct sample_log *sl, const char *path, size_t capacity);
+
+/* open an existing log, read only, to recover it, returns 0 on success, or 1 with a message on stderr */
+int      sl_open_read(struct sample_log *sl, const char *path);
+
+void     sl_close(struct sample_log *sl);
+
+/* add one sample, overwriting the oldest if the log is full. No system call */
+void     sl_append(struct sample_log *sl, int64_t time_value, int32_t sample_value);
+
+/* the records committed, and the index of the oldest still held */
+uint64_t sl_write_index(const struct sample_log *sl);
+uint64_t sl_first(const struct sample_log *sl);
+
+/* copy the record with the given index, returns 0, or 1 if it is not whole, or no longer held */
+int      sl_get(const struct sample_log *sl, uint64_t index, struct sample_log_record *r);
+
+/* write the mapping back to the disk, and wait for it, returns 0, or 1 with a message on stderr */
+int      sl_sync(struct sample_log *sl);
+
+#endif /* SAMPLE_LOG_H */
@@ -0,0 +1,91 @@
+/* sample_log_recover.c */
+
+/*
+   Read back a sample log (see sample_log.c), after its writer has finished, or crashed, or while it runs.
+
+   The header is checked, its format version, record size and capacity, and printed, and then
+   every record still held is printed, oldest first, up to the last one committed. A record that
+   was overwritten, or being written, while it was read, is reported, and skipped.
+
+   Compilation advice:
+
+   gcc -std=gnu99 -Wall -Wextra -Werror -O2 -o sample_log_recover sample_log_recover.c sample_log.c
+
+   An execution suggestion:
+
+   ./sample_log_recover samples.log
+   ./sample_log_recover -n 5 samples.log
+
+   options:
+   -n last        print only the latest so many records (default 0, all of them)
+   -q             print only the header, and the counts
+
+   Times are in nanoseconds, since the start of the run that took them.
+*/
+
+#include <stdio.h>     /* needed for printf() */
+#include <stdlib.h>
+#include <stdint.h>    /* defines some types, including: int64_t */
+#include <unistd.h>    /* needed for getopt() */
+
+#include "sample_log.h"
+
+#define USAGE "Usage is: ./sample_log_recover [-n last] [-q] log_file\n"
+
+int main(int argc, char *argv[])
+{
+    struct sample_log        sl;
+    struct sample_log_record r;
+    uint64_t first, last, index;
+    long     n_last = 0;
+    long     n_good = 0, n_bad = 0;
+    int      quiet = 0;
+    int      opt;
+
+    while((opt = getopt(argc, argv, "n:q")) != -1)
+        switch(opt)
+            {
+            case 'n':
+                n_last = atol(optarg);
+                break;
+            case 'q':
+                quiet = 1;
+                break;
+            default:
+                fprintf(stderr, USAGE);
+                return EXIT_FAILURE;
+            }
+    if((n_last < 0) || (optind != argc - 1))
+        {
+            fprintf(stderr, USAGE);
+            return EXIT_FAILURE;
+        }
+
+    if(sl_open_read(&sl, argv[optind]) != 0) return EXIT_FAILURE;
+
+    last  = sl_write_index(&sl);
+    first = sl_first(&sl);
+    if((n_last > 0) && (last - first > (uint64_t) n_last)) first = last - (uint64_t) n_last;
+
+    printf("%s: version %u, %u-byte records, capacity %lu, %lu runs, %lu records committed, %lu held\n",
+           argv[optind], sl.header->version, sl.header->record_size, (unsigned long) sl.capacity,
+           (unsigned long) sl.header->sequence, (unsigned long) last, (unsigned long) (last - sl_first(&sl)));
+
+    if(!quiet) printf("The log is: (run,index,time_value,sample_value) :\n{\n");
+    for (index=first; index<last; index++)
+        {
+            if(sl_get(&sl, index, &r) != 0)
+                {
+                    n_bad++;
+                    if(!quiet) printf("   record %lu is not whole, skipped\n", (unsigned long) index);
+                    continue;
+                }
+            n_good++;
+            if(!quiet) printf("   (%u,%lu,%ld,%d)\n", r.sequence, (unsigned long) r.index, (long) r.time_value, r.sample_value);
+        }
+    if(!quiet) printf("}\n");
+    printf("%ld records recovered, %ld skipped\n", n_good, n_bad);
+
+    sl_close(&sl);
+    return (n_bad == 0) ? 0 : 1;
+}
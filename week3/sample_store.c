@@ -0,0 +1,263 @@
+/* sample_store.c */
+
+/* Samples as a structure of arrays, with vectorised statistics, see sample_store.h */
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>    /* defines some types, including: int64_t */
+#include <math.h>      /* needed for sqrt() */
+
+#include "sample_store.h"
+
+/* GCC vector extensions, 32 bytes each */
+typedef int32_t v8si __attribute__((vector_size(32)));
+typedef int32_t v4si __attribute__((vector_size(16)));
+typedef int64_t v4di __attribute__((vector_size(32)));
+typedef double  v4df __attribute__((vector_size(32)));
+
+/* running sums, about a pivot, for one window, which may be in two parts */
+struct accumulator
+{
+    size_t  n;
+    int64_t min, max;
+    double  pivot;
+    double  sum;    /* of x - pivot */
+    double  sum2;   /* of (x - pivot)^2 */
+};
+
+/* function templates, for local helpers */
+static int  window_parts(const struct sample_store *ss, size_t first, size_t n, size_t *at, size_t *n_first);
+static void add_values(struct accumulator *a, const int32_t *x, size_t n);
+static void add_intervals(struct accumulator *a, const int64_t *t, size_t n);
+static void add_one(struct accumulator *a, int64_t x);
+static void start_accumulator(struct accumulator *a, double pivot);
+
+/*-----------------------------------------------------------------------------*/
+
+int ss_init(struct sample_store *ss, size_t capacity)
+{
+    size_t c = 8;
+
+    memset(ss, 0, sizeof(*ss));
+    while(c < capacity) c <<= 1;
+
+    ss->time_value   = (int64_t *) calloc(c, sizeof(int64_t));
+    ss->sample_value = (int32_t *) calloc(c, sizeof(int32_t));
+    if((ss->time_value == NULL) || (ss->sample_value == NULL))
+        {
+            ss_free(ss);
+            return 1;
+        }
+    ss->capacity = c;
+    ss->mask     = c - 1;
+    return 0;
+}
+
+/*-----------------------------------------------------------------------------*/
+
+void ss_free(struct sample_store *ss)
+{
+    free(ss->time_value);
+    free(ss->sample_value);
+    ss->time_value   = NULL;
+    ss->sample_value = NULL;
+}
+
+/*-----------------------------------------------------------------------------*/
+
+void ss_put(struct sample_store *ss, int64_t time_value, int32_t sample_value)
+{
+    ss->time_value[ss->head & ss->mask]   = time_value;
+    ss->sample_value[ss->head & ss->mask] = sample_value;
+    ss->head++;
+}
+
+/*-----------------------------------------------------------------------------*/
+
+size_t ss_first(const struct sample_store *ss)
+{
+    return (ss->head > ss->capacity) ? ss->head - ss->capacity : 0;
+}
+
+/*-----------------------------------------------------------------------------*/
+
+int ss_value_stats(const struct sample_store *ss, size_t first, size_t n, struct ss_value_stats *stats)
+{
+    struct accumulator a;
+    size_t at, n_first;
+
+    if((n < 1) || (window_parts(ss, first, n, &at, &n_first) != 0)) return 1;
+
+    start_accumulator(&a, (double) ss->sample_value[at]);
+    add_values(&a, ss->sample_value + at, n_first);
+    add_values(&a, ss->sample_value, n - n_first); /* the part wrapped round to the start, if any */
+
+    stats->n        = a.n;
+    stats->min      = (int32_t) a.min;
+    stats->max      = (int32_t) a.max;
+    stats->mean     = a.pivot + a.sum / (double) a.n;
+    stats->variance = (a.sum2 - a.sum * a.sum / (double) a.n) / (double) a.n;
+    if(stats->variance < 0.0) stats->variance = 0.0; /* rounding, when every value is the same */
+    return 0;
+}
+
+/*-----------------------------------------------------------------------------*/
+
+int ss_interval_stats(const struct sample_store *ss, size_t first, size_t n, struct ss_interval_stats *stats)
+{
+    struct accumulator a;
+    size_t at, n_first;
+    double variance;
+
+    if((n < 2) || (window_parts(ss, first, n, &at, &n_first) != 0)) return 1;
+
+    if(n_first > 1)
+        start_accumulator(&a, (double) (ss->time_value[at+1] - ss->time_value[at]));
+    else
+        start_accumulator(&a, (double) (ss->time_value[0] - ss->time_value[at]));
+
+    add_intervals(&a, ss->time_value + at, n_first);
+    if(n > n_first)
+        {
+            add_one(&a, ss->time_value[0] - ss->time_value[at + n_first - 1]); /* the interval across the wrap */
+            add_intervals(&a, ss->time_value, n - n_first);
+        }
+
+    variance = (a.sum2 - a.sum * a.sum / (double) a.n) / (double) a.n;
+    stats->n      = a.n;
+    stats->min    = a.min;
+    stats->max    = a.max;
+    stats->mean   = a.pivot + a.sum / (double) a.n;
+    stats->jitter = (variance > 0.0) ? sqrt(variance) : 0.0;
+    return 0;
+}
+
+/*-----------------------------------------------------------------------------*/
+
+/* where a window starts in the arrays, and how much of it comes before the end of them */
+static int window_parts(const struct sample_store *ss, size_t first, size_t n, size_t *at, size_t *n_first)
+{
+    /* first past head would make head - first wrap round to a huge size_t, so it is ruled out before */
+    if((first < ss_first(ss)) || (first > ss->head)) return 1;
+    if(n > ss->head - first) return 1;
+
+    *at      = first & ss->mask;
+    *n_first = ss->capacity - *at;
+    if(*n_first > n) *n_first = n;
+    return 0;
+}
+
+/*-----------------------------------------------------------------------------*/
+
+static void start_accumulator(struct accumulator *a, double pivot)
+{
+    memset(a, 0, sizeof(*a));
+    a->min   = INT64_MAX;
+    a->max   = INT64_MIN;
+    a->pivot = pivot;
+}
+
+/*-----------------------------------------------------------------------------*/
+
+/* one value, or one interval, the long way */
+static void add_one(struct accumulator *a, int64_t x)
+{
+    double d = (double) x - a->pivot;
+
+    if(x < a->min) a->min = x;
+    if(x > a->max) a->max = x;
+    a->sum  += d;
+    a->sum2 += d * d;
+    a->n++;
+}
+
+/*-----------------------------------------------------------------------------*/
+
+/* n contiguous values, 8 at a time */
+static void add_values(struct accumulator *a, const int32_t *x, size_t n)
+{
+    v8si vmin  = { INT32_MAX, INT32_MAX, INT32_MAX, INT32_MAX, INT32_MAX, INT32_MAX, INT32_MAX, INT32_MAX };
+    v8si vmax  = { INT32_MIN, INT32_MIN, INT32_MIN, INT32_MIN, INT32_MIN, INT32_MIN, INT32_MIN, INT32_MIN };
+    v4df pivot = { a->pivot, a->pivot, a->pivot, a->pivot };
+    v4df s0 = { 0 }, s1 = { 0 }, q0 = { 0 }, q1 = { 0 };
+    v8si v, m;
+    v4si lo, hi;
+    v4df d0, d1;
+    size_t i;
+    int    j;
+
+    for (i=0; i+8<=n; i+=8)
+        {
+            memcpy(&v, x + i, sizeof(v)); /* an unaligned load */
+            m    = v < vmin;              /* -1 in the lanes where v is smaller */
+            vmin = (v & m) | (vmin & ~m);
+            m    = v > vmax;
+            vmax = (v & m) | (vmax & ~m);
+
+            memcpy(&lo, x + i, sizeof(lo));
+            memcpy(&hi, x + i + 4, sizeof(hi));
+            d0 = __builtin_convertvector(lo, v4df) - pivot;
+            d1 = __builtin_convertvector(hi, v4df) - pivot;
+            s0 += d0;
+            s1 += d1;
+            q0 += d0 * d0;
+            q1 += d1 * d1;
+        }
+
+    for (j=0; j<8; j++)
+        {
+            if(vmin[j] < a->min) a->min = vmin[j];
+            if(vmax[j] > a->max) a->max = vmax[j];
+        }
+    for (j=0; j<4; j++)
+        {
+            a->sum  += s0[j] + s1[j];
+            a->sum2 += q0[j] + q1[j];
+        }
+    a->n += i;
+
+    for (; i<n; i++) add_one(a, x[i]); /* the last few */
+}
+
+/*-----------------------------------------------------------------------------*/
+
+/* the n-1 intervals between n contiguous times, 4 at a time */
+static void add_intervals(struct accumulator *a, const int64_t *t, size_t n)
+{
+    v4di vmin  = { INT64_MAX, INT64_MAX, INT64_MAX, INT64_MAX };
+    v4di vmax  = { INT64_MIN, INT64_MIN, INT64_MIN, INT64_MIN };
+    v4df pivot = { a->pivot, a->pivot, a->pivot, a->pivot };
+    v4df s = { 0 }, q = { 0 };
+    v4di t0, t1, d, m;
+    v4df dd;
+    size_t i;
+    int    j;
+
+    if(n < 2) return;
+    for (i=0; i+4<n; i+=4)
+        {
+            memcpy(&t0, t + i, sizeof(t0));
+            memcpy(&t1, t + i + 1, sizeof(t1)); /* the same, one on */
+            d    = t1 - t0;
+            m    = d < vmin;
+            vmin = (d & m) | (vmin & ~m);
+            m    = d > vmax;
+            vmax = (d & m) | (vmax & ~m);
+
+            dd = __builtin_convertvector(d, v4df) - pivot;
+            s += dd;
+            q += dd * dd;
+        }
+
+    for (j=0; j<4; j++)
+        {
+            if(vmin[j] < a->min) a->min = vmin[j];
+            if(vmax[j] > a->max) a->max = vmax[j];
+            a->sum  += s[j];
+            a->sum2 += q[j];
+        }
+    a->n += i;
+
+    for (; i+1<n; i++) add_one(a, t[i+1] - t[i]);
+}
+/*-----------------------------------------------------------------------------*/
@@ -0,0 +1,71 @@
+/* sample_store.h */
+
+/* The samples of the sample_time_stamp programs, stored as a structure of arrays.
+
+   queue_item holds a time_value and a sample_value side by side, so a loop over the times,
+   to find the intervals between samples, steps over every sample_value too, and a loop over the values
+   steps over every time, and neither can be loaded into vector registers a row at a time.
+   Here the times are in one array, and the values in another, each contiguous, so the statistics of
+   a window of samples are found with SIMD instructions, 4 or 8 lanes at a time:
+
+   ss_value_stats()     the minimum, maximum, mean and variance of the sample values,
+   ss_interval_stats()  the minimum, maximum and mean of the intervals between the samples' times,
+                        and their standard deviation, the jitter.
+
+   The vectors are GCC's vector extensions, which become AVX2 instructions with -mavx2, or -march=native
+   on a machine that has them, and pairs of SSE2 instructions without.
+   The sums are taken about the first value of the window, or the first interval, rather than about 0,
+   so that the variance does not lose its precision when the values are large and close together,
+   as times are.
+
+   The store is a ring, as the queues are: ss_put() overwrites the oldest sample when it is full.
+   A window is given by the sequence number of its first sample, counting from 0 for the first ever put,
+   and may be anywhere among the samples still held, wrapped round the end of the arrays or not. */
+
+#ifndef SAMPLE_STORE_H
+#define SAMPLE_STORE_H
+
+#include <stddef.h>    /* needed for size_t */
+#include <stdint.h>    /* defines some types, including: int64_t */
+
+struct sample_store
+{
+    int64_t *time_value;    /* capacity times, ns */
+    int32_t *sample_value;  /* capacity values */
+    size_t   capacity;      /* a power of two */
+    size_t   mask;
+    size_t   head;          /* the number of samples ever put, the next goes at head & mask */
+};
+
+struct ss_value_stats
+{
+    size_t  n;
+    int32_t min, max;
+    double  mean;
+    double  variance;       /* of the population, the mean square about the mean */
+};
+
+struct ss_interval_stats
+{
+    size_t  n;              /* the number of intervals, one fewer than the samples */
+    int64_t min, max;
+    double  mean;           /* the mean period */
+    double  jitter;         /* the standard deviation of the intervals */
+};
+
+/* allocate the arrays, for at least capacity samples, returns 0 on success, 1 if out of memory */
+int    ss_init(struct sample_store *ss, size_t capacity);
+void   ss_free(struct sample_store *ss);
+
+/* one sample, overwriting the oldest if the store is full */
+void   ss_put(struct sample_store *ss, int64_t time_value, int32_t sample_value);
+
+/* the sequence number of the oldest sample still held */
+size_t ss_first(const struct sample_store *ss);
+
+/* the statistics of the n samples from sequence number first,
+   returns 0, or 1 if those samples are not all held, or n is too small (1 for values, 2 for intervals) */
+int    ss_value_stats(const struct sample_store *ss, size_t first, size_t n, struct ss_value_stats *stats);
+int    ss_interval_stats(const struct sample_store *ss, size_t first, size_t n, struct ss_interval_stats *stats);
+
+#endif /* SAMPLE_STORE_H */
@@ -0,0 +1,206 @@
+/* sample_store_benchmark_01.c */
+
+/*
+   The statistics of a window of samples: the minimum, maximum, mean and variance of the sample values,
+   and the mean period, and jitter, of the intervals between their times.
+
+   The same samples are kept twice: as an array of queue_item, time_value and sample_value side by side,
+   as in the sample_time_stamp programs, with the statistics found by a plain scalar loop over it,
+   and in a structure of arrays (see sample_store.c), with the statistics found by vectorised loops.
+   Both are rings, filled past their end, so that many of the windows wrap round.
+
+   For each size of window, windows are taken from random places among the samples, and the
+   time per sample is printed for each way, with a check that they give the same answers.
+
+   The samples are a simulated sampler, every 1 ms, with up to 2 us of jitter.
+
+   Compilation advice:
+
+   gcc -std=gnu99 -Wall -Wextra -Werror -O2 -march=native -o sample_store_benchmark_01 sample_store_benchmark_01.c sample_store.c -lm
+
+   An execution suggestion:
+
+   ./sample_store_benchmark_01
+
+   Times are in nanoseconds.
+*/
+
+#include <stdio.h>     /* needed for printf() */
+#include <stdlib.h>
+#include <stdint.h>    /* defines some types, including: int64_t */
+#include <math.h>      /* needed for sqrt() and fabs() */
+#include <time.h>      /* needed for clock_gettime() and CLOCK_MONOTONIC */
+
+#include "sample_store.h"
+
+#define CAPACITY  (1<<20)  /* samples in each store */
+#define PERIOD    1000000  /* ns, the sampling period */
+#define JITTER       2000  /* ns, at most */
+#define WORK     50000000  /* samples, in all, for each size of window */
+#define SEED           34  /* repeatable */
+
+/* Set up structures for the starting and stopping times */
+static struct timespec start, end;
+
+/* The samples, side by side, an array of structures */
+typedef struct
+{
+    int64_t time_value;
+    int32_t sample_value;
+} queue_item;
+
+/* function templates */
+static void    aos_stats(const queue_item *queue_store, size_t capacity, size_t first, size_t n,
+                         struct ss_value_stats *v, struct ss_interval_stats *t);
+static int     same(double x, double y);
+static int64_t timespecDiff(struct timespec *timeA_p, struct timespec *timeB_p);
+static int64_t elapsed_time(void);
+static void    error_exit(char *s);
+
+int main(void)
+{
+    static const size_t window[5] = { 16, 256, 4096, 65536, CAPACITY - 1 };
+    struct sample_store      ss;
+    struct ss_value_stats    v_aos, v_soa;
+    struct ss_interval_stats t_aos, t_soa;
+    queue_item *queue_store;
+    size_t  oldest, first, n;
+    long    k, n_windows, r;
+    int64_t time_value = 0;
+    int64_t ns_aos, ns_soa;
+    double  check = 0.0;
+    int     w;
+
+    srand(SEED);
+    queue_store = (queue_item *) malloc(CAPACITY * sizeof(queue_item));
+    if((queue_store == NULL) || (ss_init(&ss, CAPACITY) != 0)) error_exit("out of memory");
+
+    /* fill both, and a half again, so that the oldest sample is half-way along */
+    for (k=0; k<CAPACITY + CAPACITY/2; k++)
+        {
+            time_value += PERIOD + (rand() % (2*JITTER+1)) - JITTER;
+            queue_store[k % CAPACITY].time_value   = time_value;
+            queue_store[k % CAPACITY].sample_value = rand();
+            ss_put(&ss, time_value, queue_store[k % CAPACITY].sample_value);
+        }
+    oldest = ss_first(&ss);
+
+    printf("%10s %18s %18s %10s\n", "window", "AoS scalar ns/sample", "SoA SIMD ns/sample", "speed-up");
+    for (w=0; w<5; w++)
+        {
+            n = window[w];
+            n_windows = WORK / (long) n;
+            ns_aos = ns_soa = 0;
+            for (r=0; r<n_windows; r++)
+                {
+                    first = oldest + (size_t) rand() % (CAPACITY - n + 1); /* anywhere among the samples held */
+
+                    clock_gettime(CLOCK_MONOTONIC, &start);
+                    aos_stats(queue_store, CAPACITY, first, n, &v_aos, &t_aos);
+                    ns_aos += elapsed_time();
+
+                    clock_gettime(CLOCK_MONOTONIC, &start);
+                    (void) ss_value_stats(&ss, first, n, &v_soa);
+                    (void) ss_interval_stats(&ss, first, n, &t_soa);
+                    ns_soa += elapsed_time();
+
+                    if((v_aos.min != v_soa.min) || (v_aos.max != v_soa.max) || (t_aos.min != t_soa.min) || (t_aos.max != t_soa.max)
+                            || !same(v_aos.mean, v_soa.mean) || !same(v_aos.variance, v_soa.variance)
+                            || !same(t_aos.mean, t_soa.mean) || !same(t_aos.jitter, t_soa.jitter))
+                        error_exit("the two ways give different answers");
+                    check += t_soa.jitter;
+                }
+            printf("%10ld %18.3f %18.3f %10.2f\n", (long) n,
+                   (double) ns_aos / ((double) n_windows * (double) n), (double) ns_soa / ((double) n_windows * (double) n),
+                   (double) ns_aos / (double) (ns_soa > 0 ? ns_soa : 1));
+        }
+    printf("the last window: value mean %.1f, sd %.1f, period %.1f ns, jitter %.1f ns\n",
+           v_soa.mean, sqrt(v_soa.variance), t_soa.mean, t_soa.jitter);
+
+    free(queue_store);
+    ss_free(&ss);
+    return (check > 0.0) ? 0 : 1;
+}
+
+/*-----------------------------------------------------------------------------*/
+
+/* The statistics, by one scalar loop over the queue_items, as a first attempt would find them */
+static void aos_stats(const queue_item *queue_store, size_t capacity, size_t first, size_t n,
+                      struct ss_value_stats *v, struct ss_interval_stats *t)
+{
+    const queue_item *item, *last;
+    double  sum = 0.0, sum2 = 0.0, tsum = 0.0, tsum2 = 0.0;
+    double  pivot, tpivot, d;
+    int64_t interval;
+    size_t  k;
+
+    item   = &queue_store[first % capacity];
+    pivot  = (double) item->sample_value;
+    tpivot = (double) (queue_store[(first+1) % capacity].time_value - item->time_value);
+    v->min = v->max = item->sample_value;
+    t->min = INT64_MAX;
+    t->max = INT64_MIN;
+
+    last = NULL;
+    for (k=0; k<n; k++)
+        {
+            item = &queue_store[(first + k) & (capacity - 1)];
+            if(item->sample_value < v->min) v->min = item->sample_value;
+            if(item->sample_value > v->max) v->max = item->sample_value;
+            d     = (double) item->sample_value - pivot;
+            sum  += d;
+            sum2 += d * d;
+
+            if(last != NULL)
+                {
+                    interval = item->time_value - last->time_value;
+                    if(interval < t->min) t->min = interval;
+                    if(interval > t->max) t->max = interval;
+                    d      = (double) interval - tpivot;
+                    tsum  += d;
+                    tsum2 += d * d;
+                }
+            last = item;
+        }
+
+    v->n        = n;
+    v->mean     = pivot + sum / (double) n;
+    v->variance = (sum2 - sum * sum / (double) n) / (double) n;
+    t->n        = n - 1;
+    t->mean     = tpivot + tsum / (double) (n - 1);
+    d           = (tsum2 - tsum * tsum / (double) (n - 1)) / (double) (n - 1);
+    t->jitter   = (d > 0.0) ? sqrt(d) : 0.0;
+}
+
+/*-----------------------------------------------------------------------------*/
+
+/* the sums are added in a different order, so the answers may differ in their last few digits */
+static int same(double x, double y)
+{
+    return fabs(x - y) <= 1e-9 * (fabs(x) + fabs(y)) + 1e-9;
+}
+
+/*-----------------------------------------------------------------------------*/
+
+static int64_t timespecDiff(struct timespec *timeA_p, struct timespec *timeB_p)
+{
+    return (int64_t) ((timeA_p->tv_sec * 1000000000) + timeA_p->tv_nsec) -
+           ((timeB_p->tv_sec * 1000000000) + timeB_p->tv_nsec);
+}
+
+/*-----------------------------------------------------------------------------*/
+
+static int64_t elapsed_time(void)
+{
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    return (int64_t) timespecDiff(&end, &start);
+}
+
+/*-----------------------------------------------------------------------------*/
+
+/* A standard formatter for printing eror messages, and exiting */
+static void error_exit(char *s)
+{
+    fprintf(stderr, "\nerror: %s - bye!\n",s);
+    exit(1);
+}
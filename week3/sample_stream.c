@@ -0,0 +1,355 @@
+/* sample_stream.c */
+
+/* Samples compressed by delta-of-delta times, and XORed values, in blocks, see sample_stream.h */
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>    /* defines some types, including: int64_t */
+
+#include "sample_stream.h"
+
+#define MAX_SAMPLE_BITS 112  /* '1111' and 64 bits of time, '11', 10 bits of window, and 32 of value */
+
+/* function templates, for local helpers */
+static int      make_room(struct sample_stream *st, size_t n_bits);
+static void     put_bits(struct sample_stream *st, uint64_t bits, int n);
+static uint64_t get_bits(const uint64_t *word, size_t *bit, int n);
+static int64_t  sign_extend(uint64_t bits, int n);
+static int64_t  in_quanta(int64_t time_value, int64_t quantum);
+static void     put_time(struct sample_stream *st, int64_t dod);
+static void     put_value(struct sample_stream *st, uint32_t x);
+
+/*-----------------------------------------------------------------------------*/
+
+int st_init(struct sample_stream *st, int64_t quantum, size_t expected_samples)
+{
+    memset(st, 0, sizeof(*st));
+    if(quantum < 1) return 1;
+    st->quantum = quantum;
+    st->leading = -1;
+
+    /* room for two bytes a sample, and an index entry for each block, before any realloc() */
+    st->n_words    = expected_samples / 4 + 2;
+    st->max_blocks = expected_samples / ST_BLOCK_SAMPLES + 1;
+    st->word  = (uint64_t *) calloc(st->n_words, sizeof(uint64_t));
+    st->block = (struct st_block *) calloc(st->max_blocks, sizeof(struct st_block));
+    if((st->word == NULL) || (st->block == NULL))
+        {
+            st_free(st);
+            return 1;
+        }
+    return 0;
+}
+
+/*-----------------------------------------------------------------------------*/
+
+void st_free(struct sample_stream *st)
+{
+    free(st->word);
+    free(st->block);
+    st->word  = NULL;
+    st->block = NULL;
+}
+
+/*-----------------------------------------------------------------------------*/
+
+int st_append(struct sample_stream *st, int64_t time_value, int32_t sample_value)
+{
+    int64_t t = in_quanta(time_value, st->quantum);
+    int64_t delta;
+    size_t  at;
+    struct st_block *b;
+
+    if(make_room(st, MAX_SAMPLE_BITS) != 0) return 1;
+
+    if(st->n_samples % ST_BLOCK_SAMPLES == 0)
+        {
+            /* the first sample of a block goes in the index, whole, and none of its bits in the stream */
+            if(st->n_blocks == st->max_blocks)
+                {
+                    b = (struct st_block *) realloc(st->block, 2 * st->max_blocks * sizeof(struct st_block));
+                    if(b == NULL) return 1;
+                    st->block       = b;
+                    st->max_blocks *= 2;
+                }
+            b = &st->block[st->n_blocks++];
+            b->first_time  = t;
+            b->first_delta = (st->n_samples > 0) ? t - st->last_time : 0; /* so that a steady period stays at 0 */
+            b->first_value = sample_value;
+            b->bit_offset  = st->n_bits;
+
+            st->last_delta = b->first_delta;
+            st->leading    = -1;
+        }
+    else
+        {
+            delta = t - st->last_time;
+            at = st->n_bits;
+            put_time(st, delta - st->last_delta);
+            st->n_time_bits += st->n_bits - at;
+
+            at = st->n_bits;
+            put_value(st, (uint32_t) sample_value ^ (uint32_t) st->last_value);
+            st->n_value_bits += st->n_bits - at;
+
+            st->last_delta = delta;
+        }
+
+    st->last_time  = t;
+    st->last_value = sample_value;
+    st->n_samples++;
+    return 0;
+}
+
+/*-----------------------------------------------------------------------------*/
+
+int st_get(const struct sample_stream *st, size_t k, int64_t *time_value, int32_t *sample_value)
+{
+    struct st_reader r;
+
+    if(st_seek(&r, st, k) != 0) return 1;
+    return st_next(&r, time_value, sample_value);
+}
+
+/*-----------------------------------------------------------------------------*/
+
+size_t st_find(const struct sample_stream *st, int64_t time_value)
+{
+    struct st_reader r;
+    size_t  lo = 0, hi = st->n_blocks, mid;
+    int64_t t;
+    int32_t v;
+
+    /* the first block that starts after time_value, the sample is in the one before it, if anywhere */
+    while(lo < hi)
+        {
+            mid = (lo + hi) / 2;
+            if(st->block[mid].first_time * st->quantum > time_value)
+                hi = mid;
+            else
+                lo = mid + 1;
+        }
+    if(lo == 0) return 0;
+
+    (void) st_seek(&r, st, (lo - 1) * ST_BLOCK_SAMPLES);
+    while((r.k < lo * ST_BLOCK_SAMPLES) && (st_next(&r, &t, &v) == 0))
+        if(t >= time_value) return r.k - 1;
+    return (lo < st->n_blocks) ? lo * ST_BLOCK_SAMPLES : st->n_samples;
+}
+
+/*-----------------------------------------------------------------------------*/
+
+int st_seek(struct st_reader *r, const struct sample_stream *st, size_t k)
+{
+    int64_t t;
+    int32_t v;
+
+    memset(r, 0, sizeof(*r));
+    r->st = st;
+    if(k >= st->n_samples) return 1;
+
+    /* from the start of its block, decoding the samples before it */
+    r->k = k - k % ST_BLOCK_SAMPLES;
+    while(r->k < k) (void) st_next(r, &t, &v);
+    return 0;
+}
+
+/*-----------------------------------------------------------------------------*/
+
+int st_next(struct st_reader *r, int64_t *time_value, int32_t *sample_value)
+{
+    const struct sample_stream *st = r->st;
+    const struct st_block *b;
+    uint64_t x;
+    int      len;
+
+    if(r->k >= st->n_samples) return 1;
+
+    if(r->k % ST_BLOCK_SAMPLES == 0)
+        {
+            b = &st->block[r->k / ST_BLOCK_SAMPLES];
+            r->time    = b->first_time;
+            r->delta   = b->first_delta;
+            r->value   = b->first_value;
+            r->bit     = b->bit_offset;
+            r->leading = -1;
+        }
+    else
+        {
+            /* the time: the prefix says how many bits the delta-of-delta has */
+            if(get_bits(st->word, &r->bit, 1) == 0)
+                x = 0;
+            else if(get_bits(st->word, &r->bit, 1) == 0)
+                x = (uint64_t) sign_extend(get_bits(st->word, &r->bit, 7), 7);
+            else if(get_bits(st->word, &r->bit, 1) == 0)
+                x = (uint64_t) sign_extend(get_bits(st->word, &r->bit, 12), 12);
+            else if(get_bits(st->word, &r->bit, 1) == 0)
+                x = (uint64_t) sign_extend(get_bits(st->word, &r->bit, 20), 20);
+            else
+                x = get_bits(st->word, &r->bit, 64);
+            r->delta += (int64_t) x;
+            r->time  += r->delta;
+
+            /* the value */
+            if(get_bits(st->word, &r->bit, 1) != 0)
+                {
+                    if(get_bits(st->word, &r->bit, 1) != 0)
+                        {
+                            r->leading  = (int) get_bits(st->word, &r->bit, 5);
+                            len         = (int) get_bits(st->word, &r->bit, 5) + 1;
+                            r->trailing = 32 - r->leading - len;
+                        }
+                    len = 32 - r->leading - r->trailing;
+                    x = get_bits(st->word, &r->bit, len) << r->trailing;
+                    r->value = (int32_t) ((uint32_t) r->value ^ (uint32_t) x);
+                }
+        }
+
+    *time_value   = r->time * st->quantum;
+    *sample_value = r->value;
+    r->k++;
+    return 0;
+}
+
+/*-----------------------------------------------------------------------------*/
+
+size_t st_bytes(const struct sample_stream *st)
+{
+    return (st->n_bits + 7) / 8 + st->n_blocks * sizeof(struct st_block);
+}
+
+/*-----------------------------------------------------------------------------*/
+
+/* the delta-of-delta, in the smallest bucket that holds it */
+static void put_time(struct sample_stream *st, int64_t dod)
+{
+    if(dod == 0)
+        put_bits(st, 0x0, 1);
+    else if((dod >= -64) && (dod <= 63))
+        {
+            put_bits(st, 0x2, 2);
+            put_bits(st, (uint64_t) dod, 7);
+        }
+    else if((dod >= -2048) && (dod <= 2047))
+        {
+            put_bits(st, 0x6, 3);
+            put_bits(st, (uint64_t) dod, 12);
+        }
+    else if((dod >= -524288) && (dod <= 524287))
+        {
+            put_bits(st, 0xE, 4);
+            put_bits(st, (uint64_t) dod, 20);
+        }
+    else
+        {
+            put_bits(st, 0xF, 4);
+            put_bits(st, (uint64_t) dod, 64);
+        }
+}
+
+/*-----------------------------------------------------------------------------*/
+
+/* the XOR of a value with the one before, the bits that differ, in the last window if they fit */
+static void put_value(struct sample_stream *st, uint32_t x)
+{
+    int leading, trailing, len;
+
+    if(x == 0)
+        {
+            put_bits(st, 0x0, 1);
+            return;
+        }
+    leading  = __builtin_clz(x);  /* x is not 0, so both are defined, and at most 31 */
+    trailing = __builtin_ctz(x);
+
+    if((st->leading >= 0) && (leading >= st->leading) && (trailing >= st->trailing))
+        {
+            put_bits(st, 0x2, 2);
+            len = 32 - st->leading - st->trailing;
+            put_bits(st, x >> st->trailing, len);
+        }
+    else
+        {
+            len = 32 - leading - trailing;
+            put_bits(st, 0x3, 2);
+            put_bits(st, (uint64_t) leading, 5);
+            put_bits(st, (uint64_t) (len - 1), 5);
+            put_bits(st, x >> trailing, len);
+            st->leading  = leading;
+            st->trailing = trailing;
+        }
+}
+
+/*-----------------------------------------------------------------------------*/
+
+/* grow the stream, by doubling, until n_bits more will fit, with a spare word, returns 0, or 1 if out of memory */
+static int make_room(struct sample_stream *st, size_t n_bits)
+{
+    size_t    need = (st->n_bits + n_bits) / 64 + 2;
+    size_t    n_words = st->n_words;
+    uint64_t *word;
+
+    if(need <= n_words) return 0;
+    while(n_words < need) n_words *= 2;
+
+    word = (uint64_t *) realloc(st->word, n_words * sizeof(uint64_t));
+    if(word == NULL) return 1;
+    memset(word + st->n_words, 0, (n_words - st->n_words) * sizeof(uint64_t)); /* put_bits() ORs into it */
+    st->word    = word;
+    st->n_words = n_words;
+    return 0;
+}
+
+/*-----------------------------------------------------------------------------*/
+
+/* the low n bits of bits, 1 <= n <= 64, onto the end of the stream, most significant first */
+static void put_bits(struct sample_stream *st, uint64_t bits, int n)
+{
+    size_t w    = st->n_bits / 64;
+    int    used = (int) (st->n_bits % 64);
+    int    room = 64 - used;
+
+    if(n < 64) bits &= (1ULL << n) - 1;
+    if(n <= room)
+        st->word[w] |= bits << (room - n);
+    else
+        {
+            st->word[w]     |= bits >> (n - room);
+            st->word[w + 1] |= bits << (64 - (n - room));
+        }
+    st->n_bits += (size_t) n;
+}
+
+/*-----------------------------------------------------------------------------*/
+
+/* the next n bits, 1 <= n <= 64, from *bit, which moves on past them */
+static uint64_t get_bits(const uint64_t *word, size_t *bit, int n)
+{
+    size_t   w    = *bit / 64;
+    int      used = (int) (*bit % 64);
+    uint64_t bits = word[w] << used;
+
+    if(used + n > 64) bits |= word[w + 1] >> (64 - used); /* used > 0, here */
+    *bit += (size_t) n;
+    return bits >> (64 - n);
+}
+
+/*-----------------------------------------------------------------------------*/
+
+/* an n-bit two's complement number, to an int64_t */
+static int64_t sign_extend(uint64_t bits, int n)
+{
+    return (int64_t) (bits << (64 - n)) >> (64 - n);
+}
+
+/*-----------------------------------------------------------------------------*/
+
+/* rounded down, before the start as well as after it */
+static int64_t in_quanta(int64_t time_value, int64_t quantum)
+{
+    int64_t t = time_value / quantum;
+
+    if((time_value % quantum) < 0) t--;
+    return t;
+}
+/*-----------------------------------------------------------------------------*/
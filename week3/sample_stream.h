@@ -0,0 +1,109 @@
+/* sample_stream.h */
+
+/* Samples, compressed, as a stream of bits, after Facebook's Gorilla time-series store.
+
+   queue_item.time_value, in the workshop, is an int, of nanoseconds, which overflows after 2.147 s,
+   so any run longer than that is nonsense. An int64_t is long enough for 292 years, but it makes each
+   sample twice the size, 16 bytes with the padding, and a day of samples at 10 Hz is then 13.8 MB.
+   Here the times are 64-bit, but each sample costs only the bits that it needs:
+
+   the time     the difference between its interval and the one before, the delta-of-delta, which is 0,
+                1 bit, for a sampler that keeps exactly to its period, and a few bits for a little jitter:
+
+                   '0'                       0
+                   '10'   and 7 bits         -64 to 63
+                   '110'  and 12 bits        -2048 to 2047
+                   '1110' and 20 bits        -524288 to 524287
+                   '1111' and 64 bits        anything else
+
+   the value    XORed with the value before. Equal values cost 1 bit, '0'. Otherwise '1', and only the
+                bits between the first and the last that differ: '10' and those bits, if they fit inside
+                the window of the XOR before, or '11', 5 bits of leading zeros, 5 bits of length, and the bits.
+
+   Times are counted in units of quantum ns. A quantum of 1 keeps them exactly, and nanosecond jitter
+   then costs 12 to 20 bits a sample. A quantum of 1000 keeps them to the microsecond, rounded down,
+   and the same jitter costs a few bits.
+
+   The samples are grouped in blocks of ST_BLOCK_SAMPLES. Each block starts with its first time and value,
+   and the interval before it, uncompressed, in an index beside the stream, so it can be decoded without
+   any of the blocks before it: st_get() finds the k-th sample by decoding, at most, one block,
+   and st_find() finds a time by a binary search of the blocks, and then the same.
+
+   The stream grows, by realloc(), as samples are appended. st_init() can be told how many to expect,
+   so that none is needed, for that many samples at a couple of bytes each. */
+
+#ifndef SAMPLE_STREAM_H
+#define SAMPLE_STREAM_H
+
+#include <stddef.h>    /* needed for size_t */
+#include <stdint.h>    /* defines some types, including: int64_t */
+
+#define ST_BLOCK_SAMPLES 1024  /* samples between random-access points, a power of two */
+
+struct st_block
+{
+    int64_t first_time;   /* in quanta */
+    int64_t first_delta;  /* the interval before the first sample, 0 in the first block */
+    size_t  bit_offset;   /* where the rest of the block starts, in the stream */
+    int32_t first_value;
+};
+
+struct sample_stream
+{
+    uint64_t        *word;          /* the bits, the first in the top bit of word[0] */
+    size_t           n_words;       /* allocated */
+    size_t           n_bits;        /* used */
+    struct st_block *block;
+    size_t           n_blocks;
+    size_t           max_blocks;    /* allocated */
+    size_t           n_samples;
+    int64_t          quantum;       /* ns */
+
+    /* where the encoder is up to */
+    int64_t          last_time;
+    int64_t          last_delta;
+    int32_t          last_value;
+    int              leading;       /* the window of the last XOR, -1 for none yet, in this block */
+    int              trailing;
+
+    /* where the bits went */
+    size_t           n_time_bits;
+    size_t           n_value_bits;
+};
+
+/* A decoder, for reading samples in order, from anywhere */
+struct st_reader
+{
+    const struct sample_stream *st;
+    size_t           k;             /* the next sample */
+    size_t           bit;           /* and where it starts */
+    int64_t          time;
+    int64_t          delta;
+    int32_t          value;
+    int              leading;
+    int              trailing;
+};
+
+/* start an empty stream, with times in units of quantum ns, and room for expected_samples,
+   returns 0 on success, or 1 if out of memory */
+int    st_init(struct sample_stream *st, int64_t quantum, size_t expected_samples);
+void   st_free(struct sample_stream *st);
+
+/* add one sample, returns 0, or 1 if out of memory */
+int    st_append(struct sample_stream *st, int64_t time_value, int32_t sample_value);
+
+/* the k-th sample, returns 0, or 1 if there is no such sample */
+int    st_get(const struct sample_stream *st, size_t k, int64_t *time_value, int32_t *sample_value);
+
+/* the first sample at or after time_value, as an index, or st->n_samples if there is none */
+size_t st_find(const struct sample_stream *st, int64_t time_value);
+
+/* read in order, from sample k: st_seek() returns 0, or 1 if there is no such sample,
+   and st_next() returns 0, and the next sample, or 1 at the end */
+int    st_seek(struct st_reader *r, const struct sample_stream *st, size_t k);
+int    st_next(struct st_reader *r, int64_t *time_value, int32_t *sample_value);
+
+/* the memory used by the samples, the stream and its index, in bytes */
+size_t st_bytes(const struct sample_stream *st);
+
+#endif /* SAMPLE_STREAM_H */
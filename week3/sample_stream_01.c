@@ -0,0 +1,224 @@
+/* sample_stream_01.c */
+
+/*
+   How small do the samples become, in a compressed sample stream (see sample_stream.c)?
+
+   Days of samples, at 10 Hz, are simulated, rather than waited for, with several kinds of time
+   and of value, and each kind is appended to a stream, which is then checked, every sample of it,
+   in order, and at random, against what was put in, and timed.
+
+   times    exact:   every period, to the nanosecond, a perfect sampler
+            jitter:  up to 3 us late, as the sampler of the workshop is, with a busy-wait, and now
+                     and then 50 us late, when it is pre-empted
+   values   steady:  the same, every time
+            sensor:  a 12-bit reading of a slow sine wave, with a little noise
+            rand():  as in the workshop, every bit a surprise
+
+   The size of each sample is compared with a queue_item of an int64_t time_value and an int
+   sample_value, 16 bytes, with its padding.
+
+   Compilation advice:
+
+   gcc -std=gnu99 -Wall -Wextra -Werror -O2 -o sample_stream_01 sample_stream_01.c sample_stream.c -lm
+
+   An execution suggestion:
+
+   ./sample_stream_01 -d 1
+
+   options:
+   -d days        of samples (default 1)
+   -r rate_hz     (default 10)
+
+   Times are in nanoseconds.
+*/
+
+#include <stdio.h>     /* needed for printf() */
+#include <stdlib.h>
+#include <stdint.h>    /* defines some types, including: int64_t */
+#include <math.h>      /* needed for sin() */
+#include <time.h>      /* needed for clock_gettime() and CLOCK_MONOTONIC */
+#include <unistd.h>    /* needed for getopt() */
+
+#include "sample_stream.h"
+
+#define N_RANDOM  100000   /* random reads, of each stream */
+#define SEED          48   /* repeatable */
+
+#define USAGE "Usage is: ./sample_stream_01 [-d days] [-r rate_hz]\n"
+
+/* the kinds of time, and of value */
+#define EXACT  0
+#define JITTER 1
+#define STEADY 0
+#define SENSOR 1
+#define RANDOM 2
+
+/* We are free to define the items that will be in a queue_item */
+typedef struct
+{
+    int64_t time_value;
+    int     sample_value;
+} queue_item;
+
+/* Set up structures for the starting and stopping times */
+static struct timespec start;
+
+/* function templates */
+static void    simulate(queue_item *item, long n, int64_t period, int time_kind, int value_kind);
+static void    run(const queue_item *item, long n, double days, int64_t quantum, const char *name);
+static int64_t elapsed_time(void);
+static void    error_exit(char *s);
+
+int main(int argc, char *argv[])
+{
+    queue_item *item;
+    double  days = 1.0;
+    long    rate_hz = 10;
+    long    n;
+    int64_t period;
+    int     opt;
+
+    while((opt = getopt(argc, argv, "d:r:")) != -1)
+        switch(opt)
+            {
+            case 'd':
+                days = atof(optarg);
+                break;
+            case 'r':
+                rate_hz = atol(optarg);
+                break;
+            default:
+                fprintf(stderr, USAGE);
+                return EXIT_FAILURE;
+            }
+    if((days <= 0.0) || (rate_hz < 1) || (rate_hz > 1000000000))
+        {
+            fprintf(stderr, USAGE);
+            return EXIT_FAILURE;
+        }
+
+    n      = (long) (days * 86400.0 * (double) rate_hz);
+    period = 1000000000 / rate_hz;
+    if(n < 2) error_exit("too few samples");
+    item = (queue_item *) malloc((size_t) n * sizeof(queue_item));
+    if(item == NULL) error_exit("out of memory for the samples");
+
+    printf("%ld samples, %.2f days at %ld Hz, %.1f MB as queue_items of %d bytes\n\n",
+           n, days, rate_hz, (double) n * sizeof(queue_item) / 1e6, (int) sizeof(queue_item));
+    printf("%-26s %8s %10s %10s %10s %10s %8s %12s %12s\n", "times, values", "quantum",
+           "time bits", "value bits", "bytes", "MB/day", "ratio", "ns/get", "ns/next");
+
+    srand(SEED);
+    simulate(item, n, period, EXACT, STEADY);
+    run(item, n, days, 1, "exact, steady");
+    simulate(item, n, period, EXACT, SENSOR);
+    run(item, n, days, 1, "exact, sensor");
+    simulate(item, n, period, JITTER, SENSOR);
+    run(item, n, days, 1, "jitter, sensor");
+    run(item, n, days, 1000, "jitter, sensor");
+    simulate(item, n, period, JITTER, RANDOM);
+    run(item, n, days, 1, "jitter, rand()");
+    run(item, n, days, 1000, "jitter, rand()");
+
+    free(item);
+    return 0;
+}
+
+/*-----------------------------------------------------------------------------*/
+
+/* n samples, of the given kinds */
+static void simulate(queue_item *item, long n, int64_t period, int time_kind, int value_kind)
+{
+    const double two_pi = 6.283185307179586;
+    long k;
+
+    for (k=0; k<n; k++)
+        {
+            item[k].time_value = (k+1) * period;
+            if(time_kind == JITTER)
+                item[k].time_value += (rand() % 3000) + ((rand() % 1000 == 0) ? 50000 : 0);
+
+            switch(value_kind)
+                {
+                case SENSOR:
+                    /* a sine wave with a ten-minute period, read to 12 bits, with a count or two of noise */
+                    item[k].sample_value = 2048 + (int) (1500.0 * sin(two_pi * (double) item[k].time_value / 600e9))
+                                           + (rand() % 5) - 2;
+                    break;
+                case RANDOM:
+                    item[k].sample_value = rand();
+                    break;
+                default: /* STEADY */
+                    item[k].sample_value = 1234;
+                    break;
+                }
+        }
+}
+
+/*-----------------------------------------------------------------------------*/
+
+/* compress the samples, check them, in order and at random, and print a line of the table */
+static void run(const queue_item *item, long n, double days, int64_t quantum, const char *name)
+{
+    struct sample_stream st;
+    struct st_reader     r;
+    int64_t t, ns_get, ns_next;
+    int32_t v;
+    long    i, k;
+
+    if(st_init(&st, quantum, (size_t) n) != 0) error_exit("out of memory for the stream");
+    for (k=0; k<n; k++)
+        if(st_append(&st, item[k].time_value, item[k].sample_value) != 0) error_exit("out of memory for the stream");
+
+    /* every sample, in order, exact, or rounded down to the quantum */
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    (void) st_seek(&r, &st, 0);
+    for (k=0; st_next(&r, &t, &v) == 0; k++)
+        if((t != item[k].time_value - item[k].time_value % quantum) || (v != item[k].sample_value))
+            error_exit("a sample read in order is not the one that was put in");
+    ns_next = elapsed_time();
+    if(k != n) error_exit("the stream has lost samples");
+
+    /* at random, by index, and by time */
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (i=0; i<N_RANDOM; i++)
+        {
+            k = (long) (((uint64_t) rand() << 16 ^ (uint64_t) rand()) % (uint64_t) n);
+            if((st_get(&st, (size_t) k, &t, &v) != 0) || (v != item[k].sample_value))
+                error_exit("a sample read at random is not the one that was put in");
+        }
+    ns_get = elapsed_time();
+    for (i=0; i<1000; i++)
+        {
+            k = (long) (((uint64_t) rand() << 16 ^ (uint64_t) rand()) % (uint64_t) n);
+            if(st_find(&st, item[k].time_value - item[k].time_value % quantum) != (size_t) k)
+                error_exit("a sample found by its time is not the one that was put in");
+        }
+
+    printf("%-26s %8ld %10.2f %10.2f %10.2f %10.2f %8.1f %12.1f %12.2f\n", name, (long) quantum,
+           (double) st.n_time_bits / (double) n, (double) st.n_value_bits / (double) n,
+           (double) st_bytes(&st) / (double) n, (double) st_bytes(&st) / days / 1e6,
+           (double) (n * sizeof(queue_item)) / (double) st_bytes(&st),
+           (double) ns_get / N_RANDOM, (double) ns_next / (double) n);
+    st_free(&st);
+}
+
+/*-----------------------------------------------------------------------------*/
+
+/* the number of nanoseconds since the start */
+static int64_t elapsed_time(void)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (int64_t) (now.tv_sec - start.tv_sec) * 1000000000 + (now.tv_nsec - start.tv_nsec);
+}
+
+/*-----------------------------------------------------------------------------*/
+
+/* A standard formatter for printing eror messages, and exiting */
+static void error_exit(char *s)
+{
+    fprintf(stderr, "\nerror: %s - bye!\n",s);
+    exit(1);
+}
@@ -0,0 +1,173 @@
+/* sample_time_stamp_adaptive_01.c */
+
+/*
+   How much busy-waiting does the sampler need? Three answers, run one after the other:
+
+   workshop   the margin of sample_time_stamp_and_queue_workshop_03_problems.c, 16840 us of every 100000,
+              the same fraction, 16.84%, of whatever the period is here
+   fixed      the 50 us SPIN_MARGIN of the other sample_time_stamp programs
+   adaptive   a margin that tunes itself, from the overshoot of every sleep, to the least that keeps
+              the sleeps that wake too late, with no spin left, to the target miss rate (see sleep_margin.c)
+
+   Each runs the sampler engine (see sampler_engine.c), with the same channels, for the same time,
+   and a line of the table shows the margin at the end, how many sleeps woke after the due time,
+   the percentiles of the samples' lateness, and the percentage of the run spent busy-waiting,
+   the processor time that a margin costs.
+
+   Compilation advice:
+
+   gcc -std=gnu99 -Wall -Wextra -Werror -O2 -o sample_time_stamp_adaptive_01 sample_time_stamp_adaptive_01.c sampler_engine.c sleep_margin.c -lm
+
+   An execution suggestion:
+
+   ./sample_time_stamp_adaptive_01 -p 10000 -t 10 -m 0.01
+
+   options:
+   -p period_us   (default 10000)
+   -n n_channels  at that period, spread across it (default 1)
+   -t seconds     for each run (default 5)
+   -m miss_rate   the adaptive margin aims at (default 0.01)
+
+   Times are in nanoseconds.
+*/
+
+#include <stdio.h>     /* needed for printf() */
+#include <stdlib.h>
+#include <stdint.h>    /* defines some types, including: int64_t */
+#include <unistd.h>    /* needed for getopt() */
+
+#include "sampler_engine.h"
+#include "sleep_margin.h"
+
+#define MAX_RECORDS 1000000  /* lateness records, for each channel */
+
+#define WORKSHOP_MARGIN 0.1684  /* 1 - SLEEP_TIME / TARGET_STEP, in the workshop */
+#define SPIN_MARGIN      50000  /* ns, of the other sample_time_stamp programs */
+
+#define USAGE "Usage is: ./sample_time_stamp_adaptive_01 [-p period_us] [-n n_channels] [-t seconds] [-m miss_rate]\n"
+
+/* function templates */
+static void take_sample(struct sampler_engine *se, int channel, int64_t time_value, void *arg);
+static void run(const char *name, long n_channels, int64_t period, double seconds, int64_t spin_ns, struct sleep_margin *sm);
+static int  compare_int64(const void *a, const void *b);
+static void error_exit(char *s);
+
+int main(int argc, char *argv[])
+{
+    struct sleep_margin sm;
+    long    period_us = 10000;
+    long    n_channels = 1;
+    double  seconds = 5.0;
+    double  miss_rate = 0.01;
+    int64_t period;
+    int     opt;
+
+    while((opt = getopt(argc, argv, "p:n:t:m:")) != -1)
+        switch(opt)
+            {
+            case 'p':
+                period_us = atol(optarg);
+                break;
+            case 'n':
+                n_channels = atol(optarg);
+                break;
+            case 't':
+                seconds = atof(optarg);
+                break;
+            case 'm':
+                miss_rate = atof(optarg);
+                break;
+            default:
+                fprintf(stderr, USAGE);
+                return EXIT_FAILURE;
+            }
+    if((period_us < 1) || (n_channels < 1) || (n_channels > SE_MAX_CHANNELS) || (seconds <= 0.0)
+            || (miss_rate <= 0.0) || (miss_rate >= 1.0))
+        {
+            fprintf(stderr, USAGE);
+            return EXIT_FAILURE;
+        }
+    period = (int64_t) period_us * 1000;
+
+    printf("%ld channels, every %ld us, for %.1f s each run\n\n", n_channels, period_us, seconds);
+    printf("%-10s %10s %8s %14s %10s %10s %10s %10s %8s\n", "margin", "margin ns", "samples", "late wake-ups",
+           "50%", "99%", "99.9%", "max", "spin %");
+
+    run("workshop", n_channels, period, seconds, (int64_t) (WORKSHOP_MARGIN * (double) period), NULL);
+    run("fixed", n_channels, period, seconds, SPIN_MARGIN, NULL);
+    sm_init(&sm, miss_rate, SPIN_MARGIN);
+    run("adaptive", n_channels, period, seconds, 0, &sm);
+
+    printf("\n");
+    sm_report(&sm, stdout);
+    return 0;
+}
+
+/*-----------------------------------------------------------------------------*/
+
+/* one run, with a fixed margin of spin_ns, or an adaptive one, and a line of the table */
+static void run(const char *name, long n_channels, int64_t period, double seconds, int64_t spin_ns, struct sleep_margin *sm)
+{
+    static struct sampler_engine se;
+    int64_t *x;
+    long     n = 0, k;
+    int      c;
+
+    se_init(&se, MAX_RECORDS);
+    se.spin_ns = spin_ns;
+    se.margin  = sm;
+    for (c=0; c<n_channels; c++)
+        if(se_add_channel(&se, period, period + c * period / n_channels, take_sample, NULL) != c)
+            error_exit("the channel could not be added");
+    (void) se_run(&se, (int64_t) (seconds * 1e9));
+
+    /* the lateness of every channel, together */
+    x = (int64_t *) malloc((size_t) n_channels * MAX_RECORDS * sizeof(int64_t));
+    if(x == NULL) error_exit("out of memory");
+    for (c=0; c<n_channels; c++)
+        for (k=0; (k < se.channel[c].n_samples) && (k < MAX_RECORDS); k++)
+            x[n++] = se.channel[c].lateness[k];
+    if(n == 0) error_exit("no samples");
+    qsort(x, (size_t) n, sizeof(int64_t), compare_int64);
+
+    printf("%-10s %10ld %8ld %13.2f%% %10ld %10ld %10ld %10ld %7.3f%%\n", name,
+           (long) ((sm != NULL) ? sm_margin(sm) : spin_ns), n,
+           100.0 * (double) se.n_late_wakeups / (double) (se.n_sleeps > 0 ? se.n_sleeps : 1),
+           (long) x[(long) (0.50 * (double) (n-1) + 0.5)], (long) x[(long) (0.99 * (double) (n-1) + 0.5)],
+           (long) x[(long) (0.999 * (double) (n-1) + 0.5)], (long) x[n-1],
+           100.0 * (double) se.spin_total_ns / (double) (se.run_ns > 0 ? se.run_ns : 1));
+    fflush(stdout);
+
+    free(x);
+    se_free(&se);
+}
+
+/*-----------------------------------------------------------------------------*/
+
+/* the sample itself is not the point, here */
+static void take_sample(struct sampler_engine *se, int channel, int64_t time_value, void *arg)
+{
+    (void) se;
+    (void) channel;
+    (void) time_value;
+    (void) arg;
+}
+
+/*-----------------------------------------------------------------------------*/
+
+static int compare_int64(const void *a, const void *b)
+{
+    int64_t x = *(const int64_t *) a;
+    int64_t y = *(const int64_t *) b;
+
+    return (x > y) - (x < y);
+}
+
+/*-----------------------------------------------------------------------------*/
+
+/* A standard formatter for printing eror messages, and exiting */
+static void error_exit(char *s)
+{
+    fprintf(stderr, "\nerror: %s - bye!\n",s);
+    exit(1);
+}
@@ -0,0 +1,220 @@
+/* sample_time_stamp_flight_recorder_01.c */
+
+/*
+   The sampler of sample_time_stamp_and_queue_workshop_03_problems.c, as a flight recorder.
+
+   There, when queue_store[] fills, add_list_item() returns 1, and the sampler breaks out of its loop,
+   and stops sampling for good. Here the queue is a ring buffer in flight-recorder mode (see ring_buffer.c):
+   when it is full, each new sample overwrites the oldest, in O(1), and the samples lost are counted.
+   The sampler runs for as long as it is left to, in the same, fixed, amount of memory,
+   and the queue always holds the latest samples.
+
+   A snapshot of the latest samples is printed on demand, when the process is sent SIGUSR1,
+   and, with -t, every so many samples. Ctrl-C, SIGINT, stops the sampler, with a last snapshot.
+   The signal handlers only set a flag, the sampler looks at it between samples.
+
+   The targets never drift (PROBLEM #2): the sampler sleeps until a little before each one,
+   with clock_nanosleep(TIMER_ABSTIME), and busy-waits for the rest (PROBLEM #4).
+
+   Compilation advice:
+
+   gcc -std=gnu99 -Wall -Wextra -Werror -O2 -o sample_time_stamp_flight_recorder_01 sample_time_stamp_flight_recorder_01.c ring_buffer.c
+
+   An execution suggestion:
+
+   ./sample_time_stamp_flight_recorder_01 -n 100 -t 40
+   ./sample_time_stamp_flight_recorder_01 -p 1000 &
+   kill -USR1 %1
+   kill -INT %1
+
+   options:
+   -p period_us   (default 100000, as in the workshop)
+   -c capacity    of the queue, in samples (default 32)
+   -s snapshot    the number of samples in a snapshot (default 9)
+   -t every       also take a snapshot every so many samples (default 0, only on SIGUSR1)
+   -n n_samples   stop after this many (default 0, for ever)
+
+   Times are in nanoseconds.
+*/
+
+#include <stdio.h>     /* needed for printf() */
+#include <stdlib.h>
+#include <stdint.h>    /* defines some types, including: int64_t */
+#include <errno.h>     /* needed for EINTR */
+#include <signal.h>    /* needed for sigaction() */
+#include <time.h>      /* needed for clock_gettime(), clock_nanosleep() and CLOCK_MONOTONIC */
+#include <unistd.h>    /* needed for getopt() */
+
+#include "ring_buffer.h"
+
+#define SPIN_MARGIN 50000  /* ns, the sampler wakes this long before each target, and busy-waits */
+
+#define USAGE "Usage is: ./sample_time_stamp_flight_recorder_01 [-p period_us] [-c capacity] [-s snapshot] [-t every] [-n n_samples]\n"
+
+/* Set up structures for the starting and stopping times */
+static struct timespec start;
+
+/* set by the signal handlers, and looked at by the sampler between samples */
+static volatile sig_atomic_t snapshot_wanted = 0;
+static volatile sig_atomic_t stop_wanted     = 0;
+
+/* We are free to define the items that will be in a queue_item */
+typedef struct
+{
+    int64_t time_value;
+    int     sample_value;
+    int     sequence;
+} queue_item;
+
+/* function templates */
+static int64_t elapsed_time(void);
+static void    sleep_until(int64_t target);
+static void    print_snapshot(const struct ring_buffer *rb, queue_item *snapshot, size_t n, long n_taken);
+static void    on_signal(int signal_number);
+static void    error_exit(char *s);
+
+int main(int argc, char *argv[])
+{
+    struct ring_buffer rb;
+    struct sigaction   sa;
+    queue_item  item;
+    queue_item *snapshot;
+    long    period_us = 100000;
+    long    capacity  = 32;
+    long    n_snapshot = 9;
+    long    every     = 0;
+    long    n_samples = 0;
+    long    k;
+    int64_t target_time;
+    int     opt;
+
+    while((opt = getopt(argc, argv, "p:c:s:t:n:")) != -1)
+        switch(opt)
+            {
+            case 'p':
+                period_us = atol(optarg);
+                break;
+            case 'c':
+                capacity = atol(optarg);
+                break;
+            case 's':
+                n_snapshot = atol(optarg);
+                break;
+            case 't':
+                every = atol(optarg);
+                break;
+            case 'n':
+                n_samples = atol(optarg);
+                break;
+            default:
+                fprintf(stderr, USAGE);
+                return EXIT_FAILURE;
+            }
+    if((period_us < 1) || (capacity < 1) || (n_snapshot < 1) || (every < 0) || (n_samples < 0))
+        {
+            fprintf(stderr, USAGE);
+            return EXIT_FAILURE;
+        }
+
+    /* all of the memory, for as long as it runs */
+    if(rb_init(&rb, sizeof(queue_item), (size_t) capacity) != 0) error_exit("out of memory for the queue");
+    rb_set_overwrite(&rb, 1);
+    snapshot = (queue_item *) malloc((size_t) n_snapshot * sizeof(queue_item));
+    if(snapshot == NULL) error_exit("out of memory for the snapshot");
+
+    sigemptyset(&sa.sa_mask);
+    sa.sa_flags   = 0;
+    sa.sa_handler = on_signal;
+    if((sigaction(SIGUSR1, &sa, NULL) != 0) || (sigaction(SIGINT, &sa, NULL) != 0)) error_exit("no signal handlers");
+
+    printf("sampling every %ld us, the latest %ld kept, pid %ld\n", period_us, (long) rb.capacity, (long) getpid());
+    fflush(stdout);
+
+    srand((unsigned) time(NULL));
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    target_time = 0;
+    for (k=0; (n_samples == 0) || (k < n_samples); k++)
+        {
+            target_time += (int64_t) period_us * 1000; /* never from "now", so the targets do not drift */
+
+            sleep_until(target_time - SPIN_MARGIN);
+            if(stop_wanted) break;
+            while (elapsed_time() < target_time); /* busy-wait for the rest */
+
+            item.time_value   = elapsed_time();
+            item.sample_value = rand();
+            item.sequence     = (int) k;
+            (void) RB_PUT(&rb, &item); /* never full, the oldest makes way */
+
+            if((every > 0) && ((k+1) % every == 0)) snapshot_wanted = 1;
+            if(snapshot_wanted)
+                {
+                    snapshot_wanted = 0;
+                    print_snapshot(&rb, snapshot, (size_t) n_snapshot, k+1);
+                }
+        }
+
+    print_snapshot(&rb, snapshot, (size_t) n_snapshot, k);
+    free(snapshot);
+    rb_free(&rb);
+    return 0;
+}
+
+/*-----------------------------------------------------------------------------*/
+
+/* the number of nanoseconds since the start */
+static int64_t elapsed_time(void)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (int64_t) (now.tv_sec - start.tv_sec) * 1000000000 + (now.tv_nsec - start.tv_nsec);
+}
+
+/*-----------------------------------------------------------------------------*/
+
+/* sleep until target ns after the start, or until a signal arrives */
+static void sleep_until(int64_t target)
+{
+    struct timespec t;
+    int64_t ns = (int64_t) start.tv_sec * 1000000000 + start.tv_nsec + target;
+
+    t.tv_sec  = (time_t) (ns / 1000000000);
+    t.tv_nsec = (long) (ns % 1000000000);
+    while((clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &t, NULL) == EINTR) && !stop_wanted);
+}
+
+/*-----------------------------------------------------------------------------*/
+
+/* The latest samples, newest first, as print_list_items() does, and how many have been lost */
+static void print_snapshot(const struct ring_buffer *rb, queue_item *snapshot, size_t n, long n_taken)
+{
+    size_t n_copied = rb_snapshot(rb, snapshot, n);
+    size_t i;
+
+    printf("after %ld samples, %ld overwritten, the latest %ld are: (sequence,time_value,sample_value) :\n{\n",
+           n_taken, rb->n_overwritten, (long) n_copied);
+    for (i=n_copied; i>0; i--)
+        printf("   (%d,%ld,%d)\n", snapshot[i-1].sequence, (long) snapshot[i-1].time_value, snapshot[i-1].sample_value);
+    printf("}\n");
+    fflush(stdout);
+}
+
+/*-----------------------------------------------------------------------------*/
+
+static void on_signal(int signal_number)
+{
+    if(signal_number == SIGUSR1)
+        snapshot_wanted = 1;
+    else
+        stop_wanted = 1;
+}
+
+/*-----------------------------------------------------------------------------*/
+
+/* A standard formatter for printing eror messages, and exiting */
+static void error_exit(char *s)
+{
+    fprintf(stderr, "\nerror: %s - bye!\n",s);
+    exit(1);
+}
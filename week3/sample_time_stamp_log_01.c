@@ -0,0 +1,196 @@
+/* sample_time_stamp_log_01.c */
+
+/*
+   The sampler of sample_time_stamp_and_queue_workshop_03_problems.c, writing to a log that survives it.
+
+   There, the samples are kept in queue_store[], and printed by print_list_items() at the very end,
+   so a process that dies on the way takes all of its samples with it. Here each sample is appended
+   to a sample log (see sample_log.c), a ring of records in a memory-mapped file, as it is taken.
+   An append is a few stores into memory, and no system call, but it is committed to the file as soon
+   as it is made, so whatever happens to the process afterwards, sample_log_recover can read back
+   every sample up to the last one committed.
+
+   -k makes the sampler abort() itself, part way through, to show this. Run it again on the same
+   log and it carries on from where the log was left, as a new run.
+
+   The time that each append takes is measured, and reported at the end, if there is an end.
+
+   The targets never drift (PROBLEM #2): the sampler sleeps until a little before each one,
+   with clock_nanosleep(TIMER_ABSTIME), and busy-waits for the rest (PROBLEM #4).
+
+   Compilation advice:
+
+   gcc -std=gnu99 -Wall -Wextra -Werror -O2 -o sample_time_stamp_log_01 sample_time_stamp_log_01.c sample_log.c
+
+   An execution suggestion:
+
+   ./sample_time_stamp_log_01 -f samples.log -n 20 -k 15
+   ./sample_log_recover samples.log
+
+   options:
+   -f log_file    (default samples.log)
+   -p period_us   (default 100000, as in the workshop)
+   -c capacity    of a new log, in samples (default 1024)
+   -n n_samples   stop after this many (default 9, as in the workshop, 0 for ever, or until Ctrl-C)
+   -k crash_at    abort() just after this many samples (default 0, never)
+   -s             msync() the log to the disk at the end
+
+   Times are in nanoseconds.
+*/
+
+#include <stdio.h>     /* needed for printf() */
+#include <stdlib.h>    /* needed for abort() */
+#include <stdint.h>    /* defines some types, including: int64_t */
+#include <errno.h>     /* needed for EINTR */
+#include <signal.h>    /* needed for sigaction() */
+#include <time.h>      /* needed for clock_gettime(), clock_nanosleep() and CLOCK_MONOTONIC */
+#include <unistd.h>    /* needed for getopt() */
+
+#include "sample_log.h"
+
+#define SPIN_MARGIN 50000  /* ns, the sampler wakes this long before each target, and busy-waits */
+
+#define USAGE "Usage is: ./sample_time_stamp_log_01 [-f log_file] [-p period_us] [-c capacity] [-n n_samples] [-k crash_at] [-s]\n"
+
+/* Set up structures for the starting and stopping times */
+static struct timespec start;
+
+/* set by the signal handler, and looked at by the sampler between samples */
+static volatile sig_atomic_t stop_wanted = 0;
+
+/* function templates */
+static int64_t elapsed_time(void);
+static void    sleep_until(int64_t target);
+static void    on_signal(int signal_number);
+static void    error_exit(char *s);
+
+int main(int argc, char *argv[])
+{
+    struct sample_log sl;
+    struct sigaction  sa;
+    const char *path = "samples.log";
+    long    period_us = 100000;
+    long    capacity  = 1024;
+    long    n_samples = 9;
+    long    crash_at  = 0;
+    int     sync_at_end = 0;
+    long    k;
+    int64_t target_time, time_value;
+    int64_t append_ns, sum_append = 0, max_append = 0;
+    int     opt;
+
+    while((opt = getopt(argc, argv, "f:p:c:n:k:s")) != -1)
+        switch(opt)
+            {
+            case 'f':
+                path = optarg;
+                break;
+            case 'p':
+                period_us = atol(optarg);
+                break;
+            case 'c':
+                capacity = atol(optarg);
+                break;
+            case 'n':
+                n_samples = atol(optarg);
+                break;
+            case 'k':
+                crash_at = atol(optarg);
+                break;
+            case 's':
+                sync_at_end = 1;
+                break;
+            default:
+                fprintf(stderr, USAGE);
+                return EXIT_FAILURE;
+            }
+    if((period_us < 1) || (capacity < 1) || (n_samples < 0) || (crash_at < 0))
+        {
+            fprintf(stderr, USAGE);
+            return EXIT_FAILURE;
+        }
+
+    if(sl_open(&sl, path, (size_t) capacity) != 0) error_exit("the log could not be opened");
+
+    sigemptyset(&sa.sa_mask);
+    sa.sa_flags   = 0;
+    sa.sa_handler = on_signal;
+    if(sigaction(SIGINT, &sa, NULL) != 0) error_exit("no signal handler");
+
+    printf("run %lu of %s, %lu samples in it already, the latest %lu kept\n", (unsigned long) sl.header->sequence,
+           path, (unsigned long) sl_write_index(&sl), (unsigned long) sl.capacity);
+    fflush(stdout);
+
+    srand((unsigned) time(NULL));
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    target_time = 0;
+    for (k=0; (n_samples == 0) || (k < n_samples); k++)
+        {
+            target_time += (int64_t) period_us * 1000; /* never from "now", so the targets do not drift */
+
+            sleep_until(target_time - SPIN_MARGIN);
+            if(stop_wanted) break;
+            while (elapsed_time() < target_time); /* busy-wait for the rest */
+
+            time_value = elapsed_time();
+            sl_append(&sl, time_value, (int32_t) rand());
+
+            append_ns   = elapsed_time() - time_value;
+            sum_append += append_ns;
+            if(append_ns > max_append) max_append = append_ns;
+
+            if((crash_at > 0) && (k+1 == crash_at))
+                {
+                    printf("aborting, after %ld samples\n", k+1);
+                    fflush(stdout);
+                    abort(); /* no clean-up, no sl_close(), nothing */
+                }
+        }
+
+    printf("%ld samples appended, %lu in the log, append: mean %ld ns, max %ld ns\n", k,
+           (unsigned long) sl_write_index(&sl), (long) (k > 0 ? sum_append / k : 0), (long) max_append);
+    if(sync_at_end && (sl_sync(&sl) != 0)) error_exit("the log could not be written to the disk");
+    sl_close(&sl);
+    return 0;
+}
+
+/*-----------------------------------------------------------------------------*/
+
+/* the number of nanoseconds since the start */
+static int64_t elapsed_time(void)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (int64_t) (now.tv_sec - start.tv_sec) * 1000000000 + (now.tv_nsec - start.tv_nsec);
+}
+
+/*-----------------------------------------------------------------------------*/
+
+/* sleep until target ns after the start, or until a signal arrives */
+static void sleep_until(int64_t target)
+{
+    struct timespec t;
+    int64_t ns = (int64_t) start.tv_sec * 1000000000 + start.tv_nsec + target;
+
+    t.tv_sec  = (time_t) (ns / 1000000000);
+    t.tv_nsec = (long) (ns % 1000000000);
+    while((clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &t, NULL) == EINTR) && !stop_wanted);
+}
+
+/*-----------------------------------------------------------------------------*/
+
+static void on_signal(int signal_number)
+{
+    (void) signal_number;
+    stop_wanted = 1;
+}
+
+/*-----------------------------------------------------------------------------*/
+
+/* A standard formatter for printing eror messages, and exiting */
+static void error_exit(char *s)
+{
+    fprintf(stderr, "\nerror: %s - bye!\n",s);
+    exit(1);
+}
@@ -0,0 +1,189 @@
+/* sample_time_stamp_multi_01.c */
+
+/*
+   The sampler of sample_time_stamp_and_queue_workshop_03_problems.c, for many channels at once, in one thread.
+
+   Each channel has its own period, 1 ms to 1 s, and a phase, so that they do not all fall due together,
+   and keeps its samples in a sample store of its own (see sample_store.c). The sampler engine
+   (see sampler_engine.c) fires them in due order, from a min-heap, sleeping with
+   clock_nanosleep(TIMER_ABSTIME) in between, and busy-waiting the last part before each one,
+   for a margin that tunes itself to the overshoot of the sleeps (see sleep_margin.c), or, with -s, a fixed one.
+
+   At the end, the engine's table of lateness is printed, and then, from each channel's samples,
+   the mean interval between them, against its period, which is 0 if nothing drifts, the jitter,
+   and how late the last sample was, which is no later than the first, however long the run.
+
+   Compilation advice:
+
+   gcc -std=gnu99 -Wall -Wextra -Werror -O2 -o sample_time_stamp_multi_01 sample_time_stamp_multi_01.c sampler_engine.c sleep_margin.c sample_store.c -lm
+
+   An execution suggestion:
+
+   ./sample_time_stamp_multi_01 -n 24 -t 10
+
+   options:
+   -n n_channels  (default 24, at most 64)
+   -t seconds     to run for (default 5), Ctrl-C stops it sooner
+   -s spin_us     busy-wait this long before each due time, rather than for the adaptive margin
+                  (0 to sleep all the way)
+   -m miss_rate   the adaptive margin aims at (default 0.01)
+
+   Times are in nanoseconds.
+*/
+
+#include <stdio.h>     /* needed for printf() */
+#include <stdlib.h>
+#include <stdint.h>    /* defines some types, including: int64_t */
+#include <signal.h>    /* needed for sigaction() */
+#include <time.h>      /* needed for time() */
+#include <unistd.h>    /* needed for getopt() */
+
+#include "sampler_engine.h"
+#include "sample_store.h"
+#include "sleep_margin.h"
+
+#define MAX_RECORDS 100000  /* lateness records, for each channel */
+
+#define USAGE "Usage is: ./sample_time_stamp_multi_01 [-n n_channels] [-t seconds] [-s spin_us | -m miss_rate]\n"
+
+/* the periods of the channels, in us, in turn */
+static const int64_t period_us[8] = { 1000, 2000, 5000, 10000, 20000, 50000, 100000, 1000000 };
+
+/* for the signal handler */
+static struct sampler_engine *engine = NULL;
+
+/* function templates */
+static void take_sample(struct sampler_engine *se, int channel, int64_t time_value, void *arg);
+static void on_signal(int signal_number);
+static void error_exit(char *s);
+
+int main(int argc, char *argv[])
+{
+    static struct sampler_engine se;
+    static struct sample_store   ss[SE_MAX_CHANNELS];
+    struct ss_interval_stats stats;
+    struct sigaction sa;
+    struct sleep_margin sm;
+    const struct se_channel *ch;
+    long    n_channels = 24;
+    double  seconds = 5.0;
+    long    spin_us = -1;  /* the adaptive margin */
+    double  miss_rate = 0.01;
+    int64_t period, last_late;
+    long    n_last;
+    int     c, opt;
+
+    while((opt = getopt(argc, argv, "n:t:s:m:")) != -1)
+        switch(opt)
+            {
+            case 'n':
+                n_channels = atol(optarg);
+                break;
+            case 't':
+                seconds = atof(optarg);
+                break;
+            case 's':
+                spin_us = atol(optarg);
+                if(spin_us < 0)
+                    {
+                        fprintf(stderr, USAGE);
+                        return EXIT_FAILURE;
+                    }
+                break;
+            case 'm':
+                miss_rate = atof(optarg);
+                break;
+            default:
+                fprintf(stderr, USAGE);
+                return EXIT_FAILURE;
+            }
+    if((n_channels < 1) || (n_channels > SE_MAX_CHANNELS) || (seconds <= 0.0) || (miss_rate <= 0.0) || (miss_rate >= 1.0))
+        {
+            fprintf(stderr, USAGE);
+            return EXIT_FAILURE;
+        }
+
+    se_init(&se, MAX_RECORDS);
+    if(spin_us >= 0)
+        se.spin_ns = (int64_t) spin_us * 1000;
+    else
+        {
+            sm_init(&sm, miss_rate, SE_SPIN_NS);
+            se.margin = &sm;
+        }
+    for (c=0; c<n_channels; c++)
+        {
+            period = period_us[c % 8] * 1000;
+            /* every sample of the run, and a spare, so that the store never wraps */
+            if(ss_init(&ss[c], (size_t) (seconds * 1e9 / (double) period) + 2) != 0) error_exit("out of memory for the samples");
+            /* the phases spread the channels of each period across it */
+            if(se_add_channel(&se, period, (c / 8) * period / 8 + period, take_sample, &ss[c]) != c)
+                error_exit("the channel could not be added");
+        }
+
+    engine = &se;
+    sigemptyset(&sa.sa_mask);
+    sa.sa_flags   = 0;
+    sa.sa_handler = on_signal;
+    if(sigaction(SIGINT, &sa, NULL) != 0) error_exit("no signal handler");
+
+    srand((unsigned) time(NULL));
+    if(spin_us >= 0)
+        printf("%ld channels, for %.1f s, busy-waiting %ld us before each sample\n", n_channels, seconds, spin_us);
+    else
+        printf("%ld channels, for %.1f s, busy-waiting for a margin that aims at %.2f%% late wake-ups\n",
+               n_channels, seconds, 100.0 * miss_rate);
+    fflush(stdout);
+    (void) se_run(&se, (int64_t) (seconds * 1e9));
+
+    se_report(&se, stdout);
+
+    printf("\n%8s %12s %8s %18s %12s %14s\n", "channel", "period ns", "samples", "mean - period ns", "jitter ns", "last late ns");
+    for (c=0; c<n_channels; c++)
+        {
+            ch = &se.channel[c];
+            n_last = ch->n_samples - 1;
+            last_late = ((n_last >= 0) && ((size_t) n_last < se.max_records)) ? ch->lateness[n_last] : -1;
+            if((ch->n_skipped > 0) || (ss_interval_stats(&ss[c], ss_first(&ss[c]), ss[c].head - ss_first(&ss[c]), &stats) != 0))
+                {
+                    /* a skip leaves a double interval, so the mean and the jitter would mean little */
+                    printf("%8d %12ld %8ld %18s %12s %14ld\n", c, (long) ch->period, ch->n_samples, "-", "-", (long) last_late);
+                    continue;
+                }
+            printf("%8d %12ld %8ld %18.3f %12.1f %14ld\n", c, (long) ch->period, ch->n_samples,
+                   stats.mean - (double) ch->period, stats.jitter, (long) last_late);
+        }
+
+    for (c=0; c<n_channels; c++) ss_free(&ss[c]);
+    se_free(&se);
+    return 0;
+}
+
+/*-----------------------------------------------------------------------------*/
+
+/* one sample, of one channel, into that channel's store */
+static void take_sample(struct sampler_engine *se, int channel, int64_t time_value, void *arg)
+{
+    struct sample_store *ss = (struct sample_store *) arg;
+
+    (void) se;
+    (void) channel;
+    ss_put(ss, time_value, rand());
+}
+
+/*-----------------------------------------------------------------------------*/
+
+static void on_signal(int signal_number)
+{
+    (void) signal_number;
+    if(engine != NULL) se_stop(engine);
+}
+
+/*-----------------------------------------------------------------------------*/
+
+/* A standard formatter for printing eror messages, and exiting */
+static void error_exit(char *s)
+{
+    fprintf(stderr, "\nerror: %s - bye!\n",s);
+    exit(1);
+}
@@ -0,0 +1,273 @@
+/* sample_time_stamp_spsc_01.c */
+
+/*
+   The sampler of sample_time_stamp_and_queue_workshop_03_problems.c, with a consumer running
+   beside it, rather than a print of the whole queue at the end.
+
+   The sampler, in the main thread, takes a time stamp and a (random) sample once every period,
+   and puts it into a lock-free single-producer, single-consumer queue (see spsc_queue.c).
+   A consumer thread takes the samples out, in batches, as they arrive, works out the interval
+   since the one before, and writes each out, while the sampling goes on.
+
+   The sampler never waits for the consumer: if the queue is full, the sample is dropped, and counted.
+   With -s, the consumer is made artificially slow, and with -c the queue is made small,
+   to show that the sampler's timing does not suffer, only the number of samples dropped.
+
+   The consumer runs at SCHED_IDLE, so that, when the two threads share a processor,
+   it only runs when the sampler is asleep, and never delays a sample.
+
+   The sampler sleeps until a little before each target time, with clock_nanosleep(TIMER_ABSTIME),
+   so that the targets do not drift (PROBLEM #2), and busy-waits for the rest (PROBLEM #4).
+
+   Compilation advice:
+
+   gcc -std=gnu99 -Wall -Wextra -Werror -O2 -o sample_time_stamp_spsc_01 sample_time_stamp_spsc_01.c spsc_queue.c -pthread
+
+   An execution suggestion:
+
+   ./sample_time_stamp_spsc_01 -n 20
+   ./sample_time_stamp_spsc_01 -n 5000 -p 200 -o samples.txt
+   ./sample_time_stamp_spsc_01 -n 5000 -p 200 -c 16 -s 1000 -o samples.txt
+
+   options:
+   -n n_samples   (default 1000)
+   -p period_us   (default 1000)
+   -c capacity    of the queue, in samples (default 1024)
+   -s delay_us    extra processing time, per sample, in the consumer (default 0)
+   -o file        where the consumer writes the samples (default stdout)
+
+   Times are in nanoseconds.
+*/
+
+#define _GNU_SOURCE    /* needed for SCHED_IDLE */
+
+#include <stdio.h>     /* needed for printf() */
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>    /* defines some types, including: int64_t */
+#include <errno.h>     /* needed for EINTR */
+#include <time.h>      /* needed for clock_gettime(), clock_nanosleep() and CLOCK_MONOTONIC */
+#include <sched.h>     /* needed for SCHED_IDLE */
+#include <unistd.h>    /* needed for usleep() and getopt() */
+#include <pthread.h>
+
+#include "spsc_queue.h"
+
+#define SPIN_MARGIN  50000  /* ns, the sampler wakes this long before each target, and busy-waits */
+#define BATCH           64  /* samples taken by the consumer at a time */
+#define CONSUMER_NAP   500  /* us, how long the consumer sleeps when the queue is empty */
+
+#define USAGE "Usage is: ./sample_time_stamp_spsc_01 [-n n_samples] [-p period_us] [-c capacity] [-s delay_us] [-o file]\n"
+
+/* Set up structures for the starting and stopping times */
+static struct timespec start;
+
+/* One sample */
+typedef struct
+{
+    int64_t time_value;    /* when it was taken, ns since the start */
+    int     sample_value;
+    int     sequence;      /* so that the consumer can tell when some were dropped */
+} queue_item;
+
+/* everything the consumer thread needs */
+struct consumer
+{
+    struct spsc_queue *queue;
+    FILE              *fp;
+    int                delay_us;
+    int                done;          /* set by the sampler, when it has put its last sample */
+
+    /* what it found */
+    long               n_received;
+    long               n_gaps;        /* places where samples were dropped */
+    int64_t            min_interval;
+    int64_t            max_interval;
+    double             sum_values;
+};
+
+/* function templates */
+static int64_t elapsed_time(void);
+static void    sleep_until(int64_t target);
+static void   *consume(void *arg);
+static void    error_exit(char *s);
+
+int main(int argc, char *argv[])
+{
+    static struct spsc_queue queue; /* aligned to the cache lines */
+    struct consumer consumer;
+    pthread_t       thread;
+    queue_item      item;
+    int     n_samples = 1000;
+    int     period_us = 1000;
+    int     capacity  = 1024;
+    char   *file_name = NULL;
+    int64_t target_time;
+    int64_t lateness, max_lateness = 0;
+    int64_t t0, put_ns, max_put_ns = 0, sum_put_ns = 0;
+    int     opt;
+    int     k;
+
+    memset(&consumer, 0, sizeof(consumer));
+    while((opt = getopt(argc, argv, "n:p:c:s:o:")) != -1)
+        switch(opt)
+            {
+            case 'n':
+                n_samples = atoi(optarg);
+                break;
+            case 'p':
+                period_us = atoi(optarg);
+                break;
+            case 'c':
+                capacity = atoi(optarg);
+                break;
+            case 's':
+                consumer.delay_us = atoi(optarg);
+                break;
+            case 'o':
+                file_name = optarg;
+                break;
+            default:
+                fprintf(stderr, USAGE);
+                return EXIT_FAILURE;
+            }
+    if((n_samples < 1) || (period_us < 1) || (capacity < 1) || (consumer.delay_us < 0))
+        {
+            fprintf(stderr, USAGE);
+            return EXIT_FAILURE;
+        }
+
+    if(spsc_init(&queue, sizeof(queue_item), (size_t) capacity) != 0) error_exit("out of memory for the queue");
+    consumer.queue = &queue;
+    consumer.fp    = stdout;
+    if(file_name != NULL)
+        {
+            consumer.fp = fopen(file_name, "w");
+            if(consumer.fp == NULL) error_exit("unable to open the output file");
+        }
+    consumer.min_interval = INT64_MAX;
+
+    srand((unsigned) time(NULL));
+    if(pthread_create(&thread, NULL, consume, &consumer) != 0) error_exit("unable to start the consumer thread");
+
+    /* start the clock, and sample once every period, from one period after it */
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    target_time = 0;
+    for (k=0; k<n_samples; k++)
+        {
+            target_time += (int64_t) period_us * 1000; /* never from "now", so the targets do not drift */
+
+            sleep_until(target_time - SPIN_MARGIN);
+            while (elapsed_time() < target_time); /* and busy-wait for the rest */
+
+            item.time_value   = elapsed_time();
+            item.sample_value = rand();
+            item.sequence     = k;
+            lateness = item.time_value - target_time;
+            if(lateness > max_lateness) max_lateness = lateness;
+
+            /* this is all the time that the sampler gives to the queue, it never waits */
+            t0 = elapsed_time();
+            (void) spsc_put(&queue, &item);
+            put_ns = elapsed_time() - t0;
+            sum_put_ns += put_ns;
+            if(put_ns > max_put_ns) max_put_ns = put_ns;
+        }
+    __atomic_store_n(&consumer.done, 1, __ATOMIC_RELEASE);
+    (void) pthread_join(thread, NULL);
+    if(file_name != NULL) fclose(consumer.fp);
+
+    fprintf(stderr, "sampler:  %d samples, every %d us, latest %ld ns after its target\n",
+            n_samples, period_us, (long) max_lateness);
+    fprintf(stderr, "sampler:  time in spsc_put(), mean %ld ns, max %ld ns, samples dropped, the queue was full, %ld\n",
+            (long) (sum_put_ns / n_samples), (long) max_put_ns, queue.n_dropped);
+    fprintf(stderr, "consumer: %ld samples, %ld gaps, intervals from %ld to %ld ns, mean sample %.0f\n",
+            consumer.n_received, consumer.n_gaps, (long) consumer.min_interval, (long) consumer.max_interval,
+            consumer.sum_values / (double) (consumer.n_received > 0 ? consumer.n_received : 1));
+
+    spsc_free(&queue);
+    return 0;
+}
+
+/*-----------------------------------------------------------------------------*/
+
+/* the number of nanoseconds since the start */
+static int64_t elapsed_time(void)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (int64_t) (now.tv_sec - start.tv_sec) * 1000000000 + (now.tv_nsec - start.tv_nsec);
+}
+
+/*-----------------------------------------------------------------------------*/
+
+/* sleep until target ns after the start, on the same clock */
+static void sleep_until(int64_t target)
+{
+    struct timespec t;
+    int64_t ns = (int64_t) start.tv_sec * 1000000000 + start.tv_nsec + target;
+
+    t.tv_sec  = (time_t) (ns / 1000000000);
+    t.tv_nsec = (long) (ns % 1000000000);
+    while(clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &t, NULL) == EINTR); /* again, if interrupted */
+}
+
+/*-----------------------------------------------------------------------------*/
+
+/* The consumer thread: take whatever has arrived, process it, and write it out, until the sampler is done */
+static void *consume(void *arg)
+{
+    struct consumer *c = (struct consumer *) arg;
+    queue_item batch[BATCH];
+    int64_t    last_time = 0;
+    int        last_sequence = -1;
+    int        done;
+    size_t     n, i;
+    int64_t    interval;
+    struct sched_param sp;
+
+    memset(&sp, 0, sizeof(sp));
+    if(pthread_setschedparam(pthread_self(), SCHED_IDLE, &sp) != 0)
+        fprintf(stderr, "warning: the consumer thread could not be given a low priority\n");
+
+    while(1)
+        {
+            done = __atomic_load_n(&c->done, __ATOMIC_ACQUIRE); /* before looking, so that nothing is missed */
+            n = spsc_get_bulk(c->queue, batch, BATCH);
+            if(n == 0)
+                {
+                    if(done) break;
+                    (void) usleep(CONSUMER_NAP);
+                    continue;
+                }
+            for (i=0; i<n; i++)
+                {
+                    if(batch[i].sequence != last_sequence + 1) c->n_gaps++;
+                    if(last_sequence >= 0)
+                        {
+                            interval = batch[i].time_value - last_time;
+                            if(interval < c->min_interval) c->min_interval = interval;
+                            if(interval > c->max_interval) c->max_interval = interval;
+                        }
+                    last_time     = batch[i].time_value;
+                    last_sequence = batch[i].sequence;
+                    c->sum_values += batch[i].sample_value;
+                    c->n_received++;
+
+                    fprintf(c->fp, "   (%ld,%d)\n", (long) batch[i].time_value, batch[i].sample_value);
+                    if(c->delay_us > 0) (void) usleep((useconds_t) c->delay_us); /* a slow consumer */
+                }
+        }
+    if(c->min_interval == INT64_MAX) c->min_interval = 0;
+    return NULL;
+}
+
+/*-----------------------------------------------------------------------------*/
+
+/* A standard formatter for printing eror messages, and exiting */
+static void error_exit(char *s)
+{
+    fprintf(stderr, "\nerror: %s - bye!\n",s);
+    exit(1);
+}
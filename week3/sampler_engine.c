@@ -0,0 +1,263 @@
+/* sampler_engine.c */
+
+/* Many periodic sampling channels, in one thread, fired in due order from a min-heap, see sampler_engine.h */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>     /* needed for EINTR */
+#include <time.h>      /* needed for clock_gettime(), clock_nanosleep() and CLOCK_MONOTONIC */
+
+#include "sampler_engine.h"
+
+/* function templates, for local helpers */
+static int  sooner(const struct sampler_engine *se, int a, int b);
+static void sift_up(struct sampler_engine *se, int i);
+static void sift_down(struct sampler_engine *se, int i);
+static void wait_until(struct sampler_engine *se, int64_t target);
+static int  compare_int64(const void *a, const void *b);
+
+/*-----------------------------------------------------------------------------*/
+
+void se_init(struct sampler_engine *se, size_t max_records)
+{
+    memset(se, 0, sizeof(*se));
+    se->max_records = max_records;
+    se->spin_ns     = SE_SPIN_NS;
+}
+
+/*-----------------------------------------------------------------------------*/
+
+void se_free(struct sampler_engine *se)
+{
+    int c;
+
+    for (c=0; c<se->n_channels; c++)
+        {
+            free(se->channel[c].lateness);
+            se->channel[c].lateness = NULL;
+        }
+}
+
+/*-----------------------------------------------------------------------------*/
+
+int se_add_channel(struct sampler_engine *se, int64_t period, int64_t phase, se_sample_function sample, void *arg)
+{
+    struct se_channel *ch;
+    int c = se->n_channels;
+
+    if((c == SE_MAX_CHANNELS) || (period < 1) || (phase < 0))
+        {
+            fprintf(stderr, "se_add_channel(): at most %d channels, each with a period of at least 1 ns\n", SE_MAX_CHANNELS);
+            return -1;
+        }
+
+    ch = &se->channel[c];
+    memset(ch, 0, sizeof(*ch));
+    ch->period   = period;
+    ch->phase    = phase;
+    ch->sample   = sample;
+    ch->arg      = arg;
+    ch->next_due = phase;
+    if(se->max_records > 0)
+        {
+            /* allocate, and touch, the records now, so that no page fault lands on a sample */
+            ch->lateness = (int64_t *) calloc(se->max_records, sizeof(int64_t));
+            if(ch->lateness == NULL)
+                {
+                    fprintf(stderr, "se_add_channel(): out of memory\n");
+                    return -1;
+                }
+            memset(ch->lateness, 0, se->max_records * sizeof(int64_t));
+        }
+
+    se->heap[c] = c;
+    se->n_channels++;
+    sift_up(se, c);
+    return c;
+}
+
+/*-----------------------------------------------------------------------------*/
+
+int se_run(struct sampler_engine *se, int64_t duration)
+{
+    struct se_channel *ch;
+    int64_t now;
+    int     c;
+
+    if(se->n_channels == 0) return 1;
+    se->stop_wanted = 0;
+    clock_gettime(CLOCK_MONOTONIC, &se->start);
+
+    while(!se->stop_wanted)
+        {
+            c  = se->heap[0];
+            ch = &se->channel[c];
+            if(ch->next_due >= duration) break;
+
+            wait_until(se, ch->next_due);
+            if(se->stop_wanted) break;
+
+            now = se_elapsed_time(se);
+            if((size_t) ch->n_samples < se->max_records) ch->lateness[ch->n_samples] = now - ch->next_due;
+            ch->n_samples++;
+            ch->sample(se, c, now, ch->arg);
+
+            /* the next due time, from the phase, and never from now, so that lateness does not build up */
+            ch->k++;
+            now = se_elapsed_time(se);
+            while(ch->phase + (ch->k + 1) * ch->period <= now)
+                {
+                    ch->k++;
+                    ch->n_skipped++;
+                }
+            ch->next_due = ch->phase + ch->k * ch->period;
+            sift_down(se, 0);
+        }
+
+    se->run_ns = se_elapsed_time(se);
+    return 0;
+}
+
+/*-----------------------------------------------------------------------------*/
+
+void se_stop(struct sampler_engine *se)
+{
+    se->stop_wanted = 1;
+}
+
+/*-----------------------------------------------------------------------------*/
+
+int64_t se_elapsed_time(const struct sampler_engine *se)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (int64_t) (now.tv_sec - se->start.tv_sec) * 1000000000 + (now.tv_nsec - se->start.tv_nsec);
+}
+
+/*-----------------------------------------------------------------------------*/
+
+void se_report(const struct sampler_engine *se, FILE *fp)
+{
+    static const double level[3] = { 0.50, 0.99, 0.999 };
+    const struct se_channel *ch;
+    int64_t *x;
+    int64_t  sum;
+    long     n, k;
+    int      c, j;
+
+    x = (int64_t *) malloc((se->max_records > 0 ? se->max_records : 1) * sizeof(int64_t));
+    if(x == NULL) return;
+
+    fprintf(fp, "%8s %12s %8s %8s %10s %10s %10s %10s %10s %10s\n", "channel", "period ns", "samples", "skipped",
+            "min", "mean", "50%", "99%", "99.9%", "max");
+    for (c=0; c<se->n_channels; c++)
+        {
+            ch = &se->channel[c];
+            n  = ((size_t) ch->n_samples < se->max_records) ? ch->n_samples : (long) se->max_records;
+            fprintf(fp, "%8d %12ld %8ld %8ld", c, (long) ch->period, ch->n_samples, ch->n_skipped);
+            if(n == 0)
+                {
+                    fprintf(fp, "\n");
+                    continue;
+                }
+            memcpy(x, ch->lateness, (size_t) n * sizeof(int64_t));
+            qsort(x, (size_t) n, sizeof(int64_t), compare_int64);
+            for (sum=0, k=0; k<n; k++) sum += x[k];
+
+            fprintf(fp, " %10ld %10ld", (long) x[0], (long) (sum / n));
+            for (j=0; j<3; j++) fprintf(fp, " %10ld", (long) x[(long) (level[j] * (double) (n-1) + 0.5)]);
+            fprintf(fp, " %10ld\n", (long) x[n-1]);
+        }
+    fprintf(fp, "lateness, in ns, of the first %ld samples of each channel, over a run of %.3f s\n",
+            (long) se->max_records, (double) se->run_ns / 1e9);
+    fprintf(fp, "busy-waiting for %.3f%% of the run, %ld of %ld sleeps woke after the due time\n",
+            100.0 * (double) se->spin_total_ns / (double) (se->run_ns > 0 ? se->run_ns : 1),
+            se->n_late_wakeups, se->n_sleeps);
+    if(se->margin != NULL) sm_report(se->margin, fp);
+    free(x);
+}
+
+/*-----------------------------------------------------------------------------*/
+
+/* is channel a due before channel b? Ties go to the channel added first */
+static int sooner(const struct sampler_engine *se, int a, int b)
+{
+    if(se->channel[a].next_due != se->channel[b].next_due)
+        return se->channel[a].next_due < se->channel[b].next_due;
+    return a < b;
+}
+
+/*-----------------------------------------------------------------------------*/
+
+static void sift_up(struct sampler_engine *se, int i)
+{
+    int parent, t;
+
+    while(i > 0)
+        {
+            parent = (i - 1) / 2;
+            if(!sooner(se, se->heap[i], se->heap[parent])) break;
+            t = se->heap[i];
+            se->heap[i] = se->heap[parent];
+            se->heap[parent] = t;
+            i = parent;
+        }
+}
+
+/*-----------------------------------------------------------------------------*/
+
+static void sift_down(struct sampler_engine *se, int i)
+{
+    int child, t;
+
+    while((child = 2*i + 1) < se->n_channels)
+        {
+            if((child + 1 < se->n_channels) && sooner(se, se->heap[child + 1], se->heap[child])) child++;
+            if(!sooner(se, se->heap[child], se->heap[i])) break;
+            t = se->heap[i];
+            se->heap[i] = se->heap[child];
+            se->heap[child] = t;
+            i = child;
+        }
+}
+
+/*-----------------------------------------------------------------------------*/
+
+/* sleep until the margin before target, ns since the start, then busy-wait for the rest */
+static void wait_until(struct sampler_engine *se, int64_t target)
+{
+    struct timespec t;
+    int64_t wake = target - ((se->margin != NULL) ? sm_margin(se->margin) : se->spin_ns);
+    int64_t ns   = (int64_t) se->start.tv_sec * 1000000000 + se->start.tv_nsec + wake;
+    int64_t now  = se_elapsed_time(se);
+    int64_t spin_start;
+
+    if(wake > now)
+        {
+            t.tv_sec  = (time_t) (ns / 1000000000);
+            t.tv_nsec = (long) (ns % 1000000000);
+            while((clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &t, NULL) == EINTR) && !se->stop_wanted);
+
+            now = se_elapsed_time(se);
+            se->n_sleeps++;
+            if(now > target) se->n_late_wakeups++;
+            if((se->margin != NULL) && !se->stop_wanted) sm_update(se->margin, now - wake);
+        }
+
+    spin_start = now;
+    while((now < target) && !se->stop_wanted) now = se_elapsed_time(se);
+    se->spin_total_ns += now - spin_start;
+}
+
+/*-----------------------------------------------------------------------------*/
+
+static int compare_int64(const void *a, const void *b)
+{
+    int64_t x = *(const int64_t *) a;
+    int64_t y = *(const int64_t *) b;
+
+    return (x > y) - (x < y);
+}
+/*-----------------------------------------------------------------------------*/
@@ -0,0 +1,102 @@
+/* sampler_engine.h */
+
+/* Many periodic sampling channels, each at its own rate, in one thread.
+
+   The sampler of the workshop has one rate, TARGET_STEP, and waits for it with a usleep() of a
+   hand-picked SLEEP_TIME, and a busy-wait. Here each channel has its own period, and a phase,
+   and a function that takes its sample, and the engine keeps the channels in a min-heap,
+   ordered by the time that each is next due, so the next to fire is always at the top.
+
+   The engine sleeps with clock_nanosleep(TIMER_ABSTIME) until spin_ns before the top channel
+   is due, busy-waits the rest, and fires it, then moves it on to its next due time, and back down
+   the heap. Channels that fall due at the same time fire in the order they were added.
+
+   A due time is never counted from when a sample was actually taken, only from the channel's
+   phase, as phase + k * period, so a late sample does not make the next one late, and no channel
+   drifts, however long it runs. A channel that is still late by a whole period, after its sample,
+   skips the due times that have already passed, and they are counted, rather than firing
+   several samples in a burst, to catch up.
+
+   The lateness of every sample, when it fired against when it was due, is recorded,
+   for the first max_records samples of each channel, and se_report() prints its percentiles,
+   and the fraction of the run that was spent busy-waiting.
+
+   The margin before each due time is spin_ns, fixed, unless margin points to a sleep_margin
+   (see sleep_margin.h), which is then told the overshoot of every sleep, and sets the margin
+   from it, as short as it can be for the miss rate it aims at.
+
+   se_stop() may be called from a sample function, or a signal handler. */
+
+#ifndef SAMPLER_ENGINE_H
+#define SAMPLER_ENGINE_H
+
+#include <stdio.h>
+#include <stddef.h>    /* needed for size_t */
+#include <stdint.h>    /* defines some types, including: int64_t */
+#include <signal.h>    /* needed for sig_atomic_t */
+#include <time.h>      /* needed for struct timespec */
+
+#include "sleep_margin.h"
+
+#define SE_MAX_CHANNELS 64
+#define SE_SPIN_NS     200000  /* ns, the default time to busy-wait before each due time: clock_nanosleep()
+                                  wakes at least the 50 us of the default timer slack late, and often 60 to 90 us */
+
+struct sampler_engine;
+
+/* Take one sample: time_value is when the channel fired, ns since the start of the run */
+typedef void (*se_sample_function)(struct sampler_engine *se, int channel, int64_t time_value, void *arg);
+
+struct se_channel
+{
+    int64_t            period;      /* ns */
+    int64_t            phase;       /* ns, the first due time, after the start */
+    se_sample_function sample;
+    void              *arg;
+
+    long               k;           /* the next due time is phase + k * period */
+    int64_t            next_due;
+
+    /* statistics */
+    long               n_samples;
+    long               n_skipped;   /* due times passed over, when the channel was a period late */
+    int64_t           *lateness;    /* ns, of the first max_records samples */
+};
+
+struct sampler_engine
+{
+    struct se_channel channel[SE_MAX_CHANNELS];
+    int               n_channels;
+    int               heap[SE_MAX_CHANNELS];  /* channel numbers, the soonest due at heap[0] */
+    size_t            max_records;
+    int64_t           spin_ns;                /* SE_SPIN_NS, unless changed */
+    struct sleep_margin *margin;              /* if not NULL, it sets the margin, and spin_ns is not used */
+    struct timespec   start;                  /* of the run, on CLOCK_MONOTONIC */
+    volatile sig_atomic_t stop_wanted;
+    int64_t           run_ns;                 /* how long the last run lasted */
+
+    /* statistics, of the waits */
+    long              n_sleeps;
+    long              n_late_wakeups;         /* sleeps that woke after the due time, with no spin left */
+    int64_t           spin_total_ns;          /* the time spent busy-waiting */
+};
+
+/* an engine with no channels yet, that will record the lateness of up to max_records samples of each */
+void    se_init(struct sampler_engine *se, size_t max_records);
+void    se_free(struct sampler_engine *se);
+
+/* a channel that first falls due phase ns after the start, and every period ns after that,
+   returns the channel number, or -1, with a message on stderr */
+int     se_add_channel(struct sampler_engine *se, int64_t period, int64_t phase, se_sample_function sample, void *arg);
+
+/* fire the channels, in due order, for duration ns, or until se_stop(), returns 0, or 1 if there are no channels */
+int     se_run(struct sampler_engine *se, int64_t duration);
+void    se_stop(struct sampler_engine *se);
+
+/* ns since the start of the run */
+int64_t se_elapsed_time(const struct sampler_engine *se);
+
+/* print the percentiles of the lateness of each channel's samples, and the time spent busy-waiting */
+void    se_report(const struct sampler_engine *se, FILE *fp);
+
+#endif /* SAMPLER_ENGINE_H */
@@ -0,0 +1,69 @@
+/* sleep_margin.c */
+
+/* A sleep margin from an online estimate of a high quantile of the sleep overshoot, see sleep_margin.h */
+
+#include <stdio.h>
+#include <string.h>
+#include <math.h>      /* needed for fabs() */
+
+#include "sleep_margin.h"
+
+/*-----------------------------------------------------------------------------*/
+
+void sm_init(struct sleep_margin *sm, double miss_rate, int64_t initial_ns)
+{
+    memset(sm, 0, sizeof(*sm));
+    if(miss_rate <= 0.0) miss_rate = 0.0001;
+    if(miss_rate >= 1.0) miss_rate = 0.5;
+    sm->quantile  = 1.0 - miss_rate;
+    sm->estimate  = (double) initial_ns;
+    sm->deviation = (double) initial_ns / 2.0; /* large, so that the first steps are large */
+}
+
+/*-----------------------------------------------------------------------------*/
+
+int64_t sm_margin(const struct sleep_margin *sm)
+{
+    int64_t m = (int64_t) sm->estimate;
+
+    if(m < SM_MIN_NS) return SM_MIN_NS;
+    if(m > SM_MAX_NS) return SM_MAX_NS;
+    return m;
+}
+
+/*-----------------------------------------------------------------------------*/
+
+void sm_update(struct sleep_margin *sm, int64_t overshoot)
+{
+    double x = (double) overshoot;
+    double step, d;
+
+    if(overshoot > sm_margin(sm)) sm->n_misses++;
+    if(overshoot > sm->max_overshoot) sm->max_overshoot = overshoot;
+    sm->n_updates++;
+
+    /* the step comes from the deviation before this overshoot, so an outlier cannot enlarge its own step,
+       and its part in the deviation is limited, so that it cannot enlarge the next ones by much either */
+    step = SM_GAIN * sm->deviation;
+    d    = fabs(x - sm->estimate);
+    if(d > SM_CLAMP * sm->deviation) d = SM_CLAMP * sm->deviation;
+    sm->deviation += SM_SMOOTHING * (d - sm->deviation);
+
+    if(x > sm->estimate)
+        sm->estimate += step * sm->quantile;
+    else
+        sm->estimate -= step * (1.0 - sm->quantile);
+
+    if(sm->estimate < 0.0) sm->estimate = 0.0;
+    if(sm->estimate > SM_MAX_NS) sm->estimate = SM_MAX_NS;
+}
+
+/*-----------------------------------------------------------------------------*/
+
+void sm_report(const struct sleep_margin *sm, FILE *fp)
+{
+    fprintf(fp, "adaptive margin: %ld ns, aiming at the %.2f%% quantile of the overshoot, %ld of %ld wake-ups past it (%.2f%%), the worst %ld ns past the time asked for\n",
+            (long) sm_margin(sm), 100.0 * sm->quantile, sm->n_misses, sm->n_updates,
+            100.0 * (double) sm->n_misses / (double) (sm->n_updates > 0 ? sm->n_updates : 1), (long) sm->max_overshoot);
+}
+/*-----------------------------------------------------------------------------*/
@@ -0,0 +1,64 @@
+/* sleep_margin.h */
+
+/* A sleep margin that tunes itself, from the measured overshoot of each sleep.
+
+   The workshop sleeps for SLEEP_TIME = 83160 us of each 100000 us period, and busy-waits
+   the other 16840 us, 17% of the processor, a margin picked by hand, for the overruns of up to 14%
+   seen on MacOS. On Linux, clock_nanosleep() seldom wakes more than a few tens of us late,
+   so nearly all of that margin is spent spinning, for nothing.
+
+   Here the margin is the overshoot that the sleeps should only exceed at a target miss rate,
+   1% say, so it is an estimate of a high quantile, the 99th percentile, of the overshoot,
+   kept up to date with each wake-up, with no history stored:
+
+       estimate += step * q          if the overshoot was above the estimate
+       estimate -= step * (1 - q)    if it was not
+
+   which settles where a fraction 1 - q of the overshoots are above it. The step is a fraction of
+   the mean absolute deviation of the overshoot about the estimate, itself a running average,
+   so the estimate moves quickly while it is far off, and slowly once it has settled.
+   The step is taken from the deviation as it was before each overshoot, and no overshoot counts
+   for more than SM_CLAMP deviations in the average, so a single long one, from a pre-emption,
+   moves the estimate up by one ordinary step, and makes the steps after it a few percent larger.
+
+   A wake-up later than the margin in force is a miss: the sampler then fires late, with no spin at all.
+   sleep_margin.c only keeps the estimate; the sampler engine (sampler_engine.c) measures the overshoot,
+   and the time spent busy-waiting, and reports what fraction of the run that was. */
+
+#ifndef SLEEP_MARGIN_H
+#define SLEEP_MARGIN_H
+
+#include <stdio.h>
+#include <stdint.h>    /* defines some types, including: int64_t */
+
+#define SM_MIN_NS       1000    /* ns, the least margin, for the clock_gettime() of the spin */
+#define SM_MAX_NS   10000000    /* ns, the most */
+#define SM_GAIN         0.25    /* the step, as a fraction of the deviation */
+#define SM_SMOOTHING    0.02    /* the weight of each overshoot in the deviation */
+#define SM_CLAMP        4.0     /* the most that one overshoot counts for in the deviation, in deviations */
+
+struct sleep_margin
+{
+    double  quantile;       /* 1 - the target miss rate */
+    double  estimate;       /* ns, of that quantile of the overshoot */
+    double  deviation;      /* ns, the running mean of |overshoot - estimate| */
+
+    /* statistics */
+    long    n_updates;
+    long    n_misses;       /* overshoots past the margin that was in force */
+    int64_t max_overshoot;  /* ns */
+};
+
+/* a margin that aims for miss_rate, between 0 and 1, starting from initial_ns */
+void    sm_init(struct sleep_margin *sm, double miss_rate, int64_t initial_ns);
+
+/* the margin to sleep short of the next due time by, ns */
+int64_t sm_margin(const struct sleep_margin *sm);
+
+/* the overshoot of one sleep, ns past the time it was asked to wake at */
+void    sm_update(struct sleep_margin *sm, int64_t overshoot);
+
+/* print the margin, and how often it was missed */
+void    sm_report(const struct sleep_margin *sm, FILE *fp);
+
+#endif /* SLEEP_MARGIN_H */
@@ -0,0 +1,94 @@
+/* spsc_queue.c */
+
+/* A lock-free queue, from one producer thread to one consumer thread, see spsc_queue.h */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "spsc_queue.h"
+
+/*-----------------------------------------------------------------------------*/
+
+int spsc_init(struct spsc_queue *q, size_t element_size, size_t capacity)
+{
+    size_t c = 1;
+
+    memset(q, 0, sizeof(*q));
+    while(c < capacity) c <<= 1; /* round up to a power of two, so that the index is a mask */
+
+    /* allocate, and touch, every slot now, so that the producer takes no page faults later */
+    q->store = (unsigned char *) calloc(c, element_size);
+    if(q->store == NULL) return 1;
+    memset(q->store, 0, c * element_size);
+
+    q->element_size = element_size;
+    q->capacity     = c;
+    q->mask         = c - 1;
+    return 0;
+}
+
+/*-----------------------------------------------------------------------------*/
+
+void spsc_free(struct spsc_queue *q)
+{
+    free(q->store);
+    q->store = NULL;
+}
+
+/*-----------------------------------------------------------------------------*/
+
+int spsc_put(struct spsc_queue *q, const void *item)
+{
+    size_t head = q->head; /* only this thread writes head */
+
+    if(head - q->cached_tail == q->capacity)
+        {
+            /* full, as far as we knew, so look again */
+            q->cached_tail = __atomic_load_n(&q->tail, __ATOMIC_ACQUIRE);
+            if(head - q->cached_tail == q->capacity)
+                {
+                    q->n_dropped++;
+                    return 1;
+                }
+        }
+    memcpy(q->store + (head & q->mask) * q->element_size, item, q->element_size);
+    __atomic_store_n(&q->head, head + 1, __ATOMIC_RELEASE); /* publish the item */
+    return 0;
+}
+
+/*-----------------------------------------------------------------------------*/
+
+int spsc_get(struct spsc_queue *q, void *item)
+{
+    size_t tail = q->tail; /* only this thread writes tail */
+
+    if(tail == q->cached_head)
+        {
+            q->cached_head = __atomic_load_n(&q->head, __ATOMIC_ACQUIRE);
+            if(tail == q->cached_head) return 1;
+        }
+    memcpy(item, q->store + (tail & q->mask) * q->element_size, q->element_size);
+    __atomic_store_n(&q->tail, tail + 1, __ATOMIC_RELEASE); /* hand the slot back */
+    return 0;
+}
+
+/*-----------------------------------------------------------------------------*/
+
+size_t spsc_get_bulk(struct spsc_queue *q, void *items, size_t n)
+{
+    size_t tail = q->tail;
+    size_t at   = tail & q->mask;
+    size_t count, first;
+
+    q->cached_head = __atomic_load_n(&q->head, __ATOMIC_ACQUIRE);
+    count = q->cached_head - tail;
+    if(n > count) n = count;
+    first = q->capacity - at; /* the items before the end of the store */
+    if(first > n) first = n;
+
+    memcpy(items, q->store + at * q->element_size, first * q->element_size);
+    memcpy((unsigned char *) items + first * q->element_size, q->store, (n - first) * q->element_size);
+    __atomic_store_n(&q->tail, tail + n, __ATOMIC_RELEASE);
+    return n;
+}
+/*-----------------------------------------------------------------------------*/
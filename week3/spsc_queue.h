@@ -0,0 +1,59 @@
+/* spsc_queue.h */
+
+/* A lock-free queue, from one producer thread to one consumer thread.
+
+   The sample_time_stamp programs fill a global queue, and print it only at the end, because
+   nothing can take items out while the sampling loop is running. With this queue, the sampler
+   puts each sample in, and a second thread takes them out, and processes them, at the same time.
+
+   There is no lock. Only the producer writes head, and only the consumer writes tail.
+   Each item is copied into its slot before head is advanced, with a release store, and the consumer
+   reads head with an acquire load, so that when it sees the new head it sees the item too.
+   The same pairing, the other way round, hands empty slots back to the producer.
+
+   head and tail are on separate cache lines, each with the other side's index as last seen,
+   so that the two threads do not pull one cache line back and forth on every item: the producer
+   only reads tail again when the queue looks full, and the consumer only reads head when it looks empty.
+
+   spsc_put() never waits. If the queue is full, the item is dropped, and counted, so that
+   the producer's timing does not depend on how quickly the consumer keeps up. */
+
+#ifndef SPSC_QUEUE_H
+#define SPSC_QUEUE_H
+
+#include <stddef.h>    /* needed for size_t */
+
+#define SPSC_CACHE_LINE 64
+
+struct spsc_queue
+{
+    /* set by spsc_init(), and only read after that */
+    unsigned char *store;
+    size_t         element_size;
+    size_t         capacity;     /* a power of two */
+    size_t         mask;
+
+    /* the producer's cache line */
+    size_t         head __attribute__((aligned(SPSC_CACHE_LINE)));  /* items ever put */
+    size_t         cached_tail;  /* tail, when the producer last looked */
+    long           n_dropped;    /* items that found the queue full */
+
+    /* the consumer's cache line */
+    size_t         tail __attribute__((aligned(SPSC_CACHE_LINE)));  /* items ever taken */
+    size_t         cached_head;  /* head, when the consumer last looked */
+};
+
+/* allocate the store, for at least capacity items, returns 0 on success, 1 if out of memory */
+int    spsc_init(struct spsc_queue *q, size_t element_size, size_t capacity);
+void   spsc_free(struct spsc_queue *q);
+
+/* the producer: one item, returns 0, or 1 if the queue was full and the item was dropped */
+int    spsc_put(struct spsc_queue *q, const void *item);
+
+/* the consumer: one item, returns 0, or 1 if the queue is empty */
+int    spsc_get(struct spsc_queue *q, void *item);
+
+/* the consumer: up to n items, returns the number taken */
+size_t spsc_get_bulk(struct spsc_queue *q, void *items, size_t n);
+
+#endif /* SPSC_QUEUE_H */
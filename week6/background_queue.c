@@ -0,0 +1,134 @@
+/* background_queue.c */
+
+/* Background work in the slack of each frame, see background_queue.h */
+
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>    /* defines some types, including: int64_t */
+#include <time.h>      /* needed for clock_gettime() */
+
+#include "background_queue.h"
+
+/* function templates, for local helpers */
+static int64_t elapsed_since(const struct timespec *base);
+
+/*-----------------------------------------------------------------------------*/
+
+void bg_init(struct background_queue *bq)
+{
+    memset(bq, 0, sizeof(*bq));
+    bq->guard_ns = BG_GUARD_NS;
+}
+
+/*-----------------------------------------------------------------------------*/
+
+int bg_submit(struct background_queue *bq, bg_step_function step, void *arg, int64_t unit_ns)
+{
+    struct bg_job *job;
+
+    if(bq->n_queued == BG_MAX_JOBS) return 1;
+    job = &bq->job[(bq->head + bq->n_queued) % BG_MAX_JOBS];
+    job->step    = step;
+    job->arg     = arg;
+    job->unit_ns = unit_ns;
+    job->n_units = 0;
+    job->n_deferred = 0;
+    bq->n_queued++;
+    bq->n_submitted++;
+    return 0;
+}
+
+/*-----------------------------------------------------------------------------*/
+
+long bg_run_slack(struct background_queue *bq, const struct timespec *base, int64_t end_ns)
+{
+    int64_t limit = end_ns - bq->guard_ns;
+    int64_t now   = elapsed_since(base);
+    int64_t then, used;
+    struct bg_job *job;
+    struct bg_job  moved;
+    long    n = 0;
+    int     n_moved = 0;
+    int     more;
+
+    if(now >= limit) return 0;
+    bq->offered_ns += limit - now;
+    if(limit - now > bq->max_slack_ns) bq->max_slack_ns = limit - now;
+
+    while(bq->n_queued > 0)
+        {
+            job = &bq->job[bq->head];
+            if(now + job->unit_ns > limit)
+                {
+                    job->n_deferred++;
+                    bq->n_deferred++; /* it would not fit, leave it for the next frame */
+                    if((job->n_deferred < BG_MAX_DEFERRALS) || (n_moved >= bq->n_queued - 1)) break;
+
+                    /* it has held up the queue long enough, let the jobs behind it have this slack */
+                    moved = *job;
+                    moved.n_deferred = 0;
+                    bq->head = (bq->head + 1) % BG_MAX_JOBS;
+                    bq->job[(bq->head + bq->n_queued - 1) % BG_MAX_JOBS] = moved;
+                    bq->n_moved++;
+                    n_moved++;
+                    continue;
+                }
+            job->n_deferred = 0;
+
+            more = job->step(job->arg);
+            then = elapsed_since(base);
+            used = then - now;
+
+            /* quick to be more careful, slower to be less, and never expecting more than a whole slack */
+            if(used > job->unit_ns)
+                job->unit_ns += (used - job->unit_ns) / 2;
+            else
+                job->unit_ns -= (job->unit_ns - used) / 4;
+            if(job->unit_ns > bq->max_slack_ns) job->unit_ns = bq->max_slack_ns;
+            job->n_units++;
+            bq->n_units++;
+            bq->busy_ns += used;
+            n++;
+            if(then > limit)
+                {
+                    bq->n_late_units++;
+                    if(then - limit > bq->max_overshoot_ns) bq->max_overshoot_ns = then - limit;
+                }
+
+            if(!more)
+                {
+                    bq->head = (bq->head + 1) % BG_MAX_JOBS;
+                    bq->n_queued--;
+                    bq->n_completed++;
+                }
+            now = then;
+        }
+    return n;
+}
+
+/*-----------------------------------------------------------------------------*/
+
+void bg_report(const struct background_queue *bq, int64_t run_ns, FILE *fp)
+{
+    double seconds = (double) run_ns / 1.0e9;
+
+    fprintf(fp, "background: jobs submitted %ld, completed %ld, still queued %d\n",
+            bq->n_submitted, bq->n_completed, bq->n_queued);
+    fprintf(fp, "background: units %ld (%.0f per second), busy %ld us of %ld us of slack (%.1f%%)\n",
+            bq->n_units, seconds > 0.0 ? (double) bq->n_units / seconds : 0.0,
+            (long) (bq->busy_ns/1000), (long) (bq->offered_ns/1000),
+            100.0 * (double) bq->busy_ns / (double) (bq->offered_ns > 0 ? bq->offered_ns : 1));
+    fprintf(fp, "background: units left for a later frame %ld, jobs moved back %ld, units past the end of the slack %ld, by at most %ld ns\n",
+            bq->n_deferred, bq->n_moved, bq->n_late_units, (long) bq->max_overshoot_ns);
+}
+
+/*-----------------------------------------------------------------------------*/
+
+static int64_t elapsed_since(const struct timespec *base)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (int64_t) (now.tv_sec - base->tv_sec) * 1000000000 + (now.tv_nsec - base->tv_nsec);
+}
+/*-----------------------------------------------------------------------------*/
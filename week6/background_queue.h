@@ -0,0 +1,80 @@
+/* background_queue.h */
+
+/* Background work, in the slack at the end of each minor frame.
+
+   When the jobs of a frame finish early, the slides spin, l++, until the boundary, and the rest
+   of the frame is wasted. Here the executive hands that slack to a queue of aperiodic background jobs.
+   Each job is a step function that does one short unit of its work, and keeps its own place,
+   so a job can be stopped between any two units, and carried on in a later frame.
+
+   A unit is only started when the time that it is expected to take still fits before the end of
+   the slack, which is the frame boundary less a guard, for the wait to hit the boundary.
+   The expected time starts from an estimate given when the job is submitted, moves half way up
+   to any longer unit, and a quarter of the way down to any shorter one, and is never more than
+   the largest slack ever offered, so one long unit, from a pre-emption, makes the queue more
+   careful for a while, and not for ever. A unit that is not expected to fit is never started:
+   a job that has not fitted for BG_MAX_DEFERRALS slacks in a row is moved to the back of the
+   queue instead, so that it cannot starve the jobs behind it, and waits for a slack as long as
+   its estimate. Once a unit has been measured, the cap makes that a slack offered before.
+
+   The jobs run in the order they were submitted, one at a time, apart from those moved back.
+   The queue is not locked:
+   submit jobs from the executive's own thread, before the run, or from inside a task. */
+
+#ifndef BACKGROUND_QUEUE_H
+#define BACKGROUND_QUEUE_H
+
+#include <stdio.h>
+#include <stdint.h>    /* defines some types, including: int64_t */
+#include <time.h>      /* needed for struct timespec */
+
+#define BG_MAX_JOBS  64     /* the most jobs waiting at once */
+#define BG_GUARD_NS  20000  /* ns, the slack left before the boundary, for the frame wait */
+#define BG_MAX_DEFERRALS 4  /* slacks in a row that a job may not fit, before it is moved to the back */
+
+/* One unit of a background job: returns 1 if the job has more to do, 0 when it is finished */
+typedef int (*bg_step_function)(void *arg);
+
+struct bg_job
+{
+    bg_step_function step;
+    void            *arg;
+    int64_t          unit_ns;     /* the expected time of one unit */
+    long             n_units;     /* the units of this job run so far */
+    int              n_deferred;  /* the slacks in a row that its next unit did not fit */
+};
+
+struct background_queue
+{
+    struct bg_job job[BG_MAX_JOBS];  /* a circular FIFO */
+    int           head;              /* the job now running */
+    int           n_queued;
+    int64_t       guard_ns;          /* BG_GUARD_NS, unless changed */
+    int64_t       max_slack_ns;      /* the largest slack offered so far, the most a unit is expected to take */
+
+    /* statistics */
+    long          n_submitted;
+    long          n_completed;
+    long          n_units;
+    long          n_deferred;        /* the times that the next unit would not fit, and waited for the next frame */
+    long          n_moved;           /* the times that a job was moved back, after BG_MAX_DEFERRALS */
+    long          n_late_units;      /* units that ran past the end of the slack */
+    int64_t       max_overshoot_ns;  /* the furthest past it */
+    int64_t       busy_ns;           /* the time spent in background units */
+    int64_t       offered_ns;        /* the slack that was handed to the queue */
+};
+
+void bg_init(struct background_queue *bq);
+
+/* add a job to the end of the queue, with an estimate of the time of one unit, in ns.
+   Returns 0, or 1 if the queue is full. */
+int  bg_submit(struct background_queue *bq, bg_step_function step, void *arg, int64_t unit_ns);
+
+/* run units of the queued jobs until the next would not fit before end_ns, less the guard,
+   where the times are ns since *base, on CLOCK_MONOTONIC. Returns the number of units run. */
+long bg_run_slack(struct background_queue *bq, const struct timespec *base, int64_t end_ns);
+
+/* print the throughput of the background work, over a run of run_ns */
+void bg_report(const struct background_queue *bq, int64_t run_ns, FILE *fp);
+
+#endif /* BACKGROUND_QUEUE_H */
@@ -0,0 +1,429 @@
+/* cyclic_executive.c */
+
+/* A table-driven cyclic executive, see cyclic_executive.h */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>    /* defines some types, including: int64_t */
+#include <time.h>      /* needed for clock_gettime() and CLOCK_MONOTONIC */
+
+#include "cyclic_executive.h"
+
+#define LINE_LENGTH 256  /* the longest line in a frame-table file */
+
+/* function templates, for local helpers */
+static int parse_frame_line(char *rest, struct frame_table *ft, const char *file_name, int line_no);
+static int gcd(int a, int b);
+
+/*-----------------------------------------------------------------------------*/
+
+int ce_load_frame_table(const char *file_name, struct frame_table *ft)
+{
+    FILE *fp;
+    char  line[LINE_LENGTH];
+    char  keyword[LINE_LENGTH];
+    char  label[LINE_LENGTH];
+    char *hash;
+    int   line_no = 0;
+    int   offset;
+    int   id, C, T, D;
+    int   n_read;
+    int   ret_val = 0;
+
+    memset(ft, 0, sizeof(*ft));
+    ft->time_tick = CE_TIME_TICK;
+
+    fp = fopen(file_name, "r");
+    if(!fp)
+        {
+            perror("File opening failed");
+            return 1;
+        }
+
+    while((ret_val == 0) && (fgets(line, LINE_LENGTH, fp) != NULL))
+        {
+            line_no++;
+            hash = strchr(line, '#');
+            if(hash != NULL) *hash = '\0';   /* drop any comment */
+            if(sscanf(line, "%s%n", keyword, &offset) != 1) continue; /* a blank line */
+
+            if(strcmp(keyword, "tick") == 0)
+                {
+                    if((sscanf(line+offset, "%d", &ft->time_tick) != 1) || (ft->time_tick <= 0)) ret_val = 1;
+                }
+            else if(strcmp(keyword, "frame_size") == 0)
+                {
+                    if((sscanf(line+offset, "%d", &ft->f) != 1) || (ft->f <= 0)) ret_val = 1;
+                }
+            else if(strcmp(keyword, "hyperperiod") == 0)
+                {
+                    if((sscanf(line+offset, "%d", &ft->H) != 1) || (ft->H <= 0)) ret_val = 1;
+                }
+            else if(strcmp(keyword, "task") == 0)
+                {
+                    n_read = sscanf(line+offset, "%d %s %d %d %d", &id, label, &C, &T, &D);
+                    if(n_read == 4) D = T;
+                    if((n_read < 4) ||
+                            (id != ft->n_tasks) || (id >= CE_MAX_TASKS) || (C <= 0) || (T <= 0) || (D <= 0) || (D > T) ||
+                            (strlen(label) >= CE_LABEL_LENGTH))
+                        ret_val = 1;
+                    else
+                        {
+                            strcpy(ft->task[id].label, label);
+                            ft->task[id].C = C;
+                            ft->task[id].T = T;
+                            ft->task[id].D = D;
+                            ft->n_tasks++;
+                        }
+                }
+            else if(strcmp(keyword, "frame") == 0)
+                {
+                    /* the frames can only be checked against f and H once they are known */
+                    if((ft->f <= 0) || (ft->H <= 0) || (ft->H % ft->f != 0) || (ft->H / ft->f > CE_MAX_FRAMES))
+                        {
+                            fprintf(stderr, "%s:%d: frame_size and hyperperiod must come first, "
+                                    "with H a multiple of f, and at most %d frames\n", file_name, line_no, CE_MAX_FRAMES);
+                            fclose(fp);
+                            return 1;
+                        }
+                    ft->n_frames = ft->H / ft->f;
+                    if(parse_frame_line(line+offset, ft, file_name, line_no) != 0)
+                        {
+                            fclose(fp);
+                            return 1;
+                        }
+                }
+            else
+                ret_val = 1;
+        }
+    fclose(fp);
+
+    if(ret_val != 0)
+        {
+            fprintf(stderr, "%s:%d: cannot understand this line\n", file_name, line_no);
+            return 1;
+        }
+    if((ft->f <= 0) || (ft->H <= 0) || (ft->H % ft->f != 0) || (ft->H / ft->f > CE_MAX_FRAMES) || (ft->n_tasks == 0))
+        {
+            fprintf(stderr, "%s: a frame table needs a frame_size, a hyperperiod that is a multiple of it, "
+                    "at most %d frames, and some tasks\n", file_name, CE_MAX_FRAMES);
+            return 1;
+        }
+    ft->n_frames = ft->H / ft->f;
+    return 0;
+}
+
+/*-----------------------------------------------------------------------------*/
+
+/* "frame <j> <job> <job> ...", where a job is <task> or <task>:<ticks>, with a ? after it if optional */
+static int parse_frame_line(char *rest, struct frame_table *ft, const char *file_name, int line_no)
+{
+    struct ce_frame *fr;
+    char *word;
+    int   optional;
+    int   j, task, ticks;
+    int   n_read;
+
+    word = strtok(rest, " \t\r\n");
+    if((word == NULL) || (sscanf(word, "%d", &j) != 1) || (j < 0) || (j >= ft->n_frames))
+        {
+            fprintf(stderr, "%s:%d: the frame number must be in 0 .. %d\n", file_name, line_no, ft->n_frames-1);
+            return 1;
+        }
+    fr = &ft->frame[j];
+
+    while((word = strtok(NULL, " \t\r\n")) != NULL)
+        {
+            optional = (word[strlen(word)-1] == '?');
+            if(optional) word[strlen(word)-1] = '\0';
+            n_read = sscanf(word, "%d:%d", &task, &ticks);
+            if((n_read < 1) || (task < 0) || (task >= ft->n_tasks))
+                {
+                    fprintf(stderr, "%s:%d: \"%s\" is not a task that has been declared\n", file_name, line_no, word);
+                    return 1;
+                }
+            if(n_read == 1) ticks = ft->task[task].C; /* the whole job */
+            if((ticks <= 0) || (fr->n_jobs >= CE_MAX_JOBS))
+                {
+                    fprintf(stderr, "%s:%d: bad slice length, or more than %d jobs in a frame\n", file_name, line_no, CE_MAX_JOBS);
+                    return 1;
+                }
+            fr->job[fr->n_jobs].task  = task;
+            fr->job[fr->n_jobs].ticks    = ticks;
+            fr->job[fr->n_jobs].optional = optional;
+            fr->n_jobs++;
+        }
+    return 0;
+}
+
+/*-----------------------------------------------------------------------------*/
+
+int ce_check_frame_table(const struct frame_table *ft, FILE *report)
+{
+    int n_warnings = 0;
+    int load;
+    int demand;
+    int i, j, k;
+
+    fprintf(report, "f = %d, H = %d, %d frames, %d us per tick\n", ft->f, ft->H, ft->n_frames, ft->time_tick);
+    for (i=0; i<ft->n_tasks; i++)
+        fprintf(report, "%s:\t%d\tC = %d\tT = %d\tD = %d\n", ft->task[i].label, i, ft->task[i].C, ft->task[i].T, ft->task[i].D);
+
+    /* 1. every job should fit in a frame, unless it has been split, so this is only advice */
+    for (i=0; i<ft->n_tasks; i++)
+        if(ft->task[i].C > ft->f)
+            fprintf(report, "note: %s has C = %d > f, so its jobs must be split\n", ft->task[i].label, ft->task[i].C);
+
+    for (i=0; i<ft->n_tasks; i++)
+        {
+            /* 2. f should divide the hyperperiod, and so the period of some task */
+            if(ft->task[i].T % ft->f == 0) break;
+        }
+    if(i == ft->n_tasks)
+        fprintf(report, "note: f = %d divides none of the periods\n", ft->f);
+
+    /* 3. there must be a whole frame between the release of each job and its deadline */
+    for (i=0; i<ft->n_tasks; i++)
+        if(2*ft->f - gcd(ft->task[i].T, ft->f) > ft->task[i].D)
+            {
+                fprintf(report, "warning: 2f - gcd(T, f) = %d > D = %d, for %s\n",
+                        2*ft->f - gcd(ft->task[i].T, ft->f), ft->task[i].D, ft->task[i].label);
+                n_warnings++;
+            }
+
+    /* the jobs in each frame must fit in the frame */
+    for (j=0; j<ft->n_frames; j++)
+        {
+            load = 0;
+            for (k=0; k<ft->frame[j].n_jobs; k++) load += ft->frame[j].job[k].ticks;
+            if(load > ft->f)
+                {
+                    fprintf(report, "warning: frame %d is over-full, %d ticks of work in %d\n", j, load, ft->f);
+                    n_warnings++;
+                }
+        }
+
+    /* and each task must get C ticks per period, over the major cycle */
+    for (i=0; i<ft->n_tasks; i++)
+        {
+            demand = 0;
+            for (j=0; j<ft->n_frames; j++)
+                for (k=0; k<ft->frame[j].n_jobs; k++)
+                    if(ft->frame[j].job[k].task == i) demand += ft->frame[j].job[k].ticks;
+            if(demand != ft->task[i].C * (ft->H / ft->task[i].T))
+                {
+                    fprintf(report, "warning: %s gets %d ticks in the major cycle, but needs %d\n",
+                            ft->task[i].label, demand, ft->task[i].C * (ft->H / ft->task[i].T));
+                    n_warnings++;
+                }
+        }
+
+    return n_warnings;
+}
+
+/*-----------------------------------------------------------------------------*/
+
+void ce_write_frame_table(const struct frame_table *ft, FILE *fp)
+{
+    int i, j, k;
+
+    fprintf(fp, "tick        %d\n", ft->time_tick);
+    fprintf(fp, "frame_size  %d\n", ft->f);
+    fprintf(fp, "hyperperiod %d\n", ft->H);
+    for (i=0; i<ft->n_tasks; i++)
+        {
+            fprintf(fp, "task %d %s %d %d", i, ft->task[i].label, ft->task[i].C, ft->task[i].T);
+            if(ft->task[i].D != ft->task[i].T) fprintf(fp, " %d", ft->task[i].D);
+            fprintf(fp, "\n");
+        }
+    for (j=0; j<ft->n_frames; j++)
+        {
+            if(ft->frame[j].n_jobs == 0) continue;
+            fprintf(fp, "frame %d", j);
+            for (k=0; k<ft->frame[j].n_jobs; k++)
+                {
+                    i = ft->frame[j].job[k].task;
+                    if(ft->frame[j].job[k].ticks == ft->task[i].C)
+                        fprintf(fp, " %d", i);
+                    else
+                        fprintf(fp, " %d:%d", i, ft->frame[j].job[k].ticks); /* a slice of a split job */
+                    if(ft->frame[j].job[k].optional) fprintf(fp, "?");
+                }
+            fprintf(fp, "\n");
+        }
+}
+
+/*-----------------------------------------------------------------------------*/
+
+void ce_init(struct cyclic_executive *ce, const struct frame_table *ft, ce_task_function fn)
+{
+    int i;
+
+    memset(ce, 0, sizeof(*ce));
+    ce->ft = ft;
+    for (i=0; i<CE_MAX_TASKS; i++) ce->task_function[i] = fn;
+    fw_init(&ce->wait, FW_SPIN, 0);
+}
+
+/*-----------------------------------------------------------------------------*/
+
+void ce_run(struct cyclic_executive *ce, int n_loops)
+{
+    struct timespec now;
+
+    /* start the clock */
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    ce_run_frames(ce, &now, (n_loops > 0) ? (long) n_loops * ce->ft->n_frames : 0);
+}
+
+/*-----------------------------------------------------------------------------*/
+
+void ce_run_frames(struct cyclic_executive *ce, const struct timespec *start, long n_frames)
+{
+    const struct frame_table *ft = ce->ft;
+    const struct ce_frame    *fr;
+    const struct ce_job      *job;
+    struct trace_record       record;
+    int64_t frame_ns = (int64_t) ft->f * ft->time_tick * 1000; /* there are 1000 ns in a us */
+    long    next_cycle;
+    int     i;
+
+    ce->start = *start;
+
+    /* step through the minor frames of all of the major cycles */
+    for (ce->frame_no=0; (n_frames <= 0) || (ce->frame_no < n_frames); ce->frame_no++)
+        {
+            ce->frame       = (int) (ce->frame_no % ft->n_frames);
+            ce->target_time = (ce->frame_no + 1) * frame_ns; /* the end of this minor frame, never shifted */
+            if(ce->frame_sync != NULL) ce->frame_sync(ce, ce->sync_arg);
+
+            /* the jobs of this minor frame, straight from the table, with no switch */
+            fr = &ft->frame[ce->frame];
+            for (i=0; i<fr->n_jobs; i++)
+                {
+                    job = &fr->job[i];
+                    if(job->optional && ce->shed_optional)
+                        {
+                            ce->n_shed++;
+                            continue;
+                        }
+                    /* has the frame already ended? */
+                    if((ce->overrun_policy != CE_OVERRUN_CONTINUE) && (ce_elapsed_time(ce) >= ce->target_time))
+                        {
+                            ce->n_skipped += fr->n_jobs - i;
+                            break;
+                        }
+                    ce->count[job->task]++;
+                    if(ce->trace != NULL)
+                        {
+                            record.task     = job->task;
+                            record.instance = (int32_t) ce->count[job->task];
+                            record.frame_no = ce->frame_no;
+                            record.start_ns = ce_elapsed_time(ce);
+                        }
+                    ce->task_function[job->task](ce, job->task, job->ticks);
+                    if(ce->trace != NULL)
+                        {
+                            record.end_ns = ce_elapsed_time(ce);
+                            (void) tr_put(ce->trace, &record); /* a copy, no I/O inside the frame */
+                        }
+                }
+            ce->shed_optional = 0;
+
+            /* the check at the boundary */
+            if(ce_elapsed_time(ce) >= ce->target_time)
+                {
+                    ce->n_overruns++;
+                    ce->overruns[ce->frame]++;
+
+                    switch(ce->overrun_policy)
+                        {
+                        case CE_OVERRUN_SHED:
+                            ce->shed_optional = 1;
+                            break;
+
+                        case CE_OVERRUN_RESYNC:
+                            /* skip to the first major cycle that has not started yet,
+                               counting the jobs of the frames that are passed over */
+                            next_cycle = (ce_elapsed_time(ce) / frame_ns / ft->n_frames + 1) * ft->n_frames;
+                            while(ce->frame_no+1 < next_cycle)
+                                {
+                                    ce->frame_no++;
+                                    ce->n_skipped += ft->frame[ce->frame_no % ft->n_frames].n_jobs;
+                                }
+                            ce->target_time = next_cycle * frame_ns;
+                            ce->n_resyncs++;
+                            break;
+
+                        default:
+                            /* CE_OVERRUN_SKIP skips the late jobs of the next frame as they come,
+                               CE_OVERRUN_CONTINUE lets them run late */
+                            break;
+                        }
+                }
+            else if(ce->background != NULL)
+                {
+                    /* useful work in the slack, rather than spinning through it */
+                    (void) bg_run_slack(ce->background, &ce->start, ce->target_time);
+                }
+
+            /* wait for the end of the current minor frame, by spinning, sleeping, or both */
+            fw_wait_until(&ce->wait, &ce->start, ce->target_time);
+        }
+}
+
+/*-----------------------------------------------------------------------------*/
+
+void ce_report_overruns(const struct cyclic_executive *ce, FILE *fp)
+{
+    int j;
+
+    fprintf(fp, "overruns %ld, jobs skipped %ld, optional jobs shed %ld, major cycles abandoned %ld\n",
+            ce->n_overruns, ce->n_skipped, ce->n_shed, ce->n_resyncs);
+    if(ce->n_overruns == 0) return;
+
+    fprintf(fp, "overruns by frame:");
+    for (j=0; j<ce->ft->n_frames; j++)
+        if(ce->overruns[j] > 0) fprintf(fp, " %d:%ld", j, ce->overruns[j]);
+    fprintf(fp, "\n");
+}
+
+/*-----------------------------------------------------------------------------*/
+
+int ce_overrun_policy_from_name(const char *name)
+{
+    if(strcmp(name, "continue") == 0) return CE_OVERRUN_CONTINUE;
+    if(strcmp(name, "skip")     == 0) return CE_OVERRUN_SKIP;
+    if(strcmp(name, "shed")     == 0) return CE_OVERRUN_SHED;
+    if(strcmp(name, "resync")   == 0) return CE_OVERRUN_RESYNC;
+    return -1;
+}
+
+/*-----------------------------------------------------------------------------*/
+
+int64_t ce_elapsed_time(const struct cyclic_executive *ce)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (int64_t) ((now.tv_sec * 1000000000) + now.tv_nsec) -
+           ((ce->start.tv_sec * 1000000000) + ce->start.tv_nsec);
+}
+
+/*-----------------------------------------------------------------------------*/
+
+/* the greatest common divisor, by Euclid's algorithm */
+static int gcd(int a, int b)
+{
+    int r;
+
+    while(b != 0)
+        {
+            r = a % b;
+            a = b;
+            b = r;
+        }
+    return a;
+}
+/*-----------------------------------------------------------------------------*/
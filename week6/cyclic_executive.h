@@ -0,0 +1,155 @@
+/* cyclic_executive.h */
+
+/* A table-driven cyclic executive.
+
+   The Slide_*.c programs each hard-code f, H, C[], T[] and a switch(j) on the frame number.
+   Here the schedule is data: a frame table, with the frame size f, the hyperperiod H,
+   and the list of jobs to run in each minor frame. The table is read from a file
+   (see the files in schedules/) or compiled in, and each job is dispatched through an array of
+   function pointers, one per task, so the cost of dispatch is one table look-up per job.
+
+   Frame-table files are plain text, one item per line, with # for comments:
+
+       tick        1000        the length of a time tick, in micro-seconds (default 1000)
+       frame_size  2           f, in ticks
+       hyperperiod 12          H, in ticks, a multiple of f
+       task 0 T1 1 4           task <id> <label> <C> <T> [<D>], ids count up from 0, D defaults to T
+       frame 0 0               frame <j> <job> <job> ..., the jobs of minor frame j, in order
+       frame 1 1:2             a job is <task>, run for C ticks, or <task>:<ticks>, a slice of a split job
+       frame 2 0 1?            a ? marks optional work, which may be shed after an overrun
+
+   Frames that are not listed are empty.
+   Times inside the executive are in nanoseconds since the start, as in the slides.
+
+   If the jobs of a frame run past its end, that is an overrun. It is detected by checking the clock
+   before each job, and at the boundary, and the executive recovers by one of the CE_OVERRUN_ policies.
+   The frame boundaries are always at whole multiples of f from the start, so a late frame
+   never shifts the ones after it. Only CE_OVERRUN_CONTINUE, as in the slides, lets the work drift
+   behind the boundaries, until the slack of later frames absorbs it.
+
+   When a frame's jobs finish early, the slack before the boundary can be given to a queue of
+   background jobs (see background_queue.c), which stops in time for the wait to hit the boundary. */
+
+#ifndef CYCLIC_EXECUTIVE_H
+#define CYCLIC_EXECUTIVE_H
+
+#include <stdio.h>
+#include <stdint.h>    /* defines some types, including: int64_t */
+#include <time.h>      /* needed for struct timespec */
+
+#include "frame_wait.h"
+#include "trace_ring.h"
+#include "background_queue.h"
+
+#define CE_MAX_TASKS     8  /* the largest number of tasks in a frame table */
+#define CE_MAX_FRAMES   64  /* the largest number of minor frames in a major cycle */
+#define CE_MAX_JOBS      8  /* the largest number of jobs in one minor frame */
+#define CE_LABEL_LENGTH  8  /* labels such as "T1" */
+#define CE_TIME_TICK  1000  /* the default length of a tick, in micro-seconds */
+
+/* what to do when the jobs of a frame run past its end */
+#define CE_OVERRUN_CONTINUE 0  /* run every job anyway, late, as the slides do */
+#define CE_OVERRUN_SKIP     1  /* skip the jobs of a frame that are left when its end has passed */
+#define CE_OVERRUN_SHED     2  /* skip them, and shed the optional jobs of the next frame too */
+#define CE_OVERRUN_RESYNC   3  /* abandon the rest of the major cycle, and start again at the next one */
+
+/* one job, or one slice of a split job, in a minor frame */
+struct ce_job
+{
+    int task;      /* which task to dispatch */
+    int ticks;     /* how long it should run for */
+    int optional;  /* 1 if this job may be shed, to catch up after an overrun */
+};
+
+struct ce_frame
+{
+    int           n_jobs;
+    struct ce_job job[CE_MAX_JOBS];
+};
+
+struct ce_task
+{
+    char label[CE_LABEL_LENGTH];
+    int  C;  /* computing time, in ticks */
+    int  T;  /* period, in ticks */
+    int  D;  /* relative deadline, in ticks, D <= T */
+};
+
+struct frame_table
+{
+    int             time_tick;  /* micro-seconds per tick */
+    int             f;          /* the minor-frame size, in ticks */
+    int             H;          /* the major cycle, or hyperperiod, in ticks */
+    int             n_frames;   /* H/f */
+    int             n_tasks;
+    struct ce_task  task[CE_MAX_TASKS];
+    struct ce_frame frame[CE_MAX_FRAMES];
+};
+
+struct cyclic_executive;
+
+/* A task, as dispatched by the executive: which task, and for how many ticks */
+typedef void (*ce_task_function)(struct cyclic_executive *ce, int task, int ticks);
+
+/* Called at the start of every minor frame, before its jobs, e.g. to meet the other cores at a barrier */
+typedef void (*ce_frame_function)(struct cyclic_executive *ce, void *arg);
+
+/* The state of a running executive */
+struct cyclic_executive
+{
+    const struct frame_table *ft;
+    ce_task_function task_function[CE_MAX_TASKS]; /* the dispatch table, indexed by task */
+    struct timespec  start;                       /* the time at which the executive was started */
+    int64_t          target_time;                 /* the end of the current minor frame, ns since start */
+    long             frame_no;                    /* the number of minor frames since the start */
+    int              frame;                       /* the current minor frame, 0 .. n_frames-1 */
+    long             count[CE_MAX_TASKS];         /* the number of instances of each task, so far */
+    struct frame_wait wait;                       /* how to wait for the end of each frame, FW_SPIN by default */
+    struct trace_ring *trace;                     /* if not NULL, the start and end of every job are stored here */
+    struct background_queue *background;          /* if not NULL, its jobs are run in the slack of each frame */
+    ce_frame_function frame_sync;                 /* if not NULL, called at the start of every frame */
+    void             *sync_arg;
+    void             *user_data;                  /* anything the task functions need */
+
+    /* overruns */
+    int              overrun_policy;              /* one of the CE_OVERRUN_ policies, CONTINUE by default */
+    int              shed_optional;               /* 1 while the optional jobs of this frame are to be shed */
+    long             n_overruns;                  /* the frames whose work ran past their end */
+    long             overruns[CE_MAX_FRAMES];     /* the same, for each minor frame of the table */
+    long             n_skipped;                   /* jobs skipped, because their frame had already ended */
+    long             n_shed;                      /* optional jobs shed, after an overrun */
+    long             n_resyncs;                   /* major cycles abandoned */
+};
+
+/* read a frame-table file, returns 0 on success, or non-zero with a message on stderr */
+int     ce_load_frame_table(const char *file_name, struct frame_table *ft);
+
+/* print the frame-table, and warn about anything that looks wrong with it:
+   over-full frames, tasks that get the wrong amount of time, and the frame-size constraints.
+   Returns the number of warnings. */
+int     ce_check_frame_table(const struct frame_table *ft, FILE *report);
+
+/* set up an executive, with every task dispatched to the same function, to begin with,
+   and a busy-loop wait at the end of each frame, as in the slides */
+void    ce_init(struct cyclic_executive *ce, const struct frame_table *ft, ce_task_function fn);
+
+/* write a frame table in the same format that ce_load_frame_table() reads */
+void    ce_write_frame_table(const struct frame_table *ft, FILE *fp);
+
+/* run n_loops major cycles, or for ever if n_loops <= 0 */
+void    ce_run(struct cyclic_executive *ce, int n_loops);
+
+/* run n_frames minor frames, or for ever if n_frames <= 0, timed from *start, on CLOCK_MONOTONIC,
+   rather than from now, so that several executives can share the same frame boundaries */
+void    ce_run_frames(struct cyclic_executive *ce, const struct timespec *start, long n_frames);
+
+/* print the overrun counts */
+void    ce_report_overruns(const struct cyclic_executive *ce, FILE *fp);
+
+/* "continue", "skip", "shed" or "resync" to a CE_OVERRUN_ code, or -1 */
+int     ce_overrun_policy_from_name(const char *name);
+
+/* the number of nanoseconds since the executive was started */
+int64_t ce_elapsed_time(const struct cyclic_executive *ce);
+
+#endif /* CYCLIC_EXECUTIVE_H */
@@ -0,0 +1,350 @@
+/* cyclic_executive_01.c */
+
+/* One cyclic executive for all of the slides.
+
+   Slide_25.c ... Slide_42_2.c are near-identical copies, each with its own f, H, C[], T[]
+   and a switch(j) on the frame number. Here the frame table is data, read from a file
+   in schedules/, or the compiled-in table of Slide 25 when no file is given,
+   and each job is dispatched through a table of function pointers (see cyclic_executive.c).
+
+   The pseudo-tasks sleep for 0.8 of their ticks, to leave room for usleep() over-sleeping,
+   or, with -k, burn the CPU time of all of their ticks, by a calibrated kernel (see workload.c),
+   so that the processor is really loaded. The same lines as the slides are printed: label, id, instance, start and end times,
+   tabbed across the screen. Printing to the terminal inside a frame would distort its timing,
+   so the executive stores a binary record of each job in a trace ring (see trace_ring.c),
+   and the lines are printed after the run, or with -d, by a low-priority drain thread during it.
+   -p prints inside the task instead, as the slides do, for comparison.
+
+   At the end of each frame the executive waits by spinning, as the slides do, or by sleeping,
+   or by sleeping until a calibrated margin before the boundary and then spinning (see frame_wait.c).
+   The accuracy of the frame boundaries, and the CPU time spent waiting, are reported at the end.
+
+   With -x, some jobs run for three times as long as they should, at random, to see how the
+   executive copes with overruns, under each of the recovery policies of -o.
+
+   With -b, the slack at the end of each frame, which the slides spin through, does background work
+   instead (see background_queue.c): a number of jobs, each counting the primes in a block of numbers,
+   a short slice at a time, stopping in time for each boundary. Their throughput is reported at the end.
+
+   compilation advice:
+   gcc -std=gnu99 -Werror -Wall -Wextra -O2 -o cyclic_executive_01 cyclic_executive_01.c cyclic_executive.c frame_wait.c trace_ring.c background_queue.c workload.c -pthread
+
+   an execution suggestion:
+   ./cyclic_executive_01
+   ./cyclic_executive_01 -w hybrid schedules/Slide_41.txt 2
+   ./cyclic_executive_01 -x 20 -o shed schedules/optional_work.txt 10
+   ./cyclic_executive_01 -w hybrid -k compute -b 16 schedules/Slide_41.txt 4
+
+   The optional second parameter is the number of major cycles (default 1, 0 for ever).
+
+   options:
+   -w spin|sleep|hybrid  how to wait for the end of each frame (default spin)
+   -o continue|skip|shed|resync
+                         what to do when a frame overruns (default continue, as in the slides)
+   -x percent            the chance that a job overruns, by taking three times as long (default 0)
+   -d                    print the trace during the run, from a low-priority thread
+   -p                    print inside each task, as the slides do, rather than via the trace ring
+   -k compute|memory|cache
+                         burn CPU time in each task, by this kernel, rather than sleep
+   -b n_jobs             run this many background jobs in the slack of the frames (default 0)
+   */
+
+#include <stdio.h>     /* needed for printf() */
+#include <stdlib.h>    /* for exit() and atoi() */
+#include <stdint.h>    /* defines some types, including: int64_t */
+#include <unistd.h>    /* needed for usleep() and getopt() */
+
+#include "cyclic_executive.h"
+#include "workload.h"
+
+/* The number of tabs to use across the screen */
+#define TAB_STEP  7
+
+/* The number of clock_nanosleep() wake-ups to measure, for the hybrid margin */
+#define CALIBRATION_SAMPLES 200
+
+/* An overloaded job takes this many times as long as it should */
+#define OVERLOAD_FACTOR 3
+#define SEED           34 /* repeatable overloads */
+
+/* The size of the trace ring, when running for ever, or the largest, when not */
+#define TRACE_CAPACITY (1<<16)
+
+/* Each background job counts the primes in a block of numbers, a slice at a time */
+#define PRIME_FIRST  10000000  /* the first block starts here */
+#define PRIME_BLOCK     20000  /* numbers in each job */
+#define PRIME_SLICE       200  /* numbers in each unit */
+#define PRIME_UNIT_NS   50000  /* a first guess at the time of one unit */
+
+#define USAGE "Usage is: ./cyclic_executive_01 [-w spin|sleep|hybrid] [-o continue|skip|shed|resync] [-x percent] [-d|-p] [-k compute|memory|cache] [-b n_jobs] [frame_table_file [n_loops]]\n"
+
+/* the chance, in percent, that a job overruns */
+static int overload_percent = 0;
+
+/* 1 to print inside the tasks, as the slides do */
+static int print_inline = 0;
+
+/* the CPU-burn kernel, if the tasks are to do real work */
+static int             use_workload = 0;
+static struct workload workload;
+
+/* one background job, and how far it has got */
+struct prime_count
+{
+    long from, to;  /* the block, from <= n < to */
+    long next;      /* the next number to test */
+    long count;     /* the primes found so far */
+};
+
+/* function templates */
+static void tab_space(int k);
+static void task_simulation(struct cyclic_executive *ce, int task, int ticks);
+static void print_record(const struct trace_record *r, void *arg);
+static int  count_primes(void *arg);
+
+/* The schedule of Slide 25, compiled in: f = 2, H = 12, C = {1, 2}, T = {4, 6} */
+static const struct frame_table slide_25 =
+{
+    .time_tick = CE_TIME_TICK,
+    .f         = 2,
+    .H         = 12,
+    .n_frames  = 6,
+    .n_tasks   = 2,
+    .task      = { {"T1", 1, 4, 4}, {"T2", 2, 6, 6} },
+    .frame     =
+    {
+        [0] = { 1, { {0, 1} } },
+        [1] = { 1, { {1, 2} } },
+        [2] = { 1, { {0, 1} } },
+        [4] = { 1, { {0, 1} } },
+        [5] = { 1, { {1, 2} } },
+    },
+};
+
+int main(int argc, char *argv[])
+{
+    static struct frame_table loaded; /* too big to be comfortable on the stack */
+    const struct frame_table *ft = &slide_25;
+    struct cyclic_executive   ce;
+    struct trace_ring         trace;
+    static struct background_queue background;
+    static struct prime_count prime[BG_MAX_JOBS];
+    int     n_background = 0;
+    long    n_primes = 0, n_numbers = 0;
+    size_t  capacity = TRACE_CAPACITY;
+    int     use_drain = 0;
+    int     n_jobs = 0;
+    int     j;
+    int     kernel;
+    int     n_loops  = 1;
+    int     strategy = FW_SPIN;
+    int     policy   = CE_OVERRUN_CONTINUE;
+    int64_t margin   = 0;
+    int     opt;
+
+    while((opt = getopt(argc, argv, "w:o:x:dpk:b:")) != -1)
+        switch(opt)
+            {
+            case 'w':
+                strategy = fw_strategy_from_name(optarg);
+                if(strategy < 0)
+                    {
+                        fprintf(stderr, USAGE);
+                        return EXIT_FAILURE;
+                    }
+                break;
+            case 'o':
+                policy = ce_overrun_policy_from_name(optarg);
+                if(policy < 0)
+                    {
+                        fprintf(stderr, USAGE);
+                        return EXIT_FAILURE;
+                    }
+                break;
+            case 'x':
+                overload_percent = atoi(optarg);
+                break;
+            case 'd':
+                use_drain = 1;
+                break;
+            case 'p':
+                print_inline = 1;
+                break;
+            case 'k':
+                kernel = wl_kernel_from_name(optarg);
+                if((kernel < 0) || (wl_init(&workload, kernel) != 0))
+                    {
+                        fprintf(stderr, USAGE);
+                        return EXIT_FAILURE;
+                    }
+                use_workload = 1;
+                break;
+            case 'b':
+                n_background = atoi(optarg);
+                if((n_background < 0) || (n_background > BG_MAX_JOBS))
+                    {
+                        fprintf(stderr, "error: from 0 to %d background jobs, please\n", BG_MAX_JOBS);
+                        return EXIT_FAILURE;
+                    }
+                break;
+            default:
+                fprintf(stderr, USAGE);
+                return EXIT_FAILURE;
+            }
+    srand(SEED);
+
+    if(argc > optind)
+        {
+            if(ce_load_frame_table(argv[optind], &loaded) != 0) return EXIT_FAILURE;
+            ft = &loaded;
+        }
+    if(argc > optind+1) n_loops = atoi(argv[optind+1]);
+
+    if(ce_check_frame_table(ft, stdout) != 0)
+        printf("this frame table has problems, but it will be run anyway\n");
+    printf("\n");
+
+    /* every task is the same pseudo-task here, but each entry of the table could differ */
+    ce_init(&ce, ft, task_simulation);
+
+    if(strategy == FW_HYBRID) margin = fw_calibrate(CALIBRATION_SAMPLES);
+    fw_init(&ce.wait, strategy, margin);
+    ce.overrun_policy = policy;
+
+    if(n_background > 0)
+        {
+            bg_init(&background);
+            for (j=0; j<n_background; j++)
+                {
+                    prime[j].from = prime[j].next = PRIME_FIRST + (long) j * PRIME_BLOCK;
+                    prime[j].to   = prime[j].from + PRIME_BLOCK;
+                    (void) bg_submit(&background, count_primes, &prime[j], PRIME_UNIT_NS);
+                }
+            ce.background = &background;
+        }
+
+    if(!print_inline)
+        {
+            /* room for every job of the run, if it is not for ever */
+            for (j=0; j<ft->n_frames; j++) n_jobs += ft->frame[j].n_jobs;
+            if((n_loops > 0) && ((size_t) n_loops * (size_t) n_jobs < capacity)) capacity = (size_t) n_loops * (size_t) n_jobs;
+            if(tr_init(&trace, capacity) != 0)
+                {
+                    fprintf(stderr, "error: out of memory for the trace ring\n");
+                    return EXIT_FAILURE;
+                }
+            ce.trace = &trace;
+            fflush(stdout);
+            if(use_drain && (tr_start_drain(&trace, print_record, (void *) ft) != 0))
+                {
+                    fprintf(stderr, "error: the drain thread could not be started\n");
+                    return EXIT_FAILURE;
+                }
+        }
+
+    ce_run(&ce, n_loops);
+
+    if(!print_inline)
+        {
+            if(use_drain)
+                tr_stop_drain(&trace);
+            else
+                (void) tr_format_all(&trace, print_record, (void *) ft);
+            if(trace.n_dropped > 0) printf("%ld trace records were dropped, the ring was full\n", (long) trace.n_dropped);
+            tr_free(&trace);
+        }
+
+    printf("\n");
+    fw_report(&ce.wait, stdout);
+    ce_report_overruns(&ce, stdout);
+    if(use_workload)
+        {
+            wl_report(&workload, stdout);
+            wl_free(&workload);
+        }
+    if(n_background > 0)
+        {
+            for (j=0; j<n_background; j++)
+                {
+                    n_primes  += prime[j].count;
+                    n_numbers += prime[j].next - prime[j].from;
+                }
+            bg_report(&background, ce_elapsed_time(&ce), stdout);
+            printf("background: %ld primes found, in %ld of %ld numbers\n", n_primes, n_numbers, (long) n_background * PRIME_BLOCK);
+        }
+
+    return EXIT_SUCCESS;
+}
+
+/*-----------------------------------------------------------------------------*/
+
+/* tab across the screen, by an amount, of k tabs
+   this visual spacing helps with the illusion that separate tasks are
+   being executed. */
+static void tab_space(int k)
+{
+    int j;
+    for (j=0; j<k; j++) printf("\t");
+}
+
+/*-----------------------------------------------------------------------------*/
+
+/* Simulate a pseudo-task, or one slice of it, for a number of time ticks */
+static void task_simulation(struct cyclic_executive *ce, int task, int ticks)
+{
+    /* Adjust for the tendency of usleep() to over-sleep, by shaving the time given to each task */
+    int SHORT_TIME_TICK = (int) (0.8* ((float) ce->ft->time_tick));
+
+    /* now and then, a job takes much longer than it should */
+    if(rand() % 100 < overload_percent) ticks *= OVERLOAD_FACTOR;
+
+    if(print_inline)
+        {
+            /* Display some results on the correct part of the screen, inside the frame, as the slides do */
+            tab_space(TAB_STEP*task);
+            printf("%s:\t %d\t%ld\t", ce->ft->task[task].label, task, ce->count[task]);
+            printf("%ld\t", (long) ce_elapsed_time(ce)); /* The starting time for this task */
+        }
+
+    if(use_workload)
+        (void) wl_burn(&workload, (int64_t) ticks * ce->ft->time_tick * 1000); /* real work, on the processor */
+    else
+        (void) usleep((useconds_t) (ticks*SHORT_TIME_TICK));
+    /* sleep for the required number of time ticks, to simulate work */
+
+    if(print_inline)
+        printf("%ld\n", (long) ce_elapsed_time(ce)); /* The completion time for this task */
+}
+
+/*-----------------------------------------------------------------------------*/
+
+/* One line of the trace, in the same layout as the slides, well away from the timed frames */
+static void print_record(const struct trace_record *r, void *arg)
+{
+    const struct frame_table *ft = (const struct frame_table *) arg;
+
+    tab_space(TAB_STEP*r->task);
+    printf("%s:\t %d\t%d\t%ld\t%ld\n", ft->task[r->task].label, r->task, r->instance,
+           (long) r->start_ns, (long) r->end_ns);
+}
+/*-----------------------------------------------------------------------------*/
+
+/* One unit of a background job: test the next slice of its block for primes, by trial division */
+static int count_primes(void *arg)
+{
+    struct prime_count *p = (struct prime_count *) arg;
+    long end = p->next + PRIME_SLICE;
+    long n, d;
+
+    if(end > p->to) end = p->to;
+    for (n=p->next; n<end; n++)
+        {
+            if((n < 2) || ((n % 2 == 0) && (n != 2))) continue;
+            for (d=3; d*d<=n; d+=2)
+                if(n % d == 0) break;
+            if(d*d > n) p->count++;
+        }
+    p->next = end;
+    return p->next < p->to;
+}
+/*-----------------------------------------------------------------------------*/
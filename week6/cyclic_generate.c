@@ -0,0 +1,148 @@
+/* cyclic_generate.c */
+
+/* Generate a cyclic executive, as C, from a frame table.
+
+   cyclic_executive_01 interprets its frame table as it runs: it looks up the jobs of each frame,
+   and dispatches each through a table of function pointers. Slide_37_2.c and the others hard-code
+   the same thing as a switch on the frame number. This program does that work once, at build time:
+   it reads a frame-table file (see cyclic_executive.h) and writes a C file in which each major cycle
+   is one straight-line function, with a call for each job and each frame boundary, and the task,
+   its time, and the boundary times all constants. There is no table, no switch and no loop over
+   jobs left to run. The Makefile generates one for each schedule in schedules/, and compiles each,
+   with generated_executive.c, into its own executable, in generated/.
+
+   The checks of ce_check_frame_table() are copied into the head of the generated file, as a comment.
+
+   compilation advice:
+   gcc -std=gnu99 -Werror -Wall -Wextra -O2 -o cyclic_generate cyclic_generate.c cyclic_executive.c frame_wait.c trace_ring.c background_queue.c -pthread
+
+   an execution suggestion:
+   ./cyclic_generate schedules/Slide_37_2.txt Slide_37_2_generated.c
+   gcc -std=gnu99 -Werror -Wall -Wextra -O2 -I. -o Slide_37_2_generated Slide_37_2_generated.c generated_executive.c frame_wait.c workload.c
+   ./Slide_37_2_generated -w hybrid 2
+
+   or, for all of the schedules at once:
+   make all
+   ./generated/Slide_37_2 -w hybrid 2
+   */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>    /* defines some types, including: int64_t */
+
+#include "cyclic_executive.h"
+
+#define LINE_LENGTH 256
+
+/* function templates */
+static void write_executive(const struct frame_table *ft, const char *table_file, FILE *report, FILE *fp);
+static const char *base_name(const char *path, char *name, size_t size);
+static void error_exit(char *s);
+
+int main(int argc, char *argv[])
+{
+    static struct frame_table ft;
+    FILE *report;
+    FILE *fp;
+
+    if(argc != 3)
+        {
+            fprintf(stderr, "Usage is: ./cyclic_generate frame_table_file output_file.c\n");
+            return EXIT_FAILURE;
+        }
+    if(ce_load_frame_table(argv[1], &ft) != 0) return EXIT_FAILURE;
+
+    /* keep the report of the checks, for the comment at the head of the file */
+    report = tmpfile();
+    if(report == NULL) error_exit("no temporary file for the report");
+    (void) ce_check_frame_table(&ft, report);
+    rewind(report);
+
+    fp = fopen(argv[2], "w");
+    if(fp == NULL) error_exit("unable to open the output file");
+    write_executive(&ft, argv[1], report, fp);
+    if(fclose(fp) != 0)
+        {
+            (void) remove(argv[2]); /* rather than leave half a file for make to find */
+            error_exit("unable to write the output file");
+        }
+    fclose(report);
+    return EXIT_SUCCESS;
+}
+
+/*-----------------------------------------------------------------------------*/
+
+/* The whole generated file */
+static void write_executive(const struct frame_table *ft, const char *table_file, FILE *report, FILE *fp)
+{
+    char    name[LINE_LENGTH];
+    char    line[LINE_LENGTH];
+    int64_t tick_ns  = (int64_t) ft->time_tick * 1000;
+    int64_t frame_ns = (int64_t) ft->f * tick_ns;
+    const struct ce_job *job;
+    int     i, j;
+
+    (void) base_name(table_file, name, sizeof(name));
+
+    fprintf(fp, "/* %s, generated by cyclic_generate from %s, do not edit */\n\n", name, table_file);
+    fprintf(fp, "/*\n");
+    while(fgets(line, sizeof(line), report) != NULL) fprintf(fp, "   %s", line);
+    fprintf(fp, "   */\n\n");
+    fprintf(fp, "#include <stdint.h>\n\n#include \"generated_executive.h\"\n\n");
+
+    fprintf(fp, "static const char *const label[%d] = {", ft->n_tasks);
+    for (i=0; i<ft->n_tasks; i++) fprintf(fp, "%s \"%s\"", (i > 0) ? "," : "", ft->task[i].label);
+    fprintf(fp, " };\n\n");
+
+    /* one major cycle, in a straight line */
+    fprintf(fp, "static void major_cycle(int64_t base)\n{\n");
+    for (j=0; j<ft->n_frames; j++)
+        {
+            fprintf(fp, "    /* frame %d */\n", j);
+            for (i=0; i<ft->frame[j].n_jobs; i++)
+                {
+                    job = &ft->frame[j].job[i];
+                    fprintf(fp, "    ge_job(%d, %ldLL); /* %s, %d ticks%s */\n", job->task, (long) (job->ticks * tick_ns),
+                            ft->task[job->task].label, job->ticks, job->optional ? ", optional, but always run here" : "");
+                }
+            fprintf(fp, "    ge_frame_end(%d, base + %ldLL);\n", j, (long) ((j+1) * frame_ns));
+        }
+    fprintf(fp, "}\n\n");
+
+    fprintf(fp, "static const struct ge_schedule schedule =\n{\n");
+    fprintf(fp, "    .name        = \"%s\",\n", name);
+    fprintf(fp, "    .frame_ns    = %ldLL,\n", (long) frame_ns);
+    fprintf(fp, "    .major_ns    = %ldLL,\n", (long) (ft->n_frames * frame_ns));
+    fprintf(fp, "    .n_frames    = %d,\n", ft->n_frames);
+    fprintf(fp, "    .n_tasks     = %d,\n", ft->n_tasks);
+    fprintf(fp, "    .label       = label,\n");
+    fprintf(fp, "    .major_cycle = major_cycle,\n");
+    fprintf(fp, "};\n\n");
+
+    fprintf(fp, "int main(int argc, char *argv[])\n{\n");
+    fprintf(fp, "    return ge_main(argc, argv, &schedule);\n}\n");
+}
+
+/*-----------------------------------------------------------------------------*/
+
+/* the file name, without its directory or its extension, e.g. Slide_37_2 */
+static const char *base_name(const char *path, char *name, size_t size)
+{
+    const char *p = strrchr(path, '/');
+    char       *dot;
+
+    snprintf(name, size, "%s", (p != NULL) ? p+1 : path);
+    dot = strrchr(name, '.');
+    if(dot != NULL) *dot = '\0';
+    return name;
+}
+
+/*-----------------------------------------------------------------------------*/
+
+/* A standard formatter for printing eror messages, and exiting */
+static void error_exit(char *s)
+{
+    fprintf(stderr, "\nerror: %s - bye!\n",s);
+    exit(1);
+}
@@ -0,0 +1,179 @@
+/* cyclic_multicore_01.c */
+
+/* A cyclic executive on several cores, one frame table per core (see multicore_executive.c).
+
+   The tasks burn real CPU time (see workload.c), so a task set that is too much for one core,
+   such as Slide 42's doubled, with U = 1.37, can only keep to its frames when it is spread
+   over two. Each core leaves a barrier at the start of every frame, and the spread of those
+   times across the cores, the boundary skew, is reported at the end, along with the overruns,
+   and the trace of every job, by core.
+
+   compilation advice:
+   gcc -std=gnu99 -Werror -Wall -Wextra -O2 -o cyclic_multicore_01 cyclic_multicore_01.c multicore_executive.c cyclic_executive.c frame_wait.c trace_ring.c background_queue.c workload.c -pthread
+
+   an execution suggestion:
+   ./cyclic_multicore_01 schedules/Slide_42_2.txt schedules/Slide_42_2_core1.txt
+   ./cyclic_multicore_01 -q -n 100 -w spin schedules/Slide_42_2.txt schedules/Slide_42_2_core1.txt
+
+   options:
+   -n n_loops            major cycles of the longest table (default 2)
+   -w spin|sleep|hybrid  how each core waits for the end of a frame (default hybrid)
+   -o continue|skip|shed what to do when a frame overruns (default skip)
+   -k compute|memory|cache
+                         the CPU-burn kernel (default compute)
+   -q                    do not print the trace
+   */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>    /* defines some types, including: int64_t */
+#include <unistd.h>    /* needed for getopt() */
+
+#include "cyclic_executive.h"
+#include "multicore_executive.h"
+#include "workload.h"
+
+#define TAB_STEP            7   /* The number of tabs to use across the screen */
+#define CALIBRATION_SAMPLES 200 /* clock_nanosleep() wake-ups to measure, for the hybrid margin */
+
+#define USAGE "Usage is: ./cyclic_multicore_01 [-n n_loops] [-w spin|sleep|hybrid] [-o continue|skip|shed] [-k compute|memory|cache] [-q] frame_table_file ...\n"
+
+/* function templates */
+static void tab_space(int k);
+static void task_burn(struct cyclic_executive *ce, int task, int ticks);
+static void print_record(const struct trace_record *r, void *arg);
+static void error_exit(char *s);
+
+int main(int argc, char *argv[])
+{
+    static struct frame_table          loaded[MC_MAX_CORES];
+    static const struct frame_table   *ft[MC_MAX_CORES];
+    static struct multicore_executive  mc;
+    static struct workload             workload[MC_MAX_CORES];
+    static struct trace_ring           trace[MC_MAX_CORES];
+    int     n_loops  = 2;
+    int     strategy = FW_HYBRID;
+    int     policy   = CE_OVERRUN_SKIP;
+    int     kernel   = WL_COMPUTE;
+    int     quiet    = 0;
+    int     n_cores;
+    int64_t margin   = 0;
+    double  U, U_all = 0.0;
+    int     opt;
+    int     c, i;
+
+    while((opt = getopt(argc, argv, "n:w:o:k:q")) != -1)
+        switch(opt)
+            {
+            case 'n':
+                n_loops = atoi(optarg);
+                break;
+            case 'w':
+                strategy = fw_strategy_from_name(optarg);
+                break;
+            case 'o':
+                policy = ce_overrun_policy_from_name(optarg);
+                break;
+            case 'k':
+                kernel = wl_kernel_from_name(optarg);
+                break;
+            case 'q':
+                quiet = 1;
+                break;
+            default:
+                fprintf(stderr, USAGE);
+                return EXIT_FAILURE;
+            }
+    n_cores = argc - optind;
+    if((n_cores < 1) || (n_cores > MC_MAX_CORES) || (strategy < 0) || (policy < 0) || (kernel < 0) || (n_loops < 1))
+        {
+            fprintf(stderr, USAGE);
+            return EXIT_FAILURE;
+        }
+
+    for (c=0; c<n_cores; c++)
+        {
+            if(ce_load_frame_table(argv[optind+c], &loaded[c]) != 0) return EXIT_FAILURE;
+            ft[c] = &loaded[c];
+            U = 0.0;
+            for (i=0; i<ft[c]->n_tasks; i++) U += (double) ft[c]->task[i].C / (double) ft[c]->task[i].T;
+            U_all += U;
+            printf("core %d: %s, U = %.3f\n", c, argv[optind+c], U);
+        }
+    printf("all cores: U = %.3f\n\n", U_all);
+
+    if(mc_init(&mc, n_cores, ft, task_burn, n_loops) != 0) return EXIT_FAILURE;
+    if(strategy == FW_HYBRID) margin = fw_calibrate(CALIBRATION_SAMPLES);
+
+    for (c=0; c<n_cores; c++)
+        {
+            if(wl_init(&workload[c], kernel) != 0) error_exit("out of memory for the workload");
+            if(tr_init(&trace[c], (size_t) mc.n_frames_run * CE_MAX_JOBS) != 0) error_exit("out of memory for the trace");
+            fw_init(&mc.core[c].ce.wait, strategy, margin);
+            mc.core[c].ce.overrun_policy = policy;
+            mc.core[c].ce.trace          = &trace[c];
+            mc.core[c].ce.user_data      = &workload[c];
+        }
+
+    if(mc_run(&mc) != 0) return EXIT_FAILURE;
+
+    for (c=0; c<n_cores; c++)
+        {
+            if(!quiet)
+                {
+                    printf("core %d:\n", c);
+                    (void) tr_format_all(&trace[c], print_record, (void *) ft[c]);
+                }
+            printf("core %d: ", c);
+            ce_report_overruns(&mc.core[c].ce, stdout);
+        }
+    printf("\n");
+    mc_report_skew(&mc, stdout);
+
+    for (c=0; c<n_cores; c++)
+        {
+            tr_free(&trace[c]);
+            wl_free(&workload[c]);
+        }
+    mc_free(&mc);
+    return EXIT_SUCCESS;
+}
+
+/*-----------------------------------------------------------------------------*/
+
+/* tab across the screen, by an amount, of k tabs */
+static void tab_space(int k)
+{
+    int j;
+    for (j=0; j<k; j++) printf("\t");
+}
+
+/*-----------------------------------------------------------------------------*/
+
+/* A pseudo-task that does real work: it burns the CPU time of its ticks, on its own core */
+static void task_burn(struct cyclic_executive *ce, int task, int ticks)
+{
+    (void) task;
+    (void) wl_burn((struct workload *) ce->user_data, (int64_t) ticks * ce->ft->time_tick * 1000);
+}
+
+/*-----------------------------------------------------------------------------*/
+
+/* One line of the trace, in the same layout as the slides */
+static void print_record(const struct trace_record *r, void *arg)
+{
+    const struct frame_table *ft = (const struct frame_table *) arg;
+
+    tab_space(TAB_STEP*r->task);
+    printf("%s:\t %d\t%d\t%ld\t%ld\n", ft->task[r->task].label, r->task, r->instance,
+           (long) r->start_ns, (long) r->end_ns);
+}
+
+/*-----------------------------------------------------------------------------*/
+
+/* A standard formatter for printing eror messages, and exiting */
+static void error_exit(char *s)
+{
+    fprintf(stderr, "\nerror: %s - bye!\n",s);
+    exit(1);
+}
@@ -0,0 +1,548 @@
+/* cyclic_synthesis.c */
+
+/* Building frame tables for the cyclic executive, see cyclic_synthesis.h */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>    /* needed for INT_MAX */
+
+#include "cyclic_synthesis.h"
+
+#define LINE_LENGTH 256 /* longer lines than this are not expected in a task file */
+
+/* one job of the major cycle */
+struct cs_job
+{
+    int task;
+    int C;         /* of the whole job, or of this piece of it */
+    int origin;    /* the whole job that a piece belongs to, numbered from 0 */
+    int deadline;  /* absolute, in ticks */
+    int first;     /* the first frame that starts at, or after, the release */
+    int last;      /* the last frame that ends at, or before, the deadline */
+};
+
+/* the state of the branch-and-bound search */
+struct bnb_search
+{
+    const struct cs_job *job;
+    int   n_jobs;
+    int   n_frames;
+    int  *frame_of;                   /* the frame chosen for each job */
+    int   capacity[CE_MAX_FRAMES];    /* the ticks left in each frame */
+    int   n_in_frame[CE_MAX_FRAMES];  /* the jobs placed in each frame */
+    long  n_nodes;
+
+    /* when minimising, the search goes on past the first table, for the one with the fewest slices */
+    int   minimise;
+    int   n_slices;                   /* in the frames so far */
+    int   best_slices;                /* in the best table found, INT_MAX before there is one */
+    int   least_slices;               /* no table can have fewer, so the search can stop there */
+    int  *best_frame_of;
+};
+
+/* function templates, for local helpers */
+static int  compare_jobs(const void *a, const void *b);
+static int  branch_and_bound(struct bnb_search *s, int k);
+static int  demand_bound(const struct bnb_search *s, int k);
+static int  cut_jobs(const struct cs_job *job, int n_jobs, int f, int by_ticks, struct cs_job *piece);
+static int  add_slice(struct ce_frame *fr, int task, int ticks);
+static long max_flow(int *cap, int n_nodes, int source, int sink);
+static int  gcd(int a, int b);
+
+/*-----------------------------------------------------------------------------*/
+
+int cs_read_tasks(const char *file_name, struct frame_table *ft)
+{
+    char line[LINE_LENGTH];
+    long type, C, T, D;
+    int  scanval;
+    long H = 1;
+
+    memset(ft, 0, sizeof(*ft));
+    ft->time_tick = CE_TIME_TICK;
+
+    FILE* in_fp = fopen(file_name, "r");
+    if(!in_fp)
+        {
+            perror("File opening failed");
+            return 1;
+        }
+
+    /* read the tasks, stopping at the first line that is not a task, as RM_simulator_07.c does */
+    while(fgets(line, LINE_LENGTH, in_fp) != NULL)
+        {
+            scanval = sscanf(line, "%ld %ld %ld %ld", &type, &C, &T, &D);
+            if(scanval < 3) break;
+            if(scanval == 3) D = T;
+
+            if((C <= 0) || (T <= 0) || (D <= 0) || (D > T) || (T > INT_MAX))
+                {
+                    fprintf(stderr, "%s: task %ld needs 0 < C, 0 < D <= T\n", file_name, type);
+                    fclose(in_fp);
+                    return 1;
+                }
+            if(ft->n_tasks >= CE_MAX_TASKS)
+                {
+                    fprintf(stderr, "%s: there are more than %d tasks\n", file_name, CE_MAX_TASKS);
+                    fclose(in_fp);
+                    return 1;
+                }
+
+            snprintf(ft->task[ft->n_tasks].label, CE_LABEL_LENGTH, "T%ld", type);
+            ft->task[ft->n_tasks].C = (int) C;
+            ft->task[ft->n_tasks].T = (int) T;
+            ft->task[ft->n_tasks].D = (int) D;
+            ft->n_tasks++;
+
+            /* the hyperperiod, as the l.c.m. of the periods so far */
+            H = (H / gcd((int) H, (int) T)) * T;
+            if(H > INT_MAX)
+                {
+                    fprintf(stderr, "%s: the hyperperiod is too long\n", file_name);
+                    fclose(in_fp);
+                    return 1;
+                }
+        }
+    fclose(in_fp);
+
+    if(ft->n_tasks == 0)
+        {
+            fprintf(stderr, "%s: there are no tasks in the file\n", file_name);
+            return 1;
+        }
+    ft->H = (int) H;
+    return 0;
+}
+
+/*-----------------------------------------------------------------------------*/
+
+int cs_frame_sizes(const struct frame_table *tasks, int *f, int max_f)
+{
+    int n = 0;
+    int divides;
+    int fits;
+    int size;
+    int i;
+
+    for (size=tasks->H; (size>=1) && (n<max_f); size--)
+        {
+            divides = 0;
+            fits    = 1;
+            for (i=0; i<tasks->n_tasks; i++)
+                {
+                    if(tasks->task[i].T % size == 0) divides = 1;                                   /* constraint 2 */
+                    if(2*size - gcd(tasks->task[i].T, size) > tasks->task[i].D) fits = 0;           /* constraint 3 */
+                }
+            if(divides && fits) f[n++] = size;
+        }
+    return n;
+}
+
+/*-----------------------------------------------------------------------------*/
+
+int cs_synthesise(const struct frame_table *tasks, int f, struct frame_table *out, struct cs_stats *stats)
+{
+    struct cs_job    *job;
+    struct cs_job    *piece;
+    struct bnb_search s;
+    int   n_jobs   = 0;
+    int   n_pieces = 0;
+    long  demand   = 0;
+    int   status   = CS_WHOLE_JOBS;
+    int   max_C    = 0;
+    int   placed   = 0;
+    int   by_ticks;
+    int   n_nodes;
+    long  flow;
+    int  *cap;
+    int   slices;
+    int   i, k, j, r;
+
+    memset(stats, 0, sizeof(*stats));
+    memset(out, 0, sizeof(*out));
+    out->time_tick = tasks->time_tick;
+    out->f         = f;
+    out->H         = tasks->H;
+    out->n_frames  = tasks->H / f;
+    out->n_tasks   = tasks->n_tasks;
+    memcpy(out->task, tasks->task, sizeof(out->task));
+
+    if(out->n_frames > CE_MAX_FRAMES) return CS_TOO_MANY_FRAMES;
+
+    /* list every job of the major cycle, with the frames that it may use */
+    for (i=0; i<tasks->n_tasks; i++)
+        {
+            n_jobs   += tasks->H / tasks->task[i].T;
+            n_pieces += (tasks->H / tasks->task[i].T) * ((tasks->task[i].C > f) ? tasks->task[i].C : 1);
+            demand   += (long) tasks->task[i].C * (tasks->H / tasks->task[i].T);
+            if(tasks->task[i].C > max_C) max_C = tasks->task[i].C;
+        }
+    if(demand > tasks->H) return CS_INFEASIBLE;
+
+    job   = (struct cs_job *) malloc((size_t) n_jobs * sizeof(struct cs_job));
+    piece = (struct cs_job *) malloc((size_t) n_pieces * sizeof(struct cs_job));
+    s.frame_of      = (int *) malloc((size_t) n_pieces * sizeof(int));
+    s.best_frame_of = (int *) malloc((size_t) n_pieces * sizeof(int));
+    if((job == NULL) | (piece == NULL) | (s.frame_of == NULL) | (s.best_frame_of == NULL))
+        {
+            free(job);
+            free(piece);
+            free(s.frame_of);
+            free(s.best_frame_of);
+            return CS_OUT_OF_MEMORY;
+        }
+
+    n_jobs = 0;
+    for (i=0; i<tasks->n_tasks; i++)
+        for (r=0; r<tasks->H; r+=tasks->task[i].T)
+            {
+                job[n_jobs].task     = i;
+                job[n_jobs].C        = tasks->task[i].C;
+                job[n_jobs].origin   = n_jobs;
+                job[n_jobs].deadline = r + tasks->task[i].D;
+                job[n_jobs].first    = (r + f - 1) / f;
+                job[n_jobs].last     = job[n_jobs].deadline / f - 1;
+                if(job[n_jobs].first > job[n_jobs].last) status = CS_INFEASIBLE; /* only if constraint 3 fails */
+                n_jobs++;
+            }
+    /* earliest deadline first, and the longest first among equals, places the hardest jobs early */
+    qsort(job, (size_t) n_jobs, sizeof(struct cs_job), compare_jobs);
+
+    if(status == CS_INFEASIBLE)
+        {
+            free(job);
+            free(piece);
+            free(s.frame_of);
+            free(s.best_frame_of);
+            return CS_INFEASIBLE;
+        }
+
+    /* 1. by branch-and-bound, with only the jobs with C > f split: first into the fewest pieces
+          that fit in a frame, which is as few splits as there can be, and, if those cannot be
+          placed, into single ticks, for a search that gathers them up into the fewest slices.
+          Every other job is kept whole. */
+    s.job      = piece;
+    s.n_frames = out->n_frames;
+    for (by_ticks=0; (by_ticks<=1) && (placed <= 0); by_ticks++)
+        {
+            if(by_ticks && ((max_C <= f) || (f == 1))) break; /* the same pieces as before */
+            s.n_jobs = cut_jobs(job, n_jobs, f, by_ticks, piece);
+            if(!by_ticks) s.least_slices = s.n_jobs;
+            s.minimise    = by_ticks;
+            s.n_slices    = 0;
+            s.best_slices = INT_MAX;
+            s.n_nodes     = 0;
+            for (j=0; j<out->n_frames; j++)
+                {
+                    s.capacity[j]   = f;
+                    s.n_in_frame[j] = 0;
+                }
+            placed = branch_and_bound(&s, 0);
+            stats->n_nodes += s.n_nodes;
+            stats->gave_up |= (placed < 0);
+            if(s.minimise && (s.best_slices < INT_MAX))
+                {
+                    /* the best table, even if the search was stopped before it could be shown the best */
+                    memcpy(s.frame_of, s.best_frame_of, (size_t) s.n_jobs * sizeof(int));
+                    placed = 1;
+                }
+        }
+    n_pieces = s.n_jobs;
+    free(s.best_frame_of);
+
+    if(placed > 0)
+        {
+            /* the pieces are in deadline order, so each frame runs its jobs in deadline order too,
+               and the pieces of one job that share a frame are run as one slice */
+            slices = 0;
+            for (k=0; (k<n_pieces) && (status != CS_TOO_MANY_JOBS); k++)
+                {
+                    r = add_slice(&out->frame[s.frame_of[k]], piece[k].task, piece[k].C);
+                    if(r < 0) status = CS_TOO_MANY_JOBS;
+                    slices += r;
+                }
+            free(job);
+            free(piece);
+            free(s.frame_of);
+            if(status == CS_TOO_MANY_JOBS) return CS_TOO_MANY_JOBS;
+            stats->n_splits = slices - n_jobs;
+            return (stats->n_splits > 0) ? CS_SPLIT_JOBS : CS_WHOLE_JOBS;
+        }
+    free(piece);
+    free(s.frame_of);
+
+    /* 2. if the pieces could not be placed, split the jobs anyhow, by maximum flow:
+          node 0 is the source, 1..n_jobs the jobs, then the frames, and the sink last */
+    n_nodes = n_jobs + out->n_frames + 2;
+    cap = (int *) calloc((size_t) n_nodes * (size_t) n_nodes, sizeof(int));
+    if(cap == NULL)
+        {
+            free(job);
+            return CS_OUT_OF_MEMORY;
+        }
+    for (k=0; k<n_jobs; k++)
+        {
+            cap[0*n_nodes + 1+k] = job[k].C;
+            for (j=job[k].first; j<=job[k].last; j++)
+                cap[(1+k)*n_nodes + 1+n_jobs+j] = job[k].C;
+        }
+    for (j=0; j<out->n_frames; j++)
+        cap[(1+n_jobs+j)*n_nodes + n_nodes-1] = f;
+
+    flow = max_flow(cap, n_nodes, 0, n_nodes-1);
+    if(flow < 0)
+        status = CS_OUT_OF_MEMORY;
+    else if(flow < demand)
+        status = CS_INFEASIBLE;
+    else
+        {
+            /* the flow from job k to frame j is left in the residual capacity from j back to k */
+            for (k=0; (k<n_jobs) && (status != CS_TOO_MANY_JOBS); k++)
+                {
+                    slices = 0;
+                    for (j=job[k].first; j<=job[k].last; j++)
+                        if(cap[(1+n_jobs+j)*n_nodes + 1+k] > 0)
+                            {
+                                if(add_slice(&out->frame[j], job[k].task, cap[(1+n_jobs+j)*n_nodes + 1+k]) < 0)
+                                    {
+                                        status = CS_TOO_MANY_JOBS;
+                                        break;
+                                    }
+                                slices++;
+                            }
+                    stats->n_splits += slices - 1;
+                }
+            if(status != CS_TOO_MANY_JOBS)
+                status = (stats->n_splits > 0) ? CS_SPLIT_JOBS : CS_WHOLE_JOBS;
+        }
+
+    free(cap);
+    free(job);
+    return status;
+}
+
+/*-----------------------------------------------------------------------------*/
+
+const char *cs_status_name(int status)
+{
+    switch(status)
+        {
+        case CS_WHOLE_JOBS:
+            return "whole jobs";
+        case CS_SPLIT_JOBS:
+            return "split jobs";
+        case CS_INFEASIBLE:
+            return "infeasible";
+        case CS_TOO_MANY_FRAMES:
+            return "too many frames";
+        case CS_TOO_MANY_JOBS:
+            return "too many jobs in a frame";
+        case CS_OUT_OF_MEMORY:
+            return "out of memory";
+        default:
+            return "unknown";
+        }
+}
+
+/*-----------------------------------------------------------------------------*/
+
+/* by deadline, then the longest first */
+static int compare_jobs(const void *a, const void *b)
+{
+    const struct cs_job *x = (const struct cs_job *) a;
+    const struct cs_job *y = (const struct cs_job *) b;
+
+    if(x->deadline != y->deadline) return (x->deadline < y->deadline) ? -1 : 1;
+    if(x->C != y->C) return (x->C > y->C) ? -1 : 1;
+    return x->task - y->task;
+}
+
+/*-----------------------------------------------------------------------------*/
+
+/* Cut each job with C > f into the fewest pieces of at most f, as even as they can be,
+   or into single ticks, and copy every other job whole. Returns the number of pieces. */
+static int cut_jobs(const struct cs_job *job, int n_jobs, int f, int by_ticks, struct cs_job *piece)
+{
+    int n_pieces = 0;
+    int n_p;
+    int k, p;
+
+    for (k=0; k<n_jobs; k++)
+        {
+            n_p = (job[k].C <= f) ? 1 : (by_ticks ? job[k].C : (job[k].C + f - 1) / f);
+            for (p=0; p<n_p; p++)
+                {
+                    piece[n_pieces]   = job[k];
+                    piece[n_pieces].C = job[k].C / n_p + ((p < job[k].C % n_p) ? 1 : 0);
+                    n_pieces++;
+                }
+        }
+    return n_pieces;
+}
+
+/*-----------------------------------------------------------------------------*/
+
+/* Add ticks of a task to a frame. A frame holds at most one job of each task, since D <= T,
+   so ticks for a task that is already there are another piece of the same job, and join its slice.
+   Returns 1 for a new slice, 0 for a joined one, or -1 if the frame already has CE_MAX_JOBS */
+static int add_slice(struct ce_frame *fr, int task, int ticks)
+{
+    int i;
+
+    for (i=0; i<fr->n_jobs; i++)
+        if(fr->job[i].task == task)
+            {
+                fr->job[i].ticks += ticks;
+                return 0;
+            }
+    if(fr->n_jobs >= CE_MAX_JOBS) return -1;
+    fr->job[fr->n_jobs].task  = task;
+    fr->job[fr->n_jobs].ticks = ticks;
+    fr->n_jobs++;
+    return 1;
+}
+
+/*-----------------------------------------------------------------------------*/
+
+/* Place jobs k, k+1, ... in frames, returns 1 when all are placed, 0 if they cannot be,
+   or -1 when the search has gone on for too long */
+static int branch_and_bound(struct bnb_search *s, int k)
+{
+    const struct cs_job *jb;
+    int j;
+    int r;
+    int joins;
+
+    if(k == s->n_jobs)
+        {
+            if(!s->minimise) return 1;
+            if(s->n_slices < s->best_slices)
+                {
+                    s->best_slices = s->n_slices;
+                    memcpy(s->best_frame_of, s->frame_of, (size_t) s->n_jobs * sizeof(int));
+                }
+            return (s->best_slices <= s->least_slices) ? 1 : 0;
+        }
+    if(s->minimise && (s->n_slices >= s->best_slices)) return 0; /* it can only have more */
+    if(++s->n_nodes > CS_MAX_NODES) return -1;
+    if(!demand_bound(s, k)) return 0;
+
+    jb = &s->job[k];
+
+    /* equal pieces of one job can be swapped, so each is only tried at or after the frame of the one before */
+    j = jb->first;
+    if((k > 0) && (s->job[k-1].origin == jb->origin) && (s->job[k-1].C == jb->C) && (s->frame_of[k-1] > j))
+        j = s->frame_of[k-1];
+    for (; j<=jb->last; j++)
+        {
+            /* a piece that joins the one before it, of the same job, adds no slice to the frame */
+            joins = (k > 0) && (s->job[k-1].origin == jb->origin) && (s->frame_of[k-1] == j);
+            if((s->capacity[j] >= jb->C) && (joins || (s->n_in_frame[j] < CE_MAX_JOBS)))
+                {
+                    s->frame_of[k] = j;
+                    s->capacity[j] -= jb->C;
+                    s->n_in_frame[j] += !joins;
+                    s->n_slices      += !joins;
+
+                    r = branch_and_bound(s, k+1);
+                    if(r != 0) return r;
+
+                    s->capacity[j] += jb->C;
+                    s->n_in_frame[j] -= !joins;
+                    s->n_slices      -= !joins;
+                }
+        }
+    return 0;
+}
+
+/*-----------------------------------------------------------------------------*/
+
+/* The bound: the jobs k, k+1, ... up to any deadline, need no more than the room left
+   in the frames before that deadline. The jobs are in deadline order, so "last" never decreases. */
+static int demand_bound(const struct bnb_search *s, int k)
+{
+    long demand = 0;
+    long room   = 0;
+    int  j      = 0;
+    int  i;
+
+    for (i=k; i<s->n_jobs; i++)
+        {
+            demand += s->job[i].C;
+            while(j <= s->job[i].last) room += s->capacity[j++];
+            if(demand > room) return 0;
+        }
+    return 1;
+}
+
+/*-----------------------------------------------------------------------------*/
+
+/* Edmonds-Karp: augment along shortest paths, found by breadth-first search,
+   over the dense residual-capacity matrix cap, which is left holding the residual graph */
+static long max_flow(int *cap, int n_nodes, int source, int sink)
+{
+    int  *parent = (int *) malloc((size_t) n_nodes * sizeof(int));
+    int  *queue  = (int *) malloc((size_t) n_nodes * sizeof(int));
+    long  flow   = 0;
+    int   head, tail;
+    int   u, v;
+    int   bottleneck;
+
+    if((parent == NULL) | (queue == NULL))
+        {
+            free(parent);
+            free(queue);
+            return -1;
+        }
+
+    while(1)
+        {
+            for (v=0; v<n_nodes; v++) parent[v] = -1;
+            parent[source] = source;
+            head = tail = 0;
+            queue[tail++] = source;
+            while((head < tail) && (parent[sink] < 0))
+                {
+                    u = queue[head++];
+                    for (v=0; v<n_nodes; v++)
+                        if((parent[v] < 0) && (cap[u*n_nodes + v] > 0))
+                            {
+                                parent[v] = u;
+                                queue[tail++] = v;
+                            }
+                }
+            if(parent[sink] < 0) break; /* no augmenting path is left */
+
+            bottleneck = INT_MAX;
+            for (v=sink; v!=source; v=parent[v])
+                if(cap[parent[v]*n_nodes + v] < bottleneck) bottleneck = cap[parent[v]*n_nodes + v];
+            for (v=sink; v!=source; v=parent[v])
+                {
+                    cap[parent[v]*n_nodes + v] -= bottleneck;
+                    cap[v*n_nodes + parent[v]] += bottleneck;
+                }
+            flow += bottleneck;
+        }
+
+    free(parent);
+    free(queue);
+    return flow;
+}
+
+/*-----------------------------------------------------------------------------*/
+
+/* the greatest common divisor, by Euclid's algorithm */
+static int gcd(int a, int b)
+{
+    int r;
+
+    while(b != 0)
+        {
+            r = a % b;
+            a = b;
+            b = r;
+        }
+    return a;
+}
+/*-----------------------------------------------------------------------------*/
@@ -0,0 +1,57 @@
+/* cyclic_synthesis.h */
+
+/* Building a frame table for the cyclic executive automatically, from the C, T (and D) of each task,
+   rather than working it out by hand, as in the Slide_*.c programs.
+
+   For a given task set the hyperperiod H is the l.c.m. of the periods, and the candidate
+   minor-frame sizes f are those that meet the frame constraints:
+
+   1. f >= max(C), so that no job need be split,
+   2. f divides the period of at least one task, and so divides H,
+   3. 2f - gcd(T, f) <= D for every task, so that there is a whole frame between
+      the release of every job and its deadline.
+
+   Constraints 2 and 3 are required. Constraint 1 is only a preference: for each f,
+   a job with C > f is first cut into the fewest pieces that fit in a frame, and every other
+   job is kept whole, and the jobs and pieces of the major cycle are placed by a branch-and-bound
+   search. Only if that fails are the jobs split anyhow, by a maximum-flow formulation
+   (source -> job, capacity C -> each frame inside the job's window -> sink, capacity f),
+   which is feasible exactly when the flow saturates every job, but may split more than it needs. */
+
+#ifndef CYCLIC_SYNTHESIS_H
+#define CYCLIC_SYNTHESIS_H
+
+#include "cyclic_executive.h"
+
+#define CS_MAX_FRAME_SIZES 64       /* the most candidate frame sizes */
+#define CS_MAX_NODES       2000000L /* give up the branch-and-bound search after this many nodes */
+
+/* the outcome of trying one frame size */
+#define CS_WHOLE_JOBS      0  /* a schedule was found, with no job split */
+#define CS_SPLIT_JOBS      1  /* a schedule was found, with some jobs split */
+#define CS_INFEASIBLE      2  /* there is no schedule with this f, even with splitting */
+#define CS_TOO_MANY_FRAMES 3  /* H/f > CE_MAX_FRAMES, so the table cannot be held */
+#define CS_TOO_MANY_JOBS   4  /* a frame would need more than CE_MAX_JOBS jobs */
+#define CS_OUT_OF_MEMORY   5
+
+struct cs_stats
+{
+    int  n_splits;  /* the number of extra slices, over all jobs: 0 when no job is split */
+    long n_nodes;   /* the number of nodes in the branch-and-bound search */
+    int  gave_up;   /* 1 if the search was stopped at CS_MAX_NODES, before the maximum flow was tried */
+};
+
+/* read a task file, of lines: <type> <C> <T> [<D>], as used in week7, into the tasks of ft,
+   and set its H to the hyperperiod. Returns 0 on success. */
+int  cs_read_tasks(const char *file_name, struct frame_table *ft);
+
+/* the frame sizes that meet constraints 2 and 3, largest first, returns how many */
+int  cs_frame_sizes(const struct frame_table *tasks, int *f, int max_f);
+
+/* try to build a frame table with frame size f, returns one of the CS_ codes above */
+int  cs_synthesise(const struct frame_table *tasks, int f, struct frame_table *out, struct cs_stats *stats);
+
+/* a short description of a CS_ code */
+const char *cs_status_name(int status);
+
+#endif /* CYCLIC_SYNTHESIS_H */
@@ -0,0 +1,220 @@
+/* cyclic_synthesis_01.c */
+
+/* Find a frame table for a task set automatically, rather than by hand as in the Slide_*.c programs.
+
+   The task file has one task per line, <type> <C> <T> [<D>], in time ticks, as in week7.
+   Every frame size f that meets the frame constraints (see cyclic_synthesis.h) is tried,
+   first with whole jobs and then, only if needed, with split jobs.
+   The candidates are independent of each other, so they are shared out between child processes,
+   one per processor, in the same way as concurrent_sum_03.c. A frame table is bigger than PIPE_BUF,
+   so each child has a pipe of its own, and the parent reads them in turn.
+
+   The table chosen is the one with whole jobs and the largest f, since larger frames mean fewer
+   frame interrupts, or else the one with the fewest splits. It is written in the format read by
+   ce_load_frame_table(), ready for cyclic_executive_01.
+
+   compilation advice:
+   gcc -std=gnu99 -Werror -Wall -Wextra -O2 -o cyclic_synthesis_01 cyclic_synthesis_01.c cyclic_synthesis.c cyclic_executive.c frame_wait.c trace_ring.c background_queue.c -pthread
+
+   an execution suggestion:
+   ./cyclic_synthesis_01 schedules/tasks_slide_37.txt
+   ./cyclic_synthesis_01 -j 2 schedules/tasks_slide_39.txt Slide_39_synthesised.txt
+   ./cyclic_executive_01 Slide_39_synthesised.txt
+
+   options:
+   -j n_workers   the number of child processes (default: one per processor)
+   -u us_per_tick micro-seconds per tick in the frame table (default 1000)
+   */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>    /* defines the types int64_t, for the time functions */
+#include <time.h>      /* needed for clock_gettime(), and CLOCK_MONOTONIC */
+#include <unistd.h>    /* needed for fork(), pipe(), getopt() and sysconf() */
+#include <sys/types.h>
+#include <sys/wait.h>  /* needed for wait() */
+
+#include "cyclic_executive.h"
+#include "cyclic_synthesis.h"
+
+/* One answer, as sent through a pipe from a child to the parent */
+struct candidate
+{
+    int                f;
+    int                status;
+    struct cs_stats    stats;
+    int64_t            time;  /* ns spent on this candidate */
+    struct frame_table ft;
+};
+
+/* function templates */
+static int     better(const struct candidate *a, const struct candidate *b);
+static int     read_fully(int fd, void *buffer, size_t n_bytes);
+static void    error_exit(char *s);
+static int64_t elapsed_time(void);
+
+/* Set up structures for the starting and stopping times */
+static struct timespec start, end;
+
+int main(int argc, char *argv[])
+{
+    static struct frame_table tasks;
+    static struct candidate   result, best;
+    int     f[CS_MAX_FRAME_SIZES];
+    int     n_f;
+    int     n_workers = (int) sysconf(_SC_NPROCESSORS_ONLN);
+    int     pd[CS_MAX_FRAME_SIZES][2];                   /* one pipe per worker */
+    int     found = 0;
+    int     opt;
+    int     us_per_tick = CE_TIME_TICK;
+    int     w, k, status;
+    int64_t t0;
+    FILE   *out_fp = stdout;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    while((opt = getopt(argc, argv, "j:u:")) != -1)
+        switch(opt)
+            {
+            case 'j':
+                n_workers = atoi(optarg);
+                break;
+            case 'u':
+                us_per_tick = atoi(optarg);
+                break;
+            default:
+                fprintf(stderr, "Usage is: ./cyclic_synthesis_01 [-j n_workers] [-u us_per_tick] task_file [frame_table_file]\n");
+                return EXIT_FAILURE;
+            }
+    if ((optind >= argc) || (us_per_tick <= 0))
+        {
+            fprintf(stderr, "Usage is: ./cyclic_synthesis_01 [-j n_workers] [-u us_per_tick] task_file [frame_table_file]\n");
+            return EXIT_FAILURE;
+        }
+
+    if(cs_read_tasks(argv[optind], &tasks) != 0) return EXIT_FAILURE;
+    tasks.time_tick = us_per_tick;
+
+    n_f = cs_frame_sizes(&tasks, f, CS_MAX_FRAME_SIZES);
+    printf("H = %d, %d frame sizes meet constraints 2 and 3\n\n", tasks.H, n_f);
+    if(n_f == 0) error_exit("no frame size meets the frame constraints");
+
+    if(n_workers < 1) n_workers = 1;
+    if(n_workers > n_f) n_workers = n_f;
+    fflush(stdout); /* or the children would print the buffered lines again */
+
+    /* fork() the workers, worker w takes the candidates w, w+n_workers, w+2*n_workers, ... */
+    for (w=0; w<n_workers; w++)
+        {
+            if(pipe(pd[w]) == -1) error_exit("pipe() failed");
+            if(fork()==0)
+                {
+                    (void) close(pd[w][0]);
+                    for (k=w; k<n_f; k+=n_workers)
+                        {
+                            t0 = elapsed_time();
+                            result.f      = f[k];
+                            result.status = cs_synthesise(&tasks, f[k], &result.ft, &result.stats);
+                            result.time   = elapsed_time() - t0;
+                            if(write(pd[w][1], &result, sizeof(result)) != (ssize_t) sizeof(result))
+                                error_exit("write() failed");
+                        }
+                    exit(0);
+                }
+            (void) close(pd[w][1]);
+        }
+
+    /* parent: collect the answers, in the order of the candidates, largest f first */
+    printf("f\tframes\tresult\t\tsplits\tB&B nodes\tus\n");
+    for (k=0; k<n_f; k++)
+        {
+            if(read_fully(pd[k % n_workers][0], &result, sizeof(result)) != 0)
+                error_exit("read() failed, a worker has died");
+
+            printf("%d\t%d\t%-16s%d\t%ld%s\t\t%ld\n", result.f, result.ft.n_frames, cs_status_name(result.status),
+                   result.stats.n_splits, result.stats.n_nodes, result.stats.gave_up ? "+" : "",
+                   (long) (result.time/1000));
+
+            if((result.status == CS_WHOLE_JOBS) | (result.status == CS_SPLIT_JOBS))
+                if(!found || better(&result, &best))
+                    {
+                        best  = result;
+                        found = 1;
+                    }
+        }
+
+    for (w=0; w<n_workers; w++)
+        {
+            (void) close(pd[w][0]);
+            if (wait(&status) < 0)
+                perror ("wait error");
+        }
+
+    if(!found) error_exit("there is no cyclic schedule, for any frame size");
+
+    printf("\nchosen: f = %d, %s\n", best.f, cs_status_name(best.status));
+    if(ce_check_frame_table(&best.ft, stdout) != 0) error_exit("the chosen frame table fails its own check");
+    printf("\n");
+
+    if(optind+1 < argc)
+        {
+            out_fp = fopen(argv[optind+1], "w");
+            if(!out_fp)
+                {
+                    perror("File opening failed");
+                    return EXIT_FAILURE;
+                }
+        }
+    fprintf(out_fp, "# synthesised from %s\n", argv[optind]);
+    ce_write_frame_table(&best.ft, out_fp);
+    if(out_fp != stdout) fclose(out_fp);
+
+    return EXIT_SUCCESS;
+}
+
+/*-----------------------------------------------------------------------------*/
+
+/* 1 if a is a better schedule than b: whole jobs, then the fewest splits, then the largest f */
+static int better(const struct candidate *a, const struct candidate *b)
+{
+    if(a->status != b->status) return a->status < b->status;
+    if(a->stats.n_splits != b->stats.n_splits) return a->stats.n_splits < b->stats.n_splits;
+    return a->f > b->f;
+}
+
+/*-----------------------------------------------------------------------------*/
+
+/* read() until n_bytes have arrived, since a pipe delivers at most PIPE_BUF at a time */
+static int read_fully(int fd, void *buffer, size_t n_bytes)
+{
+    char   *p = (char *) buffer;
+    ssize_t n;
+
+    while(n_bytes > 0)
+        {
+            n = read(fd, p, n_bytes);
+            if(n <= 0) return 1;
+            p       += n;
+            n_bytes -= (size_t) n;
+        }
+    return 0;
+}
+
+/*-----------------------------------------------------------------------------*/
+
+/* A standard formatter for printing eror messages, and exiting */
+static void error_exit(char *s)
+{
+    fprintf(stderr, "\nerror: %s - bye!\n",s);
+    exit(1);
+}
+
+/*-----------------------------------------------------------------------------*/
+
+/* determine the elapsed time, since the program was started, in ns */
+static int64_t elapsed_time(void)
+{
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    return (int64_t) ((end.tv_sec * 1000000000) + end.tv_nsec) -
+           ((start.tv_sec * 1000000000) + start.tv_nsec);
+}
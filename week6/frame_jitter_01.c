@@ -0,0 +1,387 @@
+/* frame_jitter_01.c */
+
+/* How accurately does the executive hit its frame boundaries? Numbers, rather than the
+   tab-spaced printout of the slides.
+
+   Any frame table is run for a number of major cycles, and at every boundary the time at which
+   the next frame really began is recorded, against target_time, the boundary itself: the lateness.
+   The start and end of every job are recorded too, in the trace ring, relative to the boundary
+   of the frame that they were dispatched in, which is the release jitter and the completion
+   jitter of the task.
+   The tasks burn the CPU time of their ticks (see workload.c), so the processor is really loaded.
+
+   The whole run is repeated for each wait strategy given with -w, and each CPU given with -c,
+   one after the other, so that they can be compared under the same conditions.
+   For each run a table of percentiles is printed, and with -o, the boundary lateness of every
+   run is written to a histogram file, one column per run, ready for gnuplot or a spreadsheet.
+
+   compilation advice:
+   gcc -std=gnu99 -Werror -Wall -Wextra -O2 -o frame_jitter_01 frame_jitter_01.c cyclic_executive.c frame_wait.c trace_ring.c background_queue.c workload.c -pthread
+
+   an execution suggestion:
+   ./frame_jitter_01 schedules/Slide_41.txt
+   ./frame_jitter_01 -n 20 -w spin,sleep,hybrid -o jitter.txt schedules/Slide_37_2.txt
+   ./frame_jitter_01 -w hybrid -c -,0,1 schedules/Slide_29.txt
+
+   options:
+   -n n_loops            major cycles in each run (default 10)
+   -w spin,sleep,hybrid  the wait strategies to compare (default spin)
+   -c -,0,1,...          the CPUs to pin the executive to, in turn, - for no pinning (default -)
+   -k compute|memory|cache
+                         the CPU-burn kernel of the tasks (default compute)
+   -o histogram_file     write a histogram of the boundary lateness of every run
+   -b bin_ns             the width of a histogram bin (default 1000 ns)
+   */
+
+#define _GNU_SOURCE    /* needed for CPU_SET() and sched_setaffinity() */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>    /* defines some types, including: int64_t */
+#include <sched.h>     /* needed for sched_setaffinity() */
+#include <unistd.h>    /* needed for getopt() */
+
+#include "cyclic_executive.h"
+#include "workload.h"
+
+#define MAX_RUNS            16   /* strategies times CPUs */
+#define NO_PINNING          -1
+#define N_BINS             200   /* histogram bins, the last also counts everything beyond */
+#define CALIBRATION_SAMPLES 200  /* clock_nanosleep() wake-ups to measure, for the hybrid margin */
+
+#define USAGE "Usage is: ./frame_jitter_01 [-n n_loops] [-w spin,sleep,hybrid] [-c -,0,1,...] [-k compute|memory|cache] [-o histogram_file] [-b bin_ns] frame_table_file\n"
+
+/* one run, of one strategy on one CPU */
+struct run
+{
+    int      strategy;
+    int      cpu;                    /* NO_PINNING, or the CPU to pin to */
+    long     n_boundaries;
+    int64_t *lateness;               /* for each boundary, when the next frame began, after the boundary */
+    long     n_jobs[CE_MAX_TASKS];
+    int64_t *start[CE_MAX_TASKS];    /* for each job, its start, and its end, after the boundary of its frame */
+    int64_t *end[CE_MAX_TASKS];
+    long     n_overruns;
+};
+
+/* function templates */
+static void    run_once(const struct frame_table *ft, struct run *run, int kernel, int n_loops, int64_t margin);
+static void    task_burn(struct cyclic_executive *ce, int task, int ticks);
+static void    frame_start(struct cyclic_executive *ce, void *arg);
+static void    print_header(const char *title);
+static void    print_percentiles(const char *name, int64_t *x, long n);
+static void    write_histogram(const char *file_name, struct run *run, int n_runs, int64_t bin_ns);
+static int     parse_list(char *list, int *item, int max_items, int (*parse)(const char *));
+static int     parse_cpu(const char *s);
+static int     compare_int64(const void *a, const void *b);
+static void   *allocate(size_t size);
+static void    error_exit(char *s);
+
+int main(int argc, char *argv[])
+{
+    static struct frame_table ft;
+    static struct run run[MAX_RUNS];
+    int     strategy[MAX_RUNS] = { FW_SPIN };
+    int     cpu[MAX_RUNS]      = { NO_PINNING };
+    int     n_strategies = 1, n_cpus = 1, n_runs = 0;
+    int     n_loops  = 10;
+    int     kernel   = WL_COMPUTE;
+    char   *histogram_file = NULL;
+    int64_t bin_ns   = 1000;
+    int64_t margin   = 0;
+    char    name[64];
+    int     opt;
+    int     r, s, c, i;
+
+    while((opt = getopt(argc, argv, "n:w:c:k:o:b:")) != -1)
+        switch(opt)
+            {
+            case 'n':
+                n_loops = atoi(optarg);
+                break;
+            case 'w':
+                n_strategies = parse_list(optarg, strategy, MAX_RUNS, fw_strategy_from_name);
+                break;
+            case 'c':
+                n_cpus = parse_list(optarg, cpu, MAX_RUNS, parse_cpu);
+                break;
+            case 'k':
+                kernel = wl_kernel_from_name(optarg);
+                break;
+            case 'o':
+                histogram_file = optarg;
+                break;
+            case 'b':
+                bin_ns = atol(optarg);
+                break;
+            default:
+                fprintf(stderr, USAGE);
+                return EXIT_FAILURE;
+            }
+    if((argc != optind+1) || (n_loops < 1) || (n_strategies < 1) || (n_cpus < 1) || (kernel < 0) || (bin_ns < 1)
+            || (n_strategies * n_cpus > MAX_RUNS))
+        {
+            fprintf(stderr, USAGE);
+            return EXIT_FAILURE;
+        }
+    if(ce_load_frame_table(argv[optind], &ft) != 0) return EXIT_FAILURE;
+
+    for (s=0; s<n_strategies; s++)
+        if(strategy[s] == FW_HYBRID) margin = fw_calibrate(CALIBRATION_SAMPLES);
+
+    printf("%s: f = %d ticks, %d frames, %d major cycles per run\n", argv[optind], ft.f, ft.n_frames, n_loops);
+    for (s=0; s<n_strategies; s++)
+        for (c=0; c<n_cpus; c++)
+            {
+                run[n_runs].strategy = strategy[s];
+                run[n_runs].cpu      = cpu[c];
+                run_once(&ft, &run[n_runs], kernel, n_loops, margin);
+                n_runs++;
+            }
+
+    for (r=0; r<n_runs; r++)
+        {
+            if(run[r].cpu == NO_PINNING)
+                printf("\n%s, not pinned, overruns %ld\n", fw_strategy_name(run[r].strategy), run[r].n_overruns);
+            else
+                printf("\n%s, on CPU %d, overruns %ld\n", fw_strategy_name(run[r].strategy), run[r].cpu, run[r].n_overruns);
+            print_header("ns after the boundary");
+            print_percentiles("boundary", run[r].lateness, run[r].n_boundaries);
+            for (i=0; i<ft.n_tasks; i++)
+                {
+                    snprintf(name, sizeof(name), "%s start", ft.task[i].label);
+                    print_percentiles(name, run[r].start[i], run[r].n_jobs[i]);
+                    snprintf(name, sizeof(name), "%s end", ft.task[i].label);
+                    print_percentiles(name, run[r].end[i], run[r].n_jobs[i]);
+                }
+        }
+
+    /* the tables have sorted the data, which leaves the histogram the same */
+    if(histogram_file != NULL) write_histogram(histogram_file, run, n_runs, bin_ns);
+
+    for (r=0; r<n_runs; r++)
+        {
+            free(run[r].lateness);
+            for (i=0; i<ft.n_tasks; i++)
+                {
+                    free(run[r].start[i]);
+                    free(run[r].end[i]);
+                }
+        }
+    return EXIT_SUCCESS;
+}
+
+/*-----------------------------------------------------------------------------*/
+
+/* One run: pin, if asked, run the executive, and sort out what the trace ring recorded */
+static void run_once(const struct frame_table *ft, struct run *run, int kernel, int n_loops, int64_t margin)
+{
+    struct cyclic_executive ce;
+    struct trace_ring       trace;
+    struct trace_record     record;
+    struct workload         workload;
+    cpu_set_t               old_cpus, cpus;
+    struct timespec         start;
+    long    n_frames = (long) n_loops * ft->n_frames;
+    int64_t frame_ns = (int64_t) ft->f * ft->time_tick * 1000;
+    int64_t boundary;
+    size_t  n_max;
+    int     i;
+
+    /* room for every boundary, and every job */
+    run->lateness = (int64_t *) allocate((size_t) (n_frames + 1) * sizeof(int64_t));
+    for (i=0; i<ft->n_tasks; i++)
+        {
+            run->start[i] = (int64_t *) allocate((size_t) n_frames * CE_MAX_JOBS * sizeof(int64_t));
+            run->end[i]   = (int64_t *) allocate((size_t) n_frames * CE_MAX_JOBS * sizeof(int64_t));
+        }
+    n_max = (size_t) n_frames * CE_MAX_JOBS;
+    if(tr_init(&trace, n_max) != 0) error_exit("out of memory for the trace");
+
+    if(run->cpu != NO_PINNING)
+        {
+            (void) sched_getaffinity(0, sizeof(old_cpus), &old_cpus);
+            CPU_ZERO(&cpus);
+            CPU_SET(run->cpu, &cpus);
+            if(sched_setaffinity(0, sizeof(cpus), &cpus) != 0) error_exit("unable to pin to that CPU");
+        }
+    if(wl_init(&workload, kernel) != 0) error_exit("out of memory for the workload");
+
+    ce_init(&ce, ft, task_burn);
+    fw_init(&ce.wait, run->strategy, margin);
+    ce.trace      = &trace;
+    ce.user_data  = &workload;
+    ce.frame_sync = frame_start;
+    ce.sync_arg   = run;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    ce_run_frames(&ce, &start, n_frames);
+    run->lateness[n_frames] = ce_elapsed_time(&ce) - n_frames * frame_ns; /* the last boundary */
+    run->n_boundaries = n_frames;
+    run->n_overruns   = ce.n_overruns;
+
+    if(run->cpu != NO_PINNING) (void) sched_setaffinity(0, sizeof(old_cpus), &old_cpus);
+    wl_free(&workload);
+
+    /* each job, against the boundary at the start of the frame it was dispatched in, so that
+       a job that an overrun has pushed into a later frame shows as late, by more than a frame */
+    while(tr_get(&trace, &record))
+        {
+            boundary = record.frame_no * frame_ns;
+            i = record.task;
+            run->start[i][run->n_jobs[i]] = record.start_ns - boundary;
+            run->end[i][run->n_jobs[i]]   = record.end_ns - boundary;
+            run->n_jobs[i]++;
+        }
+    tr_free(&trace);
+
+    /* lateness[0] is the start itself, not a boundary */
+    memmove(run->lateness, run->lateness + 1, (size_t) n_frames * sizeof(int64_t));
+}
+
+/*-----------------------------------------------------------------------------*/
+
+/* Every task burns the CPU time of its ticks */
+static void task_burn(struct cyclic_executive *ce, int task, int ticks)
+{
+    (void) task;
+    (void) wl_burn((struct workload *) ce->user_data, (int64_t) ticks * ce->ft->time_tick * 1000);
+}
+
+/*-----------------------------------------------------------------------------*/
+
+/* At the start of each frame, note how far past its boundary it really began */
+static void frame_start(struct cyclic_executive *ce, void *arg)
+{
+    struct run *run = (struct run *) arg;
+    int64_t frame_ns = (int64_t) ce->ft->f * ce->ft->time_tick * 1000;
+
+    run->lateness[ce->frame_no] = ce_elapsed_time(ce) - ce->frame_no * frame_ns;
+}
+
+/*-----------------------------------------------------------------------------*/
+
+static void print_header(const char *title)
+{
+    printf("%-24s %8s %10s %10s %10s %10s %10s %10s %10s\n", title, "n", "min", "mean", "50%", "90%", "99%", "99.9%", "max");
+}
+
+/*-----------------------------------------------------------------------------*/
+
+/* One line of the table, the data are sorted in place */
+static void print_percentiles(const char *name, int64_t *x, long n)
+{
+    static const double level[4] = { 0.50, 0.90, 0.99, 0.999 };
+    int64_t sum = 0;
+    long    k;
+    int     j;
+
+    if(n == 0) return;
+    qsort(x, (size_t) n, sizeof(int64_t), compare_int64);
+    for (k=0; k<n; k++) sum += x[k];
+
+    printf("%-24s %8ld %10ld %10ld", name, n, (long) x[0], (long) (sum / n));
+    for (j=0; j<4; j++) printf(" %10ld", (long) x[(long) (level[j] * (double) (n-1) + 0.5)]);
+    printf(" %10ld\n", (long) x[n-1]);
+}
+
+/*-----------------------------------------------------------------------------*/
+
+/* The boundary lateness of every run, counted in bins of bin_ns, one column per run.
+   Early returns, which only happen if the clock steps, are counted in the first bin. */
+static void write_histogram(const char *file_name, struct run *run, int n_runs, int64_t bin_ns)
+{
+    static long count[MAX_RUNS][N_BINS];
+    FILE   *fp;
+    int64_t bin;
+    long    k;
+    int     r, b;
+
+    for (r=0; r<n_runs; r++)
+        for (k=0; k<run[r].n_boundaries; k++)
+            {
+                bin = run[r].lateness[k] / bin_ns;
+                if(bin < 0) bin = 0;
+                if(bin >= N_BINS) bin = N_BINS-1;
+                count[r][bin]++;
+            }
+
+    fp = fopen(file_name, "w");
+    if(fp == NULL) error_exit("unable to open the histogram file");
+    fprintf(fp, "# boundary lateness, in bins of %ld ns, the last bin counts everything beyond it\n# ns", (long) bin_ns);
+    for (r=0; r<n_runs; r++)
+        {
+            if(run[r].cpu == NO_PINNING)
+                fprintf(fp, "\t%s", fw_strategy_name(run[r].strategy));
+            else
+                fprintf(fp, "\t%s/cpu%d", fw_strategy_name(run[r].strategy), run[r].cpu);
+        }
+    fprintf(fp, "\n");
+    for (b=0; b<N_BINS; b++)
+        {
+            fprintf(fp, "%ld", (long) (b * bin_ns));
+            for (r=0; r<n_runs; r++) fprintf(fp, "\t%ld", count[r][b]);
+            fprintf(fp, "\n");
+        }
+    fclose(fp);
+    printf("\nhistogram written to %s\n", file_name);
+}
+
+/*-----------------------------------------------------------------------------*/
+
+/* A comma-separated list, each item through parse(), returns the number of items, or 0 if any is wrong */
+static int parse_list(char *list, int *item, int max_items, int (*parse)(const char *))
+{
+    char *token;
+    int   n = 0;
+
+    for (token=strtok(list, ","); token != NULL; token=strtok(NULL, ","))
+        {
+            if(n == max_items) return 0;
+            item[n] = parse(token);
+            if(item[n] < NO_PINNING) return 0;
+            if((item[n] == NO_PINNING) && (parse != parse_cpu)) return 0; /* -1 is an error from the others */
+            n++;
+        }
+    return n;
+}
+
+/*-----------------------------------------------------------------------------*/
+
+/* "-" for no pinning, or a CPU number */
+static int parse_cpu(const char *s)
+{
+    if(strcmp(s, "-") == 0) return NO_PINNING;
+    if((*s < '0') || (*s > '9')) return -2;
+    return atoi(s);
+}
+
+/*-----------------------------------------------------------------------------*/
+
+static int compare_int64(const void *a, const void *b)
+{
+    int64_t x = *(const int64_t *) a;
+    int64_t y = *(const int64_t *) b;
+
+    return (x > y) - (x < y);
+}
+
+/*-----------------------------------------------------------------------------*/
+
+static void *allocate(size_t size)
+{
+    void *p = calloc(1, size);
+
+    if(p == NULL) error_exit("out of memory");
+    return p;
+}
+
+/*-----------------------------------------------------------------------------*/
+
+/* A standard formatter for printing eror messages, and exiting */
+static void error_exit(char *s)
+{
+    fprintf(stderr, "\nerror: %s - bye!\n",s);
+    exit(1);
+}
@@ -0,0 +1,201 @@
+/* frame_wait.c */
+
+/* Waiting for the end of a minor frame, by spinning, sleeping, or both, see frame_wait.h */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>     /* needed for EINTR */
+#include <stdint.h>    /* defines some types, including: int64_t */
+#include <time.h>      /* needed for clock_gettime(), clock_nanosleep() and the clocks */
+
+#include "frame_wait.h"
+
+#define CALIBRATION_SLEEP  200000  /* ns, each calibration sleep is this long */
+#define CALIBRATION_GUARD   20000  /* ns, added to the measured latency, to be safe */
+#define CALIBRATION_LEVEL    0.99  /* the fraction of wake-ups that the margin should cover */
+#define MAX_MARGIN         500000  /* ns, one long pre-emption should not turn the hybrid into a spin */
+
+/* function templates, for local helpers */
+static int64_t ns_of(const struct timespec *t);
+static void    timespec_of(int64_t ns, struct timespec *t);
+static int64_t clock_ns(clockid_t clock);
+static int     compare_int64(const void *a, const void *b);
+
+/*-----------------------------------------------------------------------------*/
+
+void fw_init(struct frame_wait *fw, int strategy, int64_t margin_ns)
+{
+    memset(fw, 0, sizeof(*fw));
+    fw->strategy  = strategy;
+    fw->margin_ns = margin_ns;
+}
+
+/*-----------------------------------------------------------------------------*/
+
+int64_t fw_calibrate(int n_samples)
+{
+    int64_t *overshoot;
+    int64_t  target;
+    int64_t  margin;
+    struct timespec t;
+    int      i;
+
+    if(n_samples < 1) n_samples = 1;
+    overshoot = (int64_t *) malloc((size_t) n_samples * sizeof(int64_t));
+    if(overshoot == NULL) return CALIBRATION_SLEEP; /* a generous guess */
+
+    for (i=0; i<n_samples; i++)
+        {
+            target = clock_ns(CLOCK_MONOTONIC) + CALIBRATION_SLEEP;
+            timespec_of(target, &t);
+            while(clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &t, NULL) == EINTR); /* again, if interrupted */
+            overshoot[i] = clock_ns(CLOCK_MONOTONIC) - target;
+        }
+
+    qsort(overshoot, (size_t) n_samples, sizeof(int64_t), compare_int64);
+    margin = overshoot[(int) (CALIBRATION_LEVEL * (double) (n_samples-1))] + CALIBRATION_GUARD;
+
+    free(overshoot);
+    return margin;
+}
+
+/*-----------------------------------------------------------------------------*/
+
+void fw_wait_until(struct frame_wait *fw, const struct timespec *base, int64_t target_ns)
+{
+    struct timespec t;
+    int64_t target = ns_of(base) + target_ns; /* on the CLOCK_MONOTONIC time-line */
+    int64_t now    = clock_ns(CLOCK_MONOTONIC);
+    int64_t cpu    = clock_ns(CLOCK_THREAD_CPUTIME_ID);
+    int64_t began  = now;
+    int64_t lateness;
+    long    l      = 0; /* a dummy counter, just for the busy loop */
+
+    if(now >= target)
+        fw->n_late++;  /* the work overran the frame, there is nothing to wait for */
+    else
+        switch(fw->strategy)
+            {
+            case FW_SLEEP:
+                timespec_of(target, &t);
+                while(clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &t, NULL) == EINTR);
+                now = clock_ns(CLOCK_MONOTONIC);
+                break;
+
+            case FW_HYBRID:
+                if(target - now > fw->margin_ns)
+                    {
+                        timespec_of(target - fw->margin_ns, &t);
+                        while(clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &t, NULL) == EINTR);
+                        now = clock_ns(CLOCK_MONOTONIC);
+                        if(now >= target)
+                            {
+                                /* the margin was too small, so move it a quarter of the way to the latency just seen */
+                                fw->n_overslept++;
+                                fw->margin_ns += (now - (target - fw->margin_ns) + CALIBRATION_GUARD - fw->margin_ns) / 4;
+                                if(fw->margin_ns > MAX_MARGIN) fw->margin_ns = MAX_MARGIN;
+                            }
+                    }
+                while(now < target)
+                    {
+                        now = clock_ns(CLOCK_MONOTONIC);
+                        l++;
+                    }
+                break;
+
+            default: /* FW_SPIN */
+                while(now < target)
+                    {
+                        now = clock_ns(CLOCK_MONOTONIC);
+                        l++;
+                    }
+                break;
+            }
+    (void) l;
+
+    lateness = now - target;
+    fw->n_waits++;
+    fw->sum_lateness += lateness;
+    if(lateness > fw->max_lateness) fw->max_lateness = lateness;
+    fw->sum_wait_ns  += now - began;
+    fw->sum_cpu_ns   += clock_ns(CLOCK_THREAD_CPUTIME_ID) - cpu;
+}
+
+/*-----------------------------------------------------------------------------*/
+
+void fw_report(const struct frame_wait *fw, FILE *fp)
+{
+    long n = (fw->n_waits > 0) ? fw->n_waits : 1;
+
+    fprintf(fp, "frame wait: %s", fw_strategy_name(fw->strategy));
+    if(fw->strategy == FW_HYBRID) fprintf(fp, ", margin %ld us", (long) (fw->margin_ns/1000));
+    fprintf(fp, "\n");
+    fprintf(fp, "frames %ld, late %ld, overslept %ld\n", fw->n_waits, fw->n_late, fw->n_overslept);
+    fprintf(fp, "boundary lateness: mean %ld ns, max %ld ns\n",
+            (long) (fw->sum_lateness/n), (long) fw->max_lateness);
+    fprintf(fp, "per frame: wait %ld us, CPU %ld us (%.1f%% of the wait)\n",
+            (long) (fw->sum_wait_ns/n/1000), (long) (fw->sum_cpu_ns/n/1000),
+            (fw->sum_wait_ns > 0) ? 100.0 * (double) fw->sum_cpu_ns / (double) fw->sum_wait_ns : 0.0);
+}
+
+/*-----------------------------------------------------------------------------*/
+
+int fw_strategy_from_name(const char *name)
+{
+    if(strcmp(name, "spin")   == 0) return FW_SPIN;
+    if(strcmp(name, "sleep")  == 0) return FW_SLEEP;
+    if(strcmp(name, "hybrid") == 0) return FW_HYBRID;
+    return -1;
+}
+
+/*-----------------------------------------------------------------------------*/
+
+const char *fw_strategy_name(int strategy)
+{
+    switch(strategy)
+        {
+        case FW_SLEEP:
+            return "sleep";
+        case FW_HYBRID:
+            return "hybrid";
+        default:
+            return "spin";
+        }
+}
+
+/*-----------------------------------------------------------------------------*/
+
+static int64_t ns_of(const struct timespec *t)
+{
+    return (int64_t) t->tv_sec * 1000000000 + t->tv_nsec;
+}
+
+/*-----------------------------------------------------------------------------*/
+
+static void timespec_of(int64_t ns, struct timespec *t)
+{
+    t->tv_sec  = (time_t) (ns / 1000000000);
+    t->tv_nsec = (long) (ns % 1000000000);
+}
+
+/*-----------------------------------------------------------------------------*/
+
+static int64_t clock_ns(clockid_t clock)
+{
+    struct timespec t;
+
+    clock_gettime(clock, &t);
+    return ns_of(&t);
+}
+
+/*-----------------------------------------------------------------------------*/
+
+static int compare_int64(const void *a, const void *b)
+{
+    int64_t x = *(const int64_t *) a;
+    int64_t y = *(const int64_t *) b;
+
+    return (x > y) - (x < y);
+}
+/*-----------------------------------------------------------------------------*/
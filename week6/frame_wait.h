@@ -0,0 +1,59 @@
+/* frame_wait.h */
+
+/* Waiting for the end of a minor frame.
+
+   The slides wait with a pure busy loop, while (elapsed_time() < target_time) l++;
+   which is accurate, but burns the processor for all of the slack in every frame.
+   Sleeping with clock_nanosleep(TIMER_ABSTIME) costs almost nothing, but the wake-up is late,
+   by the timer slack and the scheduling latency, typically tens of micro-seconds.
+
+   The hybrid strategy sleeps until a margin before the boundary, and spins for the rest.
+   The margin is measured, by fw_calibrate(), from the wake-up latency actually observed,
+   and is widened, a step at a time, whenever a wake-up lands after the boundary.
+   The statistics show how close to the boundary each wait returned, and how much CPU time
+   it used, so that the three strategies can be compared. */
+
+#ifndef FRAME_WAIT_H
+#define FRAME_WAIT_H
+
+#include <stdio.h>
+#include <stdint.h>    /* defines some types, including: int64_t */
+#include <time.h>      /* needed for struct timespec */
+
+#define FW_SPIN   0  /* a busy loop, as in the slides */
+#define FW_SLEEP  1  /* clock_nanosleep() to the boundary */
+#define FW_HYBRID 2  /* clock_nanosleep() to margin_ns before the boundary, then a busy loop */
+
+struct frame_wait
+{
+    int     strategy;
+    int64_t margin_ns;     /* how early the hybrid strategy wakes up, it never shrinks */
+
+    /* statistics, over all the waits so far */
+    long    n_waits;
+    long    n_late;        /* the boundary had already passed, when the wait began */
+    long    n_overslept;   /* the hybrid sleep woke up after the boundary, the margin was too small */
+    int64_t sum_lateness;  /* the time of return, after the boundary, ns */
+    int64_t max_lateness;
+    int64_t sum_wait_ns;   /* the wall-clock time spent waiting */
+    int64_t sum_cpu_ns;    /* the CPU time spent waiting, by CLOCK_THREAD_CPUTIME_ID */
+};
+
+/* set up a wait, with a strategy and a margin (only used by FW_HYBRID), and clear the statistics */
+void        fw_init(struct frame_wait *fw, int strategy, int64_t margin_ns);
+
+/* measure the wake-up latency of clock_nanosleep(), n_samples times,
+   and return a margin that covers all but the worst 1% of them, with some to spare */
+int64_t     fw_calibrate(int n_samples);
+
+/* wait until target_ns after the time *base, on CLOCK_MONOTONIC */
+void        fw_wait_until(struct frame_wait *fw, const struct timespec *base, int64_t target_ns);
+
+/* print the accuracy, and the CPU time used per wait */
+void        fw_report(const struct frame_wait *fw, FILE *fp);
+
+/* "spin", "sleep" or "hybrid" to a FW_ code, or -1 */
+int         fw_strategy_from_name(const char *name);
+const char *fw_strategy_name(int strategy);
+
+#endif /* FRAME_WAIT_H */
@@ -0,0 +1,123 @@
+/* generated_executive.c */
+
+/* The run-time support for generated cyclic executives, see generated_executive.h */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>    /* defines some types, including: int64_t */
+#include <time.h>      /* needed for clock_gettime() */
+#include <unistd.h>    /* needed for getopt() */
+
+#include "generated_executive.h"
+#include "frame_wait.h"
+#include "workload.h"
+
+#define CALIBRATION_SAMPLES 200 /* clock_nanosleep() wake-ups to measure, for the hybrid margin */
+
+#define USAGE "Usage is: %s [-w spin|sleep|hybrid] [-k compute|memory|cache] [n_loops]\n"
+
+/* the state of the run, there is only one executive in a program */
+static struct timespec   start;
+static struct frame_wait wait;
+static struct workload   workload;
+static long              count[GE_MAX_TASKS];
+static long              n_overruns;
+static long              overruns[GE_MAX_FRAMES];
+
+/* function templates, for local helpers */
+static int64_t elapsed_time(void);
+
+/*-----------------------------------------------------------------------------*/
+
+void ge_job(int task, int64_t ns)
+{
+    count[task]++;
+    (void) wl_burn(&workload, ns);
+}
+
+/*-----------------------------------------------------------------------------*/
+
+void ge_frame_end(int frame, int64_t target_ns)
+{
+    if(elapsed_time() >= target_ns)
+        {
+            n_overruns++;
+            overruns[frame]++;
+        }
+    fw_wait_until(&wait, &start, target_ns);
+}
+
+/*-----------------------------------------------------------------------------*/
+
+int ge_main(int argc, char *argv[], const struct ge_schedule *schedule)
+{
+    int     strategy = FW_SPIN;
+    int     kernel   = WL_COMPUTE;
+    int     n_loops  = 1;
+    int64_t margin   = 0;
+    long    loop;
+    int     opt;
+    int     i;
+
+    while((opt = getopt(argc, argv, "w:k:")) != -1)
+        switch(opt)
+            {
+            case 'w':
+                strategy = fw_strategy_from_name(optarg);
+                break;
+            case 'k':
+                kernel = wl_kernel_from_name(optarg);
+                break;
+            default:
+                fprintf(stderr, USAGE, argv[0]);
+                return EXIT_FAILURE;
+            }
+    if(argc > optind) n_loops = atoi(argv[optind]);
+    if((strategy < 0) || (kernel < 0) || (n_loops < 1))
+        {
+            fprintf(stderr, USAGE, argv[0]);
+            return EXIT_FAILURE;
+        }
+
+    if(wl_init(&workload, kernel) != 0)
+        {
+            fprintf(stderr, "error: out of memory for the workload\n");
+            return EXIT_FAILURE;
+        }
+    if(strategy == FW_HYBRID) margin = fw_calibrate(CALIBRATION_SAMPLES);
+    fw_init(&wait, strategy, margin);
+
+    printf("%s: f = %ld us, H = %ld us, %d frames, %d major cycles\n", schedule->name,
+           (long) (schedule->frame_ns/1000), (long) (schedule->major_ns/1000), schedule->n_frames, n_loops);
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (loop=0; loop<n_loops; loop++)
+        schedule->major_cycle(loop * schedule->major_ns);
+
+    for (i=0; i<schedule->n_tasks; i++)
+        printf("%s:\t%ld jobs\n", schedule->label[i], count[i]);
+    fw_report(&wait, stdout);
+    printf("overruns %ld\n", n_overruns);
+    if(n_overruns > 0)
+        {
+            printf("overruns by frame:");
+            for (i=0; i<schedule->n_frames; i++)
+                if(overruns[i] > 0) printf(" %d:%ld", i, overruns[i]);
+            printf("\n");
+        }
+    wl_report(&workload, stdout);
+    wl_free(&workload);
+    return EXIT_SUCCESS;
+}
+
+/*-----------------------------------------------------------------------------*/
+
+/* ns since the start of the run */
+static int64_t elapsed_time(void)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (int64_t) (now.tv_sec - start.tv_sec) * 1000000000 + (now.tv_nsec - start.tv_nsec);
+}
+/*-----------------------------------------------------------------------------*/
@@ -0,0 +1,46 @@
+/* generated_executive.h */
+
+/* The run-time support for the cyclic executives generated by cyclic_generate.
+
+   A generated executive has no frame table, and no loop over jobs: cyclic_generate turns each
+   frame table into one C function per major cycle, a straight line of calls, ge_job(task, ns)
+   for each job and ge_frame_end(frame, target_ns) at the end of each minor frame, with every
+   argument a constant, folded in when the file was generated. All that is left here is the body
+   of the tasks, which burn the CPU time of their ticks (see workload.c), and the wait for each
+   boundary (see frame_wait.c).
+
+   The generated file names its schedule in a struct ge_schedule, and its main() calls ge_main(). */
+
+#ifndef GENERATED_EXECUTIVE_H
+#define GENERATED_EXECUTIVE_H
+
+#include <stdint.h>    /* defines some types, including: int64_t */
+
+#define GE_MAX_TASKS   8   /* the same limits as cyclic_executive.h */
+#define GE_MAX_FRAMES 64
+
+/* one major cycle, with the frame boundaries at base_ns + constant, ns since the start */
+typedef void (*ge_cycle_function)(int64_t base_ns);
+
+struct ge_schedule
+{
+    const char        *name;
+    int64_t            frame_ns;
+    int64_t            major_ns;
+    int                n_frames;
+    int                n_tasks;
+    const char *const *label;        /* n_tasks of them */
+    ge_cycle_function  major_cycle;
+};
+
+/* run one job of a task, for ns of CPU time */
+void ge_job(int task, int64_t ns);
+
+/* the end of a minor frame: note an overrun, if there is one, and wait for the boundary */
+void ge_frame_end(int frame, int64_t target_ns);
+
+/* parse the options, [-w spin|sleep|hybrid] [-k compute|memory|cache] [n_loops],
+   run the schedule, and report. Returns the exit status for main(). */
+int  ge_main(int argc, char *argv[], const struct ge_schedule *schedule);
+
+#endif /* GENERATED_EXECUTIVE_H */
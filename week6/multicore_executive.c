@@ -0,0 +1,254 @@
+/* multicore_executive.c */
+
+/* A cyclic executive on several cores, with the frames kept in step by a barrier,
+   see multicore_executive.h */
+
+#define _GNU_SOURCE    /* needed for CPU_SET() and pthread_setaffinity_np() */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>    /* needed for INT_MAX */
+#include <errno.h>     /* needed for EINTR */
+#include <sched.h>     /* needed for cpu_set_t */
+#include <unistd.h>    /* needed for syscall() and sysconf() */
+#include <sys/syscall.h>
+#include <linux/futex.h>
+#include <pthread.h>
+
+#include "multicore_executive.h"
+
+#define START_DELAY 20000000 /* ns, time for every worker to be created and pinned before the first frame */
+
+/* function templates, for local helpers */
+static void *worker(void *arg);
+static void  frame_sync(struct cyclic_executive *ce, void *arg);
+static long  futex(int *word, int op, int value);
+static int   compare_int64(const void *a, const void *b);
+
+/*-----------------------------------------------------------------------------*/
+
+void mc_barrier_init(struct mc_barrier *b, int n_threads)
+{
+    memset(b, 0, sizeof(*b));
+    b->n_threads = n_threads;
+}
+
+/*-----------------------------------------------------------------------------*/
+
+void mc_barrier_wait(struct mc_barrier *b)
+{
+    int generation = __atomic_load_n(&b->generation, __ATOMIC_ACQUIRE);
+    int i;
+
+    if(__atomic_add_fetch(&b->count, 1, __ATOMIC_ACQ_REL) == b->n_threads)
+        {
+            /* the last to arrive opens the barrier for the others. No thread can arrive
+               for the next generation until it sees this one change, so count is safe to reset first */
+            __atomic_store_n(&b->count, 0, __ATOMIC_RELAXED);
+            __atomic_store_n(&b->generation, generation + 1, __ATOMIC_SEQ_CST);
+            if(__atomic_load_n(&b->n_sleeping, __ATOMIC_SEQ_CST) > 0)
+                (void) futex(&b->generation, FUTEX_WAKE_PRIVATE, INT_MAX);
+            return;
+        }
+
+    /* spin, for a little while */
+    for (i=0; i<MC_SPIN_LIMIT; i++)
+        if(__atomic_load_n(&b->generation, __ATOMIC_ACQUIRE) != generation) return;
+
+    /* then sleep. The futex only sleeps if the generation has not changed already,
+       so a wake-up between the test and the sleep cannot be lost */
+    __atomic_add_fetch(&b->n_sleeping, 1, __ATOMIC_SEQ_CST);
+    while(__atomic_load_n(&b->generation, __ATOMIC_SEQ_CST) == generation)
+        {
+            (void) futex(&b->generation, FUTEX_WAIT_PRIVATE, generation);
+            __atomic_add_fetch(&b->n_futex_waits, 1, __ATOMIC_RELAXED);
+        }
+    __atomic_sub_fetch(&b->n_sleeping, 1, __ATOMIC_SEQ_CST);
+}
+
+/*-----------------------------------------------------------------------------*/
+
+int mc_init(struct multicore_executive *mc, int n_cores, const struct frame_table **ft,
+            ce_task_function fn, int n_loops)
+{
+    int  n_cpus = (int) sysconf(_SC_NPROCESSORS_ONLN);
+    int  max_frames = 0;
+    int  c;
+
+    memset(mc, 0, sizeof(*mc));
+    if((n_cores < 1) || (n_cores > MC_MAX_CORES) || (n_loops < 1))
+        {
+            fprintf(stderr, "mc_init(): 1 to %d cores, and a finite number of loops, please\n", MC_MAX_CORES);
+            return 1;
+        }
+    if(n_cpus < 1) n_cpus = 1;
+
+    for (c=0; c<n_cores; c++)
+        {
+            if((ft[c]->f * ft[c]->time_tick) != (ft[0]->f * ft[0]->time_tick))
+                {
+                    fprintf(stderr, "mc_init(): every frame table must have the same frame size\n");
+                    return 1;
+                }
+            if(ft[c]->n_frames > max_frames) max_frames = ft[c]->n_frames;
+        }
+
+    mc->n_cores      = n_cores;
+    mc->n_loops      = n_loops;
+    mc->n_frames_run = (long) n_loops * max_frames;
+    mc_barrier_init(&mc->barrier, n_cores);
+
+    for (c=0; c<n_cores; c++)
+        {
+            ce_init(&mc->core[c].ce, ft[c], fn);
+            mc->core[c].ce.frame_sync = frame_sync;
+            mc->core[c].ce.sync_arg   = &mc->core[c];
+            mc->core[c].cpu     = c % n_cpus;
+            mc->core[c].mc      = mc;
+            mc->core[c].release = (int64_t *) calloc((size_t) mc->n_frames_run, sizeof(int64_t));
+            if(mc->core[c].release == NULL)
+                {
+                    mc_free(mc);
+                    fprintf(stderr, "mc_init(): out of memory\n");
+                    return 1;
+                }
+        }
+    return 0;
+}
+
+/*-----------------------------------------------------------------------------*/
+
+int mc_run(struct multicore_executive *mc)
+{
+    int64_t first;
+    int     c;
+
+    for (c=0; c<mc->n_cores; c++)
+        if(mc->core[c].ce.overrun_policy == CE_OVERRUN_RESYNC)
+            {
+                fprintf(stderr, "mc_run(): the resync policy would leave the other cores waiting at a barrier\n");
+                return 1;
+            }
+
+    /* every core times its frames from here */
+    clock_gettime(CLOCK_MONOTONIC, &mc->start);
+    first = (int64_t) mc->start.tv_sec * 1000000000 + mc->start.tv_nsec + START_DELAY;
+    mc->start.tv_sec  = (time_t) (first / 1000000000);
+    mc->start.tv_nsec = (long) (first % 1000000000);
+
+    for (c=0; c<mc->n_cores; c++)
+        if(pthread_create(&mc->core[c].thread, NULL, worker, &mc->core[c]) != 0)
+            {
+                fprintf(stderr, "mc_run(): pthread_create() failed\n");
+                return 1; /* the workers already started will wait at the first barrier, for ever */
+            }
+
+    for (c=0; c<mc->n_cores; c++)
+        (void) pthread_join(mc->core[c].thread, NULL);
+    return 0;
+}
+
+/*-----------------------------------------------------------------------------*/
+
+void mc_report_skew(const struct multicore_executive *mc, FILE *fp)
+{
+    const struct cyclic_executive *ce0 = &mc->core[0].ce;
+    int64_t frame_ns = (int64_t) ce0->ft->f * ce0->ft->time_tick * 1000;
+    int64_t *skew;
+    int64_t lo, hi;
+    int64_t sum_skew = 0, sum_late = 0, max_late = 0;
+    long    k;
+    int     c;
+
+    skew = (int64_t *) malloc((size_t) mc->n_frames_run * sizeof(int64_t));
+    if(skew == NULL) return;
+
+    for (k=0; k<mc->n_frames_run; k++)
+        {
+            lo = hi = mc->core[0].release[k];
+            for (c=1; c<mc->n_cores; c++)
+                {
+                    if(mc->core[c].release[k] < lo) lo = mc->core[c].release[k];
+                    if(mc->core[c].release[k] > hi) hi = mc->core[c].release[k];
+                }
+            skew[k]   = hi - lo;
+            sum_skew += skew[k];
+            sum_late += lo - k*frame_ns;  /* the first core out, against the frame boundary */
+            if(lo - k*frame_ns > max_late) max_late = lo - k*frame_ns;
+        }
+    qsort(skew, (size_t) mc->n_frames_run, sizeof(int64_t), compare_int64);
+
+    fprintf(fp, "%d cores, %ld frames, barrier futex sleeps %ld\n",
+            mc->n_cores, mc->n_frames_run, mc->barrier.n_futex_waits);
+    fprintf(fp, "cross-core skew: mean %ld ns, median %ld ns, 99%% %ld ns, max %ld ns\n",
+            (long) (sum_skew / mc->n_frames_run), (long) skew[mc->n_frames_run/2],
+            (long) skew[(long) (0.99 * (double) (mc->n_frames_run-1))], (long) skew[mc->n_frames_run-1]);
+    fprintf(fp, "release after the boundary: mean %ld ns, max %ld ns\n",
+            (long) (sum_late / mc->n_frames_run), (long) max_late);
+    free(skew);
+}
+
+/*-----------------------------------------------------------------------------*/
+
+void mc_free(struct multicore_executive *mc)
+{
+    int c;
+
+    for (c=0; c<mc->n_cores; c++)
+        {
+            free(mc->core[c].release);
+            mc->core[c].release = NULL;
+        }
+}
+
+/*-----------------------------------------------------------------------------*/
+
+/* One worker: pinned to its core, it sleeps until the common start, and runs its executive */
+static void *worker(void *arg)
+{
+    struct mc_core *core = (struct mc_core *) arg;
+    struct multicore_executive *mc = core->mc;
+    cpu_set_t cpus;
+
+    CPU_ZERO(&cpus);
+    CPU_SET(core->cpu, &cpus);
+    if(pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus) != 0)
+        fprintf(stderr, "warning: a worker could not be pinned to core %d\n", core->cpu);
+
+    while(clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &mc->start, NULL) == EINTR);
+
+    /* the longest table runs n_loops major cycles, and the others run for as many frames */
+    ce_run_frames(&core->ce, &mc->start, mc->n_frames_run);
+    return NULL;
+}
+
+/*-----------------------------------------------------------------------------*/
+
+/* At the start of each frame: meet the other cores, and note when this one was let go */
+static void frame_sync(struct cyclic_executive *ce, void *arg)
+{
+    struct mc_core *core = (struct mc_core *) arg;
+    struct multicore_executive *mc = core->mc;
+
+    mc_barrier_wait(&mc->barrier);
+    core->release[ce->frame_no] = ce_elapsed_time(ce);
+}
+
+/*-----------------------------------------------------------------------------*/
+
+static long futex(int *word, int op, int value)
+{
+    return syscall(SYS_futex, word, op, value, NULL, NULL, 0);
+}
+
+/*-----------------------------------------------------------------------------*/
+
+static int compare_int64(const void *a, const void *b)
+{
+    int64_t x = *(const int64_t *) a;
+    int64_t y = *(const int64_t *) b;
+
+    return (x > y) - (x < y);
+}
+/*-----------------------------------------------------------------------------*/
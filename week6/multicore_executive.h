@@ -0,0 +1,82 @@
+/* multicore_executive.h */
+
+/* A cyclic executive on several cores at once.
+
+   Each core has a worker thread, pinned to it, which runs a cyclic executive of its own
+   (cyclic_executive.c), with its own frame table. The tables must share the same frame size f,
+   and tick, but each may have its own hyperperiod, so a task set that overloads one core
+   can be divided between several.
+
+   All of the executives time their frames from one common start, and at the start of every
+   minor frame the workers meet at a barrier, so that no core runs ahead into the next frame.
+   The barrier spins for a short while, which is the fast path when the cores arrive close together,
+   and then sleeps on a futex, so that a waiting worker gives up its core, if it must share one.
+
+   The time at which each core leaves the barrier is recorded, for every frame, and the spread
+   of those times across the cores is the boundary skew, reported by mc_report_skew().
+
+   The CE_OVERRUN_RESYNC policy skips whole frames, and so would skip barriers, leaving the
+   other cores waiting at them, so it is not allowed here. The other policies are. */
+
+#ifndef MULTICORE_EXECUTIVE_H
+#define MULTICORE_EXECUTIVE_H
+
+#include <stdio.h>
+#include <stdint.h>    /* defines some types, including: int64_t */
+#include <time.h>      /* needed for struct timespec */
+#include <pthread.h>
+
+#include "cyclic_executive.h"
+
+#define MC_MAX_CORES  16
+#define MC_SPIN_LIMIT 2000 /* polls of the barrier before sleeping on the futex */
+
+struct mc_barrier
+{
+    int  n_threads;
+    int  count;        /* the threads that have arrived, in this generation */
+    int  generation;   /* the futex word, it changes each time the barrier opens */
+    int  n_sleeping;   /* the threads asleep on the futex, so that it need only be woken when there are some */
+    long n_futex_waits;
+};
+
+struct multicore_executive;
+
+struct mc_core
+{
+    struct cyclic_executive     ce;
+    int                         cpu;      /* the core that this worker is pinned to */
+    pthread_t                   thread;
+    int64_t                    *release;  /* when this worker left the barrier, in each frame, ns since the start */
+    struct multicore_executive *mc;
+};
+
+struct multicore_executive
+{
+    int               n_cores;
+    struct mc_core    core[MC_MAX_CORES];
+    struct mc_barrier barrier;
+    int               n_loops;
+    long              n_frames_run;  /* the length of the release[] arrays */
+    struct timespec   start;         /* the common start of the first frame, on CLOCK_MONOTONIC */
+};
+
+/* the barrier, on its own */
+void mc_barrier_init(struct mc_barrier *b, int n_threads);
+void mc_barrier_wait(struct mc_barrier *b);
+
+/* Set up one executive per frame table, all with the same task function, and pinned in turn to
+   the cores that are online. n_loops counts the major cycles of the longest table.
+   Returns 0 on success, or non-zero with a message on stderr. */
+int  mc_init(struct multicore_executive *mc, int n_cores, const struct frame_table **ft,
+             ce_task_function fn, int n_loops);
+
+/* start the workers, with the first frame a little in the future, and wait for them all to finish */
+int  mc_run(struct multicore_executive *mc);
+
+/* print the boundary skew across the cores, and how late the first core was released */
+void mc_report_skew(const struct multicore_executive *mc, FILE *fp);
+
+void mc_free(struct multicore_executive *mc);
+
+#endif /* MULTICORE_EXECUTIVE_H */
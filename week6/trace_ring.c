@@ -0,0 +1,132 @@
+/* trace_ring.c */
+
+/* A single-producer, single-consumer trace ring, see trace_ring.h */
+
+#define _GNU_SOURCE    /* needed for SCHED_IDLE */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sched.h>     /* needed for SCHED_IDLE */
+#include <unistd.h>    /* needed for usleep() */
+#include <pthread.h>
+
+#include "trace_ring.h"
+
+#define DRAIN_PERIOD 1000 /* us, how long the drain thread sleeps when the ring is empty */
+
+/* function templates, for local helpers */
+static void *drain(void *arg);
+
+/*-----------------------------------------------------------------------------*/
+
+int tr_init(struct trace_ring *tr, size_t capacity)
+{
+    uint64_t c = 1;
+
+    memset(tr, 0, sizeof(*tr));
+    while(c < capacity) c <<= 1; /* round up to a power of two, so that the index is a mask */
+
+    /* allocate, and touch, every record now, so that no page fault lands inside a frame */
+    tr->record = (struct trace_record *) calloc((size_t) c, sizeof(struct trace_record));
+    if(tr->record == NULL) return 1;
+    memset(tr->record, 0, (size_t) c * sizeof(struct trace_record));
+
+    tr->capacity = c;
+    tr->mask     = c - 1;
+    return 0;
+}
+
+/*-----------------------------------------------------------------------------*/
+
+void tr_free(struct trace_ring *tr)
+{
+    free(tr->record);
+    tr->record = NULL;
+}
+
+/*-----------------------------------------------------------------------------*/
+
+int tr_put(struct trace_ring *tr, const struct trace_record *r)
+{
+    uint64_t head = tr->head; /* only this thread writes head */
+    uint64_t tail = __atomic_load_n(&tr->tail, __ATOMIC_ACQUIRE);
+
+    if(head - tail >= tr->capacity)
+        {
+            tr->n_dropped++;
+            return 1;
+        }
+    tr->record[head & tr->mask] = *r;
+    __atomic_store_n(&tr->head, head + 1, __ATOMIC_RELEASE); /* publish the record */
+    return 0;
+}
+
+/*-----------------------------------------------------------------------------*/
+
+int tr_get(struct trace_ring *tr, struct trace_record *r)
+{
+    uint64_t tail = tr->tail; /* only this thread writes tail */
+    uint64_t head = __atomic_load_n(&tr->head, __ATOMIC_ACQUIRE);
+
+    if(tail == head) return 0;
+    *r = tr->record[tail & tr->mask];
+    __atomic_store_n(&tr->tail, tail + 1, __ATOMIC_RELEASE); /* hand the slot back */
+    return 1;
+}
+
+/*-----------------------------------------------------------------------------*/
+
+long tr_format_all(struct trace_ring *tr, tr_format_function format, void *arg)
+{
+    struct trace_record r;
+    long n = 0;
+
+    while(tr_get(tr, &r))
+        {
+            format(&r, arg);
+            n++;
+        }
+    return n;
+}
+
+/*-----------------------------------------------------------------------------*/
+
+int tr_start_drain(struct trace_ring *tr, tr_format_function format, void *arg)
+{
+    tr->format     = format;
+    tr->format_arg = arg;
+    tr->draining   = 1;
+    return pthread_create(&tr->drain_thread, NULL, drain, tr);
+}
+
+/*-----------------------------------------------------------------------------*/
+
+void tr_stop_drain(struct trace_ring *tr)
+{
+    __atomic_store_n(&tr->draining, 0, __ATOMIC_RELEASE);
+    (void) pthread_join(tr->drain_thread, NULL);
+}
+
+/*-----------------------------------------------------------------------------*/
+
+/* The drain thread: format whatever has arrived, then sleep for a while.
+   At SCHED_IDLE it only gets the processor when nothing else wants it. */
+static void *drain(void *arg)
+{
+    struct trace_ring *tr = (struct trace_ring *) arg;
+    struct sched_param sp;
+
+    memset(&sp, 0, sizeof(sp));
+    if(pthread_setschedparam(pthread_self(), SCHED_IDLE, &sp) != 0)
+        fprintf(stderr, "warning: the drain thread could not be given a low priority\n");
+
+    while(__atomic_load_n(&tr->draining, __ATOMIC_ACQUIRE))
+        if(tr_format_all(tr, tr->format, tr->format_arg) == 0)
+            (void) usleep(DRAIN_PERIOD);
+
+    /* anything that arrived after the last look */
+    (void) tr_format_all(tr, tr->format, tr->format_arg);
+    return NULL;
+}
+/*-----------------------------------------------------------------------------*/
@@ -0,0 +1,70 @@
+/* trace_ring.h */
+
+/* A lock-free trace ring, for the output of the pseudo-tasks.
+
+   The task_simulation() of the slides calls printf() and tab_space() inside the frame,
+   so the time taken by the terminal is part of the timing being demonstrated.
+   Here, the timed path only copies a small binary record into a ring that was allocated
+   before the run. The records are formatted afterwards, or by a drain thread at the lowest
+   priority (SCHED_IDLE), which only runs while the executive is sleeping.
+
+   There is one producer (the executive) and one consumer (the drain, or the code after the run),
+   so the ring needs no lock: the producer alone writes head, the consumer alone writes tail,
+   and each reads the other's index with acquire ordering, after release stores.
+   When the ring is full, a record is dropped and counted, rather than making the producer wait. */
+
+#ifndef TRACE_RING_H
+#define TRACE_RING_H
+
+#include <stddef.h>
+#include <stdint.h>    /* defines some types, including: int64_t */
+#include <pthread.h>
+
+/* one job, as it ran */
+struct trace_record
+{
+    int32_t task;      /* the task id */
+    int32_t instance;  /* the count of this task, so far */
+    int64_t frame_no;  /* the minor frame it was dispatched in, counted from the start */
+    int64_t start_ns;  /* ns since the start of the executive */
+    int64_t end_ns;
+};
+
+typedef void (*tr_format_function)(const struct trace_record *r, void *arg);
+
+struct trace_ring
+{
+    struct trace_record *record;
+    uint64_t capacity;       /* a power of two */
+    uint64_t mask;           /* capacity - 1 */
+    uint64_t head;           /* the next record to write, only written by the producer */
+    uint64_t tail;           /* the next record to read, only written by the consumer */
+    uint64_t n_dropped;      /* records lost because the ring was full, only written by the producer */
+
+    /* the drain thread, if there is one */
+    pthread_t          drain_thread;
+    int                draining;      /* 1 while the drain thread should keep going */
+    tr_format_function format;
+    void              *format_arg;
+};
+
+/* allocate a ring with room for at least capacity records, returns 0 on success */
+int  tr_init(struct trace_ring *tr, size_t capacity);
+void tr_free(struct trace_ring *tr);
+
+/* the producer: store a record, returns 0, or 1 if the ring was full and it was dropped */
+int  tr_put(struct trace_ring *tr, const struct trace_record *r);
+
+/* the consumer: take the oldest record, returns 1, or 0 if the ring is empty */
+int  tr_get(struct trace_ring *tr, struct trace_record *r);
+
+/* format every record in the ring, oldest first, and return how many */
+long tr_format_all(struct trace_ring *tr, tr_format_function format, void *arg);
+
+/* start a low-priority thread that formats records as they arrive, returns 0 on success */
+int  tr_start_drain(struct trace_ring *tr, tr_format_function format, void *arg);
+
+/* stop the drain thread, after it has formatted everything left in the ring */
+void tr_stop_drain(struct trace_ring *tr);
+
+#endif /* TRACE_RING_H */
@@ -0,0 +1,207 @@
+/* workload.c */
+
+/* Calibrated CPU-burn workloads, see workload.h */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>    /* defines some types, including: int64_t */
+#include <time.h>      /* needed for clock_gettime() and CLOCK_THREAD_CPUTIME_ID */
+
+#include "workload.h"
+
+#define CALIBRATION_NS  20000000  /* calibrate on 20 ms of CPU time */
+#define CALIBRATION_MIN     1000  /* steps, in the first trial */
+#define LINE_WORDS             8  /* 64-byte cache lines, of 8-byte words */
+
+/* function templates, for local helpers */
+static void    run_steps(struct workload *wl, long n_steps);
+static int64_t cpu_time(void);
+
+/*-----------------------------------------------------------------------------*/
+
+int wl_init(struct workload *wl, int kernel)
+{
+    size_t  n_lines;
+    size_t  i, j;
+    uint64_t t;
+    long    n_steps;
+    int64_t elapsed;
+    int64_t t0;
+
+    memset(wl, 0, sizeof(*wl));
+    wl->kernel = kernel;
+    wl->state  = 0x9E3779B97F4A7C15ULL;
+
+    if(kernel != WL_COMPUTE)
+        {
+            wl->n_words = WL_BUFFER_BYTES / sizeof(uint64_t);
+            wl->buffer  = (uint64_t *) malloc(wl->n_words * sizeof(uint64_t));
+            if(wl->buffer == NULL) return 1;
+            for (i=0; i<wl->n_words; i++) wl->buffer[i] = i; /* touch every page, now */
+
+            if(kernel == WL_CACHE)
+                {
+                    /* the first word of each line holds the index of the next line to visit,
+                       a random permutation with a single cycle, by Sattolo's algorithm */
+                    n_lines = wl->n_words / LINE_WORDS;
+                    for (i=0; i<n_lines; i++) wl->buffer[i*LINE_WORDS] = i;
+                    for (i=n_lines-1; i>0; i--)
+                        {
+                            j = (size_t) (((uint64_t) rand() << 16 ^ (uint64_t) rand()) % i); /* 0 <= j < i */
+                            t = wl->buffer[i*LINE_WORDS];
+                            wl->buffer[i*LINE_WORDS] = wl->buffer[j*LINE_WORDS];
+                            wl->buffer[j*LINE_WORDS] = t;
+                        }
+                }
+        }
+
+    /* calibrate: double the trial until it takes long enough to time well */
+    n_steps = CALIBRATION_MIN;
+    while(1)
+        {
+            t0 = cpu_time();
+            run_steps(wl, n_steps);
+            elapsed = cpu_time() - t0;
+            if(elapsed >= CALIBRATION_NS / 4) break;
+            n_steps *= 2;
+        }
+    /* and once more, at full length, now that the caches and the clock speed have settled */
+    n_steps = (long) ((double) n_steps * (double) CALIBRATION_NS / (double) elapsed);
+    t0 = cpu_time();
+    run_steps(wl, n_steps);
+    elapsed = cpu_time() - t0;
+
+    wl->steps_per_ns = (double) n_steps / (double) (elapsed > 0 ? elapsed : 1);
+    wl->chunk_steps  = (long) (wl->steps_per_ns * WL_CHECK_NS);
+    if(wl->chunk_steps < 1) wl->chunk_steps = 1;
+    return 0;
+}
+
+/*-----------------------------------------------------------------------------*/
+
+void wl_free(struct workload *wl)
+{
+    free(wl->buffer);
+    wl->buffer = NULL;
+}
+
+/*-----------------------------------------------------------------------------*/
+
+int64_t wl_burn(struct workload *wl, int64_t ns)
+{
+    int64_t t0 = cpu_time();
+    int64_t used = 0;
+    long    n_steps;
+
+    while(used < ns)
+        {
+            /* a whole chunk, or just enough for the time that is left */
+            n_steps = (long) (wl->steps_per_ns * (double) (ns - used));
+            if(n_steps > wl->chunk_steps) n_steps = wl->chunk_steps;
+            if(n_steps < 1) n_steps = 1;
+
+            run_steps(wl, n_steps);
+            used = cpu_time() - t0;
+        }
+
+    wl->n_burns++;
+    wl->sum_requested += ns;
+    wl->sum_consumed  += used;
+    if(used - ns > wl->max_excess) wl->max_excess = used - ns;
+    return used;
+}
+
+/*-----------------------------------------------------------------------------*/
+
+void wl_report(const struct workload *wl, FILE *fp)
+{
+    fprintf(fp, "workload: %s, %.3f steps per ns\n", wl_kernel_name(wl->kernel), wl->steps_per_ns);
+    if(wl->n_burns == 0) return;
+    fprintf(fp, "burns %ld, CPU time asked for %ld us, used %ld us (%+.2f%%), worst excess %ld ns\n",
+            wl->n_burns, (long) (wl->sum_requested/1000), (long) (wl->sum_consumed/1000),
+            100.0 * (double) (wl->sum_consumed - wl->sum_requested) / (double) (wl->sum_requested > 0 ? wl->sum_requested : 1),
+            (long) wl->max_excess);
+}
+
+/*-----------------------------------------------------------------------------*/
+
+int wl_kernel_from_name(const char *name)
+{
+    if(strcmp(name, "compute") == 0) return WL_COMPUTE;
+    if(strcmp(name, "memory")  == 0) return WL_MEMORY;
+    if(strcmp(name, "cache")   == 0) return WL_CACHE;
+    return -1;
+}
+
+/*-----------------------------------------------------------------------------*/
+
+const char *wl_kernel_name(int kernel)
+{
+    switch(kernel)
+        {
+        case WL_MEMORY:
+            return "memory";
+        case WL_CACHE:
+            return "cache";
+        default:
+            return "compute";
+        }
+}
+
+/*-----------------------------------------------------------------------------*/
+
+/* n_steps of the kernel, carrying on from where the last call stopped */
+static void run_steps(struct workload *wl, long n_steps)
+{
+    uint64_t x   = wl->state;
+    uint64_t sum = 0;
+    size_t   p   = wl->position;
+    long     k;
+
+    switch(wl->kernel)
+        {
+        case WL_MEMORY:
+            /* one step is one word, read, modified and written back, in order */
+            for (k=0; k<n_steps; k++)
+                {
+                    sum += wl->buffer[p];
+                    wl->buffer[p] = sum;
+                    if(++p == wl->n_words) p = 0;
+                }
+            break;
+
+        case WL_CACHE:
+            /* one step is one dependent load, from a line chosen at random */
+            for (k=0; k<n_steps; k++)
+                p = (size_t) wl->buffer[p*LINE_WORDS];
+            sum = p;
+            break;
+
+        default: /* WL_COMPUTE */
+            /* one step is a round of xorshift, a multiply, and a dependent add */
+            for (k=0; k<n_steps; k++)
+                {
+                    x ^= x << 13;
+                    x ^= x >> 7;
+                    x ^= x << 17;
+                    sum += x * 0x2545F4914F6CDD1DULL;
+                }
+            break;
+        }
+
+    wl->state    = x;
+    wl->position = p;
+    wl->sink    += sum;
+}
+
+/*-----------------------------------------------------------------------------*/
+
+static int64_t cpu_time(void)
+{
+    struct timespec t;
+
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &t);
+    return (int64_t) t.tv_sec * 1000000000 + t.tv_nsec;
+}
+/*-----------------------------------------------------------------------------*/
@@ -0,0 +1,68 @@
+/* workload.h */
+
+/* Calibrated CPU-burn workloads, to stand in for the computation of a task.
+
+   task_simulation() in the slides "works" by usleep(C * SHORT_TIME_TICK), with a hand-tuned 0.8,
+   which uses no processor time at all, so the executive never competes with real work.
+   wl_burn() consumes a requested amount of thread CPU time, by one of three kernels:
+
+   WL_COMPUTE  arithmetic in registers, bound by the execution units,
+   WL_MEMORY   a streaming read-modify-write through a buffer much larger than the caches,
+               bound by memory bandwidth,
+   WL_CACHE    a pointer chase through a random cycle of cache lines, in the same size of buffer,
+               so that nearly every step is a cache miss, and a TLB miss, bound by memory latency.
+
+   At start-up, wl_init() measures how many steps of the kernel take one nanosecond of CPU time.
+   wl_burn() runs the kernel in short chunks of about WL_CHECK_NS, and checks CLOCK_THREAD_CPUTIME_ID
+   between them, sizing the last chunk to the time that is left, so it stops within a chunk of the target,
+   whatever the kernel, and whether or not the thread was pre-empted on the way. */
+
+#ifndef WORKLOAD_H
+#define WORKLOAD_H
+
+#include <stdio.h>
+#include <stddef.h>
+#include <stdint.h>    /* defines some types, including: int64_t */
+
+#define WL_COMPUTE 0
+#define WL_MEMORY  1
+#define WL_CACHE   2
+
+#define WL_BUFFER_BYTES (32*1024*1024) /* larger than the last-level cache of most machines */
+#define WL_CHECK_NS      10000         /* ns of CPU time between checks of the clock */
+
+struct workload
+{
+    int       kernel;
+    double    steps_per_ns;   /* measured by wl_init() */
+    long      chunk_steps;    /* about WL_CHECK_NS worth of steps */
+
+    /* the state of the kernels, carried on from one burn to the next */
+    uint64_t  state;          /* WL_COMPUTE */
+    uint64_t *buffer;         /* WL_MEMORY, and WL_CACHE */
+    size_t    n_words;
+    size_t    position;
+    uint64_t  sink;           /* results go here, so that the kernels are not optimised away */
+
+    /* statistics */
+    long      n_burns;
+    int64_t   sum_requested;  /* ns of CPU time */
+    int64_t   sum_consumed;
+    int64_t   max_excess;     /* the most CPU time used beyond what was asked for, in one burn */
+};
+
+/* allocate the buffer for the kernel, if it needs one, and calibrate it, returns 0 on success */
+int         wl_init(struct workload *wl, int kernel);
+void        wl_free(struct workload *wl);
+
+/* consume ns of this thread's CPU time, and return how much was actually consumed */
+int64_t     wl_burn(struct workload *wl, int64_t ns);
+
+/* print the calibration, and how close the burns came to what was asked for */
+void        wl_report(const struct workload *wl, FILE *fp);
+
+/* "compute", "memory" or "cache" to a WL_ code, or -1 */
+int         wl_kernel_from_name(const char *name);
+const char *wl_kernel_name(int kernel);
+
+#endif /* WORKLOAD_H */
@@ -0,0 +1,95 @@
+/* workload_01.c */
+
+/* How well do the CPU-burn kernels of workload.c hit the CPU time that is asked for?
+
+   Each kernel is calibrated, then asked for bursts of 100 us, 1 ms and 10 ms of CPU time,
+   as a task of 0.1, 1 or 10 ticks would be. The CPU time actually used, by CLOCK_THREAD_CPUTIME_ID,
+   and the wall-clock time taken, are printed for each, next to what usleep() does for the same request,
+   which uses almost no CPU time at all.
+
+   compilation advice:
+   gcc -std=gnu99 -Werror -Wall -Wextra -O2 -o workload_01 workload_01.c workload.c
+
+   an execution suggestion:
+   ./workload_01 20
+
+   The optional parameter is the number of bursts of each size (default 10).
+   */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>    /* defines the types int64_t, for the time functions */
+#include <time.h>      /* needed for clock_gettime(), and the clocks */
+#include <unistd.h>    /* needed for usleep() */
+
+#include "workload.h"
+
+#define N_KERNELS 3
+
+/* function templates */
+static int64_t clock_ns(clockid_t clock);
+static void    error_exit(char *s);
+
+int main(int argc, char *argv[])
+{
+    int64_t burst[] = {100000, 1000000, 10000000}; /* ns of CPU time to ask for */
+    int     n_bursts = 10;
+    struct workload wl;
+    int64_t cpu, wall, used, worst;
+    int     kernel, b, k;
+
+    if(argc > 1) n_bursts = atoi(argv[1]);
+    if(n_bursts < 1) n_bursts = 1;
+
+    printf("kernel\tsteps/ns\tasked us\tCPU us\tworst excess ns\twall us\n");
+    for (kernel=-1; kernel<N_KERNELS; kernel++)
+        {
+            if((kernel >= 0) && (wl_init(&wl, kernel) != 0)) error_exit("out of memory");
+
+            for (b=0; b<(int) (sizeof(burst)/sizeof(burst[0])); b++)
+                {
+                    cpu   = clock_ns(CLOCK_THREAD_CPUTIME_ID);
+                    wall  = clock_ns(CLOCK_MONOTONIC);
+                    worst = 0;
+                    for (k=0; k<n_bursts; k++)
+                        {
+                            if(kernel < 0)
+                                (void) usleep((useconds_t) (burst[b]/1000)); /* the way the slides do it */
+                            else
+                                {
+                                    used = wl_burn(&wl, burst[b]);
+                                    if(used - burst[b] > worst) worst = used - burst[b];
+                                }
+                        }
+                    cpu  = clock_ns(CLOCK_THREAD_CPUTIME_ID) - cpu;
+                    wall = clock_ns(CLOCK_MONOTONIC) - wall;
+
+                    printf("%s\t%.3f\t\t%ld\t\t%ld\t%ld\t\t%ld\n",
+                           (kernel < 0) ? "usleep" : wl_kernel_name(kernel), (kernel < 0) ? 0.0 : wl.steps_per_ns,
+                           (long) (burst[b]/1000), (long) (cpu/n_bursts/1000), (long) worst, (long) (wall/n_bursts/1000));
+                }
+
+            if(kernel >= 0) wl_free(&wl);
+        }
+
+    return EXIT_SUCCESS;
+}
+
+/*-----------------------------------------------------------------------------*/
+
+static int64_t clock_ns(clockid_t clock)
+{
+    struct timespec t;
+
+    clock_gettime(clock, &t);
+    return (int64_t) t.tv_sec * 1000000000 + t.tv_nsec;
+}
+
+/*-----------------------------------------------------------------------------*/
+
+/* A standard formatter for printing eror messages, and exiting */
+static void error_exit(char *s)
+{
+    fprintf(stderr, "\nerror: %s - bye!\n",s);
+    exit(1);
+}
@@ -0,0 +1,65 @@
+/* EDF_QPA_01.c */
+
+/* The exact EDF schedulability test of a task file, by Quick Processor-demand Analysis (QPA).
+
+   The task file has the same format as for RM_simulator_07.c, with an optional
+   fourth column for a constrained deadline, D <= T:
+
+       task_type \t computing_time \t recurrence_time [ \t deadline ] \n
+
+   compilation advice:
+   gcc -std=gnu99 -Werror -Wall -Wextra -O2 -o EDF_QPA_01 EDF_QPA_01.c edf_demand_analysis.c task_set.c
+
+   an execution suggestion:
+   ./EDF_QPA_01 RM_example_data_s44_t3.txt
+   */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "task_set.h"
+#include "edf_demand_analysis.h"
+
+#define MIN_ARGV 2 /* There is one command-line parameter, so we require argc >= 2 */
+
+int main(int argc, char *argv[])
+{
+    struct task_set      ts;
+    struct demand_result res;
+    double U = 0.0;
+    int    i;
+
+    if (argc < MIN_ARGV)
+        {
+            fprintf(stderr,"Usage is: ./EDF_QPA_01 input_file\n");
+            return EXIT_FAILURE;
+        }
+
+    if(read_task_set(argv[1], &ts) != 0) return EXIT_FAILURE;
+
+    for (i=0; i<ts.n_tasks; i++) U += ((double) ts.computing_time[i]) / ((double) ts.recurrence_time[i]);
+
+    if(edf_qpa(&ts, &res) != 0)
+        {
+            fprintf(stderr, "error: the interval to be checked is too long to represent\n");
+            free_task_set(&ts);
+            return EXIT_FAILURE;
+        }
+
+    printf("utilization U = %f\n", U);
+    /* the verdict on U is the one edf_qpa() took, allowing for rounding in the sum,
+       an unschedulable result with no failure time means that U > 1 ruled the set out */
+    if(!res.schedulable && (res.failure_time < 0))
+        printf("U > 1, the task set cannot be schedulable\n");
+    else
+        {
+            printf("interval checked, L = %ld\n", res.L);
+            printf("points checked by QPA = %ld\n", res.n_points);
+            if(!res.schedulable)
+                printf("h(t) = %ld > t = %ld\n", processor_demand(&ts, res.failure_time), res.failure_time);
+        }
+    printf("The task set is %sschedulable under EDF\n", res.schedulable ? "" : "NOT ");
+
+    free_task_set(&ts);
+    return EXIT_SUCCESS;
+}
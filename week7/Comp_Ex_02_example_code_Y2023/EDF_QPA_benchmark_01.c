@@ -0,0 +1,189 @@
+/* EDF_QPA_benchmark_01.c */
+
+/* How much faster is QPA than the alternatives, for EDF with constrained deadlines?
+
+   Random task sets of 10, 100 and 1000 tasks are tested for EDF schedulability in three ways:
+
+   1. QPA, edf_qpa(), which checks only a handful of points,
+   2. the plain Processor-Demand Criterion, edf_pdc_all_deadlines(), which checks every deadline below L,
+   3. the discrete-event simulator, simulate_schedule(), over the hyperperiod plus the largest deadline.
+
+   All three must agree, or the benchmark stops with an error.
+
+   The periods are divisors of BASE_PERIOD (times PERIOD_SCALE), so that the hyperperiod stays small
+   enough to simulate. Utilizations are drawn by UUniFast, and deadlines lie between C and T.
+
+   compilation advice:
+   gcc -std=gnu99 -Werror -Wall -Wextra -O2 -o EDF_QPA_benchmark_01 EDF_QPA_benchmark_01.c edf_demand_analysis.c schedule_simulation.c task_set.c
+
+   an execution suggestion:
+   ./EDF_QPA_benchmark_01 10
+
+   The optional parameter is the number of task sets of each size (default 10).
+   */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>    /* defines the types int64_t, for the time functions */
+#include <time.h>      /* needed for clock_gettime(), and CLOCK_MONOTONIC */
+#include <math.h>      /* needed for pow() */
+
+#include "task_set.h"
+#include "edf_demand_analysis.h"
+#include "schedule_simulation.h"
+
+#define BASE_PERIOD   75600 /* 2^4 * 3^3 * 5^2 * 7, which has plenty of divisors */
+#define MIN_PERIOD      100 /* the smallest divisor of BASE_PERIOD to use as a period */
+#define PERIOD_SCALE    100 /* sub-divide time, so that C stays a whole number with 1000 tasks */
+#define MAX_DIVISORS    200
+#define U_LOW          0.80 /* the target utilizations are spread over [U_LOW, U_HIGH] */
+#define U_HIGH         0.99
+#define SEED             28 /* repeatable random task sets */
+
+/* function templates */
+static void    generate_task_set(struct task_set *ts, int n, const long *divisors, int n_divisors);
+static int64_t elapsed_time(void);
+static void    error_exit(char *s);
+
+/* Set up structures for the starting and stopping times */
+static struct timespec start, end;
+
+int main(int argc, char *argv[])
+{
+    int    sizes[] = {10, 100, 1000}; /* the numbers of tasks to benchmark */
+    int    n_sets = 10;
+    long   divisors[MAX_DIVISORS];
+    int    n_divisors = 0;
+    long   d;
+    int    s, k;
+
+    struct task_set      ts;
+    struct demand_result qpa, pdc;
+    struct sim_result    sim;
+    long    horizon;
+    long    D_max;
+    int     i;
+    int     n_schedulable;
+    long    points_qpa, points_pdc, events_sim;
+    int64_t t0, t_qpa, t_pdc, t_sim;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    if(argc > 1) n_sets = atoi(argv[1]);
+    if(n_sets < 1) n_sets = 1;
+
+    srand(SEED);
+
+    for (d=MIN_PERIOD; d<=BASE_PERIOD; d++)
+        if((BASE_PERIOD % d == 0) & (n_divisors < MAX_DIVISORS)) divisors[n_divisors++] = d;
+
+    printf("n_tasks\tsets\tsched.\tQPA points\tQPA us\tPDC points\tPDC us\tsim events\tsim us\tQPA speed-up vs PDC, sim\n");
+
+    for (s=0; s<(int) (sizeof(sizes)/sizeof(sizes[0])); s++)
+        {
+            n_schedulable = 0;
+            points_qpa = points_pdc = events_sim = 0;
+            t_qpa = t_pdc = t_sim = 0;
+
+            for (k=0; k<n_sets; k++)
+                {
+                    generate_task_set(&ts, sizes[s], divisors, n_divisors);
+
+                    t0 = elapsed_time();
+                    if(edf_qpa(&ts, &qpa) != 0) error_exit("edf_qpa() failed");
+                    t_qpa += elapsed_time() - t0;
+
+                    t0 = elapsed_time();
+                    if(edf_pdc_all_deadlines(&ts, &pdc) != 0) error_exit("edf_pdc_all_deadlines() failed");
+                    t_pdc += elapsed_time() - t0;
+
+                    D_max = 0;
+                    for (i=0; i<ts.n_tasks; i++)
+                        if(ts.deadline[i] > D_max) D_max = ts.deadline[i];
+                    horizon = hyperperiod(&ts) + D_max;
+
+                    t0 = elapsed_time();
+                    if(simulate_schedule(&ts, POLICY_EDF, horizon, &sim) != 0) error_exit("simulate_schedule() failed");
+                    t_sim += elapsed_time() - t0;
+
+                    if((qpa.schedulable != pdc.schedulable) | (qpa.schedulable != sim.schedulable))
+                        error_exit("QPA, PDC and simulation disagree");
+
+                    n_schedulable += qpa.schedulable;
+                    points_qpa    += qpa.n_points;
+                    points_pdc    += pdc.n_points;
+                    events_sim    += sim.n_events;
+
+                    free_task_set(&ts);
+                }
+
+            /* averages per task set */
+            printf("%d\t%d\t%d\t%ld\t\t%ld\t%ld\t\t%ld\t%ld\t\t%ld\t%.0fx, %.0fx\n",
+                   sizes[s], n_sets, n_schedulable,
+                   points_qpa/n_sets, (long) (t_qpa/n_sets/1000),
+                   points_pdc/n_sets, (long) (t_pdc/n_sets/1000),
+                   events_sim/n_sets, (long) (t_sim/n_sets/1000),
+                   ((double) t_pdc)/((double) (t_qpa+1)), ((double) t_sim)/((double) (t_qpa+1)));
+        }
+
+    return EXIT_SUCCESS;
+}
+
+/*-----------------------------------------------------------------------------*/
+
+/* A random task set of n tasks, by UUniFast, with constrained deadlines */
+static void generate_task_set(struct task_set *ts, int n, const long *divisors, int n_divisors)
+{
+    double U = U_LOW + (U_HIGH - U_LOW) * ((double) rand() / (double) RAND_MAX);
+    double sum_U = U;
+    double next_sum_U;
+    double U_i;
+    long   T, C, D;
+    int    i;
+
+    if(alloc_task_set(ts, n) != 0) error_exit("out of memory");
+
+    for (i=0; i<n; i++)
+        {
+            /* UUniFast: split the remaining utilization between this task and the rest */
+            if(i < n-1)
+                {
+                    next_sum_U = sum_U * pow((double) rand() / (double) RAND_MAX, 1.0/(double) (n-1-i));
+                    U_i = sum_U - next_sum_U;
+                    sum_U = next_sum_U;
+                }
+            else
+                U_i = sum_U;
+
+            T = divisors[rand() % n_divisors] * PERIOD_SCALE;
+            C = (long) (U_i * (double) T);
+            if(C < 1) C = 1;
+            if(C > T) C = T;
+            /* a deadline somewhere in the upper part of [C, T] */
+            D = C + (long) ((0.5 + 0.5 * (double) rand() / (double) RAND_MAX) * (double) (T - C));
+
+            ts->task_type[i]       = i+1;
+            ts->computing_time[i]  = C;
+            ts->recurrence_time[i] = T;
+            ts->deadline[i]        = D;
+        }
+}
+
+/*-----------------------------------------------------------------------------*/
+
+/* A standard formatter for printing eror messages, and exiting */
+static void error_exit(char *s)
+{
+    fprintf(stderr, "\nerror: %s - bye!\n",s);
+    exit(1);
+}
+
+/*-----------------------------------------------------------------------------*/
+
+/* determine the elapsed time, since the program was started, in ns */
+static int64_t elapsed_time(void)
+{
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    return (int64_t) ((end.tv_sec * 1000000000) + end.tv_nsec) -
+           ((start.tv_sec * 1000000000) + start.tv_nsec);
+}
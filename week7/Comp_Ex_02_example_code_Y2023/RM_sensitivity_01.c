@@ -0,0 +1,327 @@
+/* RM_sensitivity_01.c */
+
+/* Breakdown utilization and sensitivity analysis of a task file, under Rate-Monotonic scheduling.
+
+   How much headroom does a task set have?
+   Two kinds of answer are found by binary search:
+
+   1. the breakdown scaling factor, the largest factor by which ALL computing times can be
+      multiplied, and the set is still schedulable. U times this factor is the breakdown utilization.
+
+   2. for each task on its own, the largest computing time C that it may grow to,
+      with every other task left as it is.
+
+   Each candidate is checked with the Response-Time Analysis (response_time_analysis.c),
+   or, with -s, by the discrete-event simulator (schedule_simulation.c) as a fall-back,
+   e.g. to cross-check the analysis.
+
+   The searches are independent of each other, so they are shared out between child processes,
+   one per processor, which send their answers back to the parent through a pipe,
+   in the same way as concurrent_sum_03.c.
+
+   compilation advice:
+   gcc -std=gnu99 -Werror -Wall -Wextra -O2 -o RM_sensitivity_01 RM_sensitivity_01.c response_time_analysis.c schedule_simulation.c task_set.c
+
+   an execution suggestion:
+   ./RM_sensitivity_01 RM_example_data_s44_t3.txt
+   ./RM_sensitivity_01 -s -j 2 RTA_example_data_t20.txt
+   */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>    /* defines the types int64_t, for the time functions */
+#include <time.h>      /* needed for clock_gettime(), and CLOCK_MONOTONIC */
+#include <unistd.h>    /* needed for fork(), pipe(), getopt() and sysconf() */
+#include <sys/types.h>
+#include <sys/wait.h>  /* needed for wait() */
+
+#include "task_set.h"
+#include "response_time_analysis.h"
+#include "schedule_simulation.h"
+
+#define SCALE_RESOLUTION  1000     /* sub-divide each TIME_TICK, so that C can be scaled by a fraction */
+#define SCALE_STEPS         40     /* bisection steps for the scaling factor, 2^-40 is plenty */
+#define SIM_MAX_HORIZON  100000000 /* beyond this many time units, only simulate up to the largest deadline */
+
+/* One answer, as sent through the pipe from a child to the parent.
+   It is much smaller than PIPE_BUF, so each write() is atomic. */
+struct search_result
+{
+    int    job;   /* 0 is the scaling factor, job k is the largest C of task k-1 */
+    double value;
+};
+
+/* function templates */
+static int     check_schedulable(const struct task_set *ts, int use_sim);
+static double  search_scaling_factor(const struct task_set *ts, int use_sim);
+static long    search_max_C(const struct task_set *ts, int task, int use_sim);
+static void    error_exit(char *s);
+static int64_t elapsed_time(void);
+
+/* Set up structures for the starting and stopping times */
+static struct timespec start, end;
+
+int main(int argc, char *argv[])
+{
+    struct task_set      ts;
+    struct search_result result;
+    int     use_sim   = 0;                                /* 1 for the simulator, 0 for the analysis */
+    int     n_workers = (int) sysconf(_SC_NPROCESSORS_ONLN); /* the number of child processes */
+    int     n_jobs;
+    int     opt;
+    int     i, w, k;
+    int     pd[2];                                        /* pipe descriptors */
+    int     status;
+    double  U = 0.0;                                      /* the utilization of the task set as given */
+    double  factor = 0.0;                                 /* the breakdown scaling factor */
+    long   *max_C;
+    int64_t t_search;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    while((opt = getopt(argc, argv, "sj:")) != -1)
+        switch(opt)
+            {
+            case 's':
+                use_sim = 1;
+                break;
+            case 'j':
+                n_workers = atoi(optarg);
+                break;
+            default:
+                fprintf(stderr, "Usage is: ./RM_sensitivity_01 [-s] [-j n_workers] input_file\n");
+                return EXIT_FAILURE;
+            }
+    if (optind >= argc)
+        {
+            fprintf(stderr, "Usage is: ./RM_sensitivity_01 [-s] [-j n_workers] input_file\n");
+            return EXIT_FAILURE;
+        }
+
+    if(read_task_set(argv[optind], &ts) != 0) return EXIT_FAILURE;
+    if(ts.n_tasks == 0) error_exit("there are no tasks in the input file");
+
+    for (i=0; i<ts.n_tasks; i++) U += ((double) ts.computing_time[i]) / ((double) ts.recurrence_time[i]);
+
+    n_jobs = ts.n_tasks + 1;
+    if(n_workers < 1) n_workers = 1;
+    if(n_workers > n_jobs) n_workers = n_jobs;
+
+    max_C = (long *) malloc((size_t) ts.n_tasks * sizeof(long));
+    if(max_C == NULL) error_exit("out of memory");
+
+    if(pipe(pd) == -1)
+        error_exit("pipe() failed");
+
+    t_search = elapsed_time();
+
+    /* fork() the workers, worker w takes the jobs w, w+n_workers, w+2*n_workers, ... */
+    for (w=0; w<n_workers; w++)
+        if(fork()==0)
+            {
+                (void) close(pd[0]);
+                for (k=w; k<n_jobs; k+=n_workers)
+                    {
+                        result.job = k;
+                        if(k == 0)
+                            result.value = search_scaling_factor(&ts, use_sim);
+                        else
+                            result.value = (double) search_max_C(&ts, k-1, use_sim);
+
+                        if(write(pd[1], &result, sizeof(result)) == -1)
+                            error_exit("write() failed");
+                    }
+                exit(0);
+            }
+
+    /* parent: collect one answer per job */
+    (void) close(pd[1]);
+    for (k=0; k<n_jobs; k++)
+        {
+            if(read(pd[0], &result, sizeof(result)) != (ssize_t) sizeof(result))
+                error_exit("read() failed, a worker has died");
+            if(result.job == 0)
+                factor = result.value;
+            else
+                max_C[result.job-1] = (long) result.value;
+        }
+
+    for (w=0; w<n_workers; w++)
+        if (wait(&status) < 0)
+            perror ("wait error");
+
+    t_search = elapsed_time() - t_search;
+
+    printf("checked by: %s\n", use_sim ? "discrete-event simulation" : "response-time analysis");
+    printf("utilization U = %f\n", U);
+    printf("breakdown scaling factor of all C = %f\n", factor);
+    printf("breakdown utilization = %f\n\n", U*factor);
+
+    printf("task_type\tC\tmax_C\theadroom\n");
+    for (i=0; i<ts.n_tasks; i++)
+        {
+            if(max_C[i] > 0)
+                printf("%ld\t%ld\t%ld\t%ld\n", ts.task_type[i], ts.computing_time[i], max_C[i],
+                       max_C[i] - ts.computing_time[i]);
+            else
+                printf("%ld\t%ld\tnone\t-\n", ts.task_type[i], ts.computing_time[i]); /* the others do not fit */
+        }
+
+    printf("\n%d searches on %d workers in %ld us\n", n_jobs, n_workers, (long) (t_search/1000));
+
+    free(max_C);
+    free_task_set(&ts);
+    return EXIT_SUCCESS;
+}
+
+/*-----------------------------------------------------------------------------*/
+
+/* 1 if the task set meets all deadlines, by analysis, or by simulation */
+static int check_schedulable(const struct task_set *ts, int use_sim)
+{
+    struct rta_state  rs;
+    struct sim_result res;
+    long   horizon;
+    long   max_D = 0;
+    int    i;
+    int    ok;
+
+    if(use_sim)
+        {
+            /* With all tasks released together, the first job of each task sees the worst case,
+               so a horizon of the largest deadline is enough, when the hyperperiod is too long */
+            for (i=0; i<ts->n_tasks; i++)
+                if(ts->deadline[i] > max_D) max_D = ts->deadline[i];
+            horizon = hyperperiod(ts);
+            if((horizon <= 0) | (horizon > SIM_MAX_HORIZON)) horizon = max_D;
+
+            if(simulate_schedule(ts, POLICY_RM, horizon, &res) != 0)
+                error_exit("simulate_schedule() failed");
+            return res.schedulable;
+        }
+
+    if(rta_init(&rs, ts) != 0) error_exit("out of memory");
+    ok = rta_is_schedulable(&rs);
+    rta_free(&rs);
+    return ok;
+}
+
+/*-----------------------------------------------------------------------------*/
+
+/* The largest factor by which every C may be multiplied.
+   Time is measured in 1/SCALE_RESOLUTION of a TIME_TICK, and a scaled C is rounded up, to be safe. */
+static double search_scaling_factor(const struct task_set *ts, int use_sim)
+{
+    struct task_set scaled;
+    double U = 0.0;
+    double lo = 0.0;
+    double hi;
+    double mid;
+    int    i;
+    int    step;
+
+    if(alloc_task_set(&scaled, ts->n_tasks) != 0) error_exit("out of memory");
+
+    for (i=0; i<ts->n_tasks; i++)
+        {
+            scaled.task_type[i]       = ts->task_type[i];
+            scaled.recurrence_time[i] = ts->recurrence_time[i] * SCALE_RESOLUTION;
+            scaled.deadline[i]        = ts->deadline[i] * SCALE_RESOLUTION;
+            U += ((double) ts->computing_time[i]) / ((double) ts->recurrence_time[i]);
+        }
+
+    /* No factor beyond 1/U can work, since the processor would be more than fully used */
+    hi = 1.0/U;
+
+    for (step=0; step<=SCALE_STEPS; step++)
+        {
+            /* try hi itself first, it is the answer for some harmonic task sets */
+            mid = (step == 0) ? hi : 0.5*(lo+hi);
+
+            for (i=0; i<ts->n_tasks; i++)
+                {
+                    scaled.computing_time[i] = (long) (((double) (ts->computing_time[i] * SCALE_RESOLUTION)) * mid + 0.999999);
+                    if(scaled.computing_time[i] < 1) scaled.computing_time[i] = 1;
+                }
+
+            if(check_schedulable(&scaled, use_sim))
+                {
+                    lo = mid;
+                    if(step == 0) break;
+                }
+            else
+                {
+                    if(step == 0) continue;
+                    hi = mid;
+                }
+        }
+
+    free_task_set(&scaled);
+    return lo;
+}
+
+/*-----------------------------------------------------------------------------*/
+
+/* The largest C of one task, in whole TIME_TICKs, with the rest unchanged, or 0 if none will do.
+   The analysis re-uses one rta_state, so each step is an incremental re-analysis. */
+static long search_max_C(const struct task_set *ts, int task, int use_sim)
+{
+    struct task_set  trial;
+    struct rta_state rs;
+    long   lo = 0;                   /* the largest C known to work, 0 for none yet */
+    long   hi = ts->deadline[task];  /* C can never exceed D */
+    long   mid;
+    int    ok;
+    int    i;
+
+    if(alloc_task_set(&trial, ts->n_tasks) != 0) error_exit("out of memory");
+    for (i=0; i<ts->n_tasks; i++)
+        {
+            trial.task_type[i]       = ts->task_type[i];
+            trial.computing_time[i]  = ts->computing_time[i];
+            trial.recurrence_time[i] = ts->recurrence_time[i];
+            trial.deadline[i]        = ts->deadline[i];
+        }
+    if(!use_sim && (rta_init(&rs, &trial) != 0)) error_exit("out of memory");
+
+    /* invariant: lo works (or is 0), hi+1 does not */
+    while(lo < hi)
+        {
+            mid = lo + (hi - lo + 1)/2;
+            if(use_sim)
+                {
+                    trial.computing_time[task] = mid;
+                    ok = check_schedulable(&trial, 1);
+                }
+            else
+                ok = (rta_set_computing_time(&rs, task, mid) == 0);
+
+            if(ok)
+                lo = mid;
+            else
+                hi = mid - 1;
+        }
+
+    if(!use_sim) rta_free(&rs);
+    free_task_set(&trial);
+    return lo;
+}
+
+/*-----------------------------------------------------------------------------*/
+
+/* A standard formatter for printing eror messages, and exiting */
+static void error_exit(char *s)
+{
+    fprintf(stderr, "\nerror: %s - bye!\n",s);
+    exit(1);
+}
+
+/*-----------------------------------------------------------------------------*/
+
+/* determine the elapsed time, since the program was started, in ns */
+static int64_t elapsed_time(void)
+{
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    return (int64_t) ((end.tv_sec * 1000000000) + end.tv_nsec) -
+           ((start.tv_sec * 1000000000) + start.tv_nsec);
+}
@@ -4,7 +4,7 @@
    Last edit: Mon Oct 10 12:52:43 ACDT 2022
 
    compilation advice:
-   gcc -Werror -Wall -Wextra -o RM_simulator_07 RM_simulator_07.c
+   gcc -Werror -Wall -Wextra -o RM_simulator_07 RM_simulator_07.c chrome_trace.c
 
    an execution suggestion:
    ./RM_simulator_07 RM_example_data_s44_t3.txt > RM_example_data_s44_t3_out.txt
@@ -16,6 +16,11 @@
    There also is a hard-wired output file: simulator_tasks_out_data.txt,
    which logs the completed tasks, after they have completed,
    in order of arrival time.
+
+   An optional second parameter names a Chrome trace-event JSON file:
+   ./RM_simulator_07 RM_example_data_s44_t3.txt RM_example_trace.json > RM_example_data_s44_t3_out.txt
+   It can be opened in chrome://tracing or https://ui.perfetto.dev , with one track per task type,
+   and instant events for arrivals, preemptions and deadline misses (see chrome_trace.h).
    */
 
 /*
@@ -43,6 +48,8 @@ barbie@DESKTOP-DL95D7D:~/RTES_S2_Y2023/Comp_Ex_03_solution$
 #include <sys/wait.h>  /* needed for usleep() */
 #include <fcntl.h>      /* file control optopns, for pipes*/
 
+#include "chrome_trace.h" /* optional time-line output, for a browser-based trace viewer */
+
 /* constant identifiers */
 
 #define TIME_TICK                            10000 /* in usec*/
@@ -77,11 +84,19 @@ int insert_task_by_rate(struct task_description *(*first_out_ptr), struct task_d
 struct task_description* pop_top_task( struct task_description *(*first_out_ptr) );
 void traverse_list(struct task_description *(*first_out_ptr));
 
+/* function headers for the optional trace output */
+void trace_start(long now);
+void trace_stop(struct task_description *task_ptr, long now, int completed);
+
 
 /* global variables */
 
 struct timespec start, end; /* for starting the clock, and taking splits */
 
+struct chrome_trace trace;  /* the optional trace file */
+int  tracing = 0;           /* 1 if a trace file was named on the command line */
+long slice_start_us = 0;    /* when the running task last started to run */
+
 #define MIN_ARGV   2  /* There is one command-line parameter, so we require argv >= 2*/
 #define MAX_TASKS 12  /* the maximum number of tasks that we plan to consider */
 
@@ -148,7 +163,7 @@ int main (int argc, char *argv[] )
     /* check for the correct number of arguments */
     if (argc < MIN_ARGV)
         {
-            fprintf(stderr,"Usage is: ./RM_file_reader input_file \n");
+            fprintf(stderr,"Usage is: ./RM_file_reader input_file [trace_file.json]\n");
             return  EXIT_FAILURE;
         }
 
@@ -258,6 +273,22 @@ int main (int argc, char *argv[] )
     /* parent process (parent only, all "child" processes have exited by this point) */
     /*  I put away childish things... */
 
+    /* open the optional trace file, with one named track per task type.
+       This is done in the parent only, after the fork(), so that no child inherits a part-filled trace buffer */
+    if (argc > MIN_ARGV)
+        {
+            if(chrome_trace_open(&trace, argv[2], "RM_simulator_07") != 0)
+                return EXIT_FAILURE;
+            tracing = 1;
+            for (i=0; i<N_tasks ; i++)
+                {
+                    char track_name[64];
+                    (void) snprintf(track_name, sizeof(track_name), "task %ld (C = %ld, T = %ld)",
+                                    task_type_in[i], computing_time_in[i], recurrence_time_in[i]);
+                    chrome_trace_name_track(&trace, task_type_in[i], track_name);
+                }
+        }
+
 
 
     /* set the flag for non-blocking of pd[] */
@@ -288,6 +319,7 @@ int main (int argc, char *argv[] )
 
                     /* We will reckon time, from the scheduler's point of view. */
                     tds.absolute_arrival_time = elapsed_time_us();
+                    if(tracing) chrome_trace_instant(&trace, tds.task_type, (double) tds.absolute_arrival_time, "arrival");
 
                     /* create a new task-drescription structure and retain a link to this data */
                     new_tds_ptr  = copy_task_description_structure( tds ); /* uses malloc() */
@@ -324,6 +356,7 @@ int main (int argc, char *argv[] )
                                             /* Calculate the waiting time for this task */
                                             ( temp_tds_ptr->waiting_time ) = elapsed_time_us() - ( temp_tds_ptr->absolute_arrival_time );
                                             ( temp_tds_ptr->remaining_computing_time ) = 0 ;
+                                            trace_stop(temp_tds_ptr, elapsed_time_us(), 1);
 
                                             /* insert this drescription into the completed queue, for possible later reference */
                                             (void) insert_task_by_arrival( &completed_first_out_ptr, temp_tds_ptr);
@@ -333,6 +366,7 @@ int main (int argc, char *argv[] )
                                         {
                                             /* The old pre-empted task still has some way to go...*/
                                             /* Insert the pre-empted item into the ready queue in priority order */
+                                            trace_stop(temp_tds_ptr, elapsed_time_us(), 0);
 					  (void) insert_task_by_rate( &ready_first_out_ptr, temp_tds_ptr);
                                         }
 
@@ -344,6 +378,7 @@ int main (int argc, char *argv[] )
                                     /* estimate time to completion for this new task*/
                                     expected_completion_time = elapsed_time_us()+ (running_ptr->remaining_computing_time);
                                     /* The new task is deemed to be running */
+                                    trace_start(elapsed_time_us());
 
                                     /* Log this event to stdout*/
                                     /* Momentarily log the return to a task of type zero, for consistency*/
@@ -382,6 +417,7 @@ int main (int argc, char *argv[] )
 
                             /* update the estimated time to completion for this new task*/
                             expected_completion_time = elapsed_time_us()+ (running_ptr->remaining_computing_time);
+                            trace_start(elapsed_time_us());
 
                         }
                 }
@@ -407,6 +443,7 @@ int main (int argc, char *argv[] )
 
                     /* estimate time to completion for this new task*/
                     expected_completion_time = elapsed_time_us()+ (running_ptr->remaining_computing_time);
+                    trace_start(elapsed_time_us());
 
                 }
 
@@ -432,6 +469,7 @@ int main (int argc, char *argv[] )
 
                     /* also there is nothing left to run*/
                     ( running_ptr->remaining_computing_time ) = 0 ;
+                    trace_stop(running_ptr, elapsed_time_us(), 1);
 
                     /* Pop the finished task from the running queue */
                     popped_task_description_ptr =  pop_top_task( &running_ptr );
@@ -461,6 +499,13 @@ int main (int argc, char *argv[] )
 
     /* Print the final list of completed tasks to a text file */
     traverse_list( &completed_first_out_ptr );
+
+    /* finish off the trace file */
+    if(tracing)
+        {
+            if(running_ptr != NULL) trace_stop(running_ptr, elapsed_time_us(), 0);
+            if(chrome_trace_close(&trace) != 0) perror("trace file");
+        }
     /* We could print all outputs to data files, if we wanted.... just saying...  */
 
 
@@ -759,3 +804,27 @@ int insert_task_by_rate(struct task_description *(*first_out_ptr), struct task_d
 /* end of insert_task_by_rate() */
 /* very little change from insert_task_by_arrival() */
 /*-----------------------------------------------------------------------------*/
+
+/* The running task has just started (or resumed) running, at time "now" */
+void trace_start(long now)
+{
+    slice_start_us = now;
+}
+
+/*-----------------------------------------------------------------------------*/
+
+/* The running task has just stopped running, at time "now", either completed or preempted.
+   Its slice of execution goes into the trace, and a completion later than the recurrence time,
+   which is also the implicit deadline, is marked as a deadline miss. */
+void trace_stop(struct task_description *task_ptr, long now, int completed)
+{
+    if(!tracing) return;
+
+    chrome_trace_slice(&trace, task_ptr->task_type, (double) slice_start_us, (double) (now - slice_start_us));
+
+    if(!completed)
+        chrome_trace_instant(&trace, task_ptr->task_type, (double) now, "preemption");
+    else if((task_ptr->waiting_time) > (task_ptr->recurrence_time))
+        chrome_trace_instant(&trace, task_ptr->task_type, (double) now, "deadline miss");
+}
+/*-----------------------------------------------------------------------------*/
@@ -0,0 +1,91 @@
+/* RM_trace_export_01.c */
+
+/* Simulate a task file with the discrete-event simulator (schedule_simulation.c),
+   and write the time-line as a Chrome trace-event JSON file.
+
+   This is the fast companion of the trace option of RM_simulator_07.c:
+   the simulated time does not pass in real time, so a run of millions of events
+   takes seconds, and can then be scrubbed through in chrome://tracing or https://ui.perfetto.dev .
+
+   compilation advice:
+   gcc -std=gnu99 -Werror -Wall -Wextra -O2 -o RM_trace_export_01 RM_trace_export_01.c schedule_simulation.c schedule_simulation_trace.c chrome_trace.c task_set.c
+
+   an execution suggestion:
+   ./RM_trace_export_01 RM_example_data_s44_t3.txt RM_example_trace.json
+   ./RM_trace_export_01 -n 10000000 RM_example_data_s44_t3.txt RM_long_trace.json
+
+   options:
+   -e             schedule by EDF, rather than RM
+   -n horizon     simulate until this time, in TIME_TICKs (default: the hyperperiod)
+   -u us_per_tick micro-seconds per TIME_TICK in the trace (default 10000, as in RM_simulator_07.c)
+   */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>    /* needed for getopt() */
+
+#include "task_set.h"
+#include "schedule_simulation.h"
+#include "chrome_trace.h"
+
+#define TIME_TICK 10000 /* in usec, as in RM_simulator_07.c */
+
+int main(int argc, char *argv[])
+{
+    struct task_set     ts;
+    struct chrome_trace trace;
+    struct sim_result   res;
+    int    policy      = POLICY_RM;
+    long   horizon     = 0;
+    double us_per_unit = TIME_TICK;
+    int    opt;
+
+    while((opt = getopt(argc, argv, "en:u:")) != -1)
+        switch(opt)
+            {
+            case 'e':
+                policy = POLICY_EDF;
+                break;
+            case 'n':
+                horizon = atol(optarg);
+                break;
+            case 'u':
+                us_per_unit = atof(optarg);
+                break;
+            default:
+                fprintf(stderr, "Usage is: ./RM_trace_export_01 [-e] [-n horizon] [-u us_per_tick] input_file trace_file.json\n");
+                return EXIT_FAILURE;
+            }
+    if (optind+1 >= argc)
+        {
+            fprintf(stderr, "Usage is: ./RM_trace_export_01 [-e] [-n horizon] [-u us_per_tick] input_file trace_file.json\n");
+            return EXIT_FAILURE;
+        }
+
+    if(read_task_set(argv[optind], &ts) != 0) return EXIT_FAILURE;
+    if(chrome_trace_open(&trace, argv[optind+1], (policy == POLICY_EDF) ? "EDF simulation" : "RM simulation") != 0)
+        return EXIT_FAILURE;
+
+    if(simulate_schedule_traced(&ts, policy, horizon, &trace, us_per_unit, &res) != 0)
+        {
+            fprintf(stderr, "error: the hyperperiod is too long, please give a horizon with -n\n");
+            (void) chrome_trace_close(&trace);
+            return EXIT_FAILURE;
+        }
+
+    printf("simulated events = %ld\n", res.n_events);
+    printf("trace events     = %ld\n", trace.n_events);
+    if(res.schedulable)
+        printf("no deadline was missed\n");
+    else
+        printf("first deadline miss: task %ld at time %ld\n", ts.task_type[res.first_miss_task], res.first_miss_time);
+
+    if(chrome_trace_close(&trace) != 0)
+        {
+            perror("trace file");
+            return EXIT_FAILURE;
+        }
+
+    free_task_set(&ts);
+    return EXIT_SUCCESS;
+}
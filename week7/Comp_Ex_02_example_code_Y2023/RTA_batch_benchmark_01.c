@@ -0,0 +1,174 @@
+/* RTA_batch_benchmark_01.c */
+
+/* Throughput of Response-Time Analysis over a very large number of small task sets,
+   one set at a time with the scalar loop, and four sets at a time with AVX2 (rta_batch.c).
+
+   The task sets are random: the periods lie between MIN_PERIOD and MAX_PERIOD,
+   utilizations are drawn by UUniFast for a total between U_LOW and U_HIGH,
+   deadlines are implicit, and priorities are Rate-Monotonic.
+
+   compilation advice:
+   gcc -std=gnu99 -Werror -Wall -Wextra -O2 -o RTA_batch_benchmark_01 RTA_batch_benchmark_01.c rta_batch.c -lm
+
+   an execution suggestion:
+   ./RTA_batch_benchmark_01 8 1000000
+
+   The optional parameters are the number of tasks per set (default 8)
+   and the number of task sets (default 262144).
+   */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>    /* defines the types int64_t, for the time functions */
+#include <time.h>      /* needed for clock_gettime(), and CLOCK_MONOTONIC */
+#include <math.h>      /* needed for pow() */
+
+#include "rta_batch.h"
+
+#define DEFAULT_TASKS         8
+#define DEFAULT_SETS     262144
+#define MIN_PERIOD           10
+#define MAX_PERIOD         1000
+#define U_LOW              0.60
+#define U_HIGH             0.95
+#define SEED                 29 /* repeatable random task sets */
+
+/* function templates */
+static void    generate_batch(struct rta_batch *b);
+static int64_t elapsed_time(void);
+static void    error_exit(char *s);
+
+/* Set up structures for the starting and stopping times */
+static struct timespec start, end;
+
+int main(int argc, char *argv[])
+{
+    struct rta_batch b;
+    int     n_tasks = DEFAULT_TASKS;
+    int     n_sets  = DEFAULT_SETS;
+    int     n_ok_scalar;
+    int     n_ok_batch;
+    char   *scalar_schedulable;
+    double *scalar_R;
+    size_t  n;
+    int     s, i;
+    int64_t t_scalar, t_batch;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    if(argc > 1) n_tasks = atoi(argv[1]);
+    if(argc > 2) n_sets  = atoi(argv[2]);
+    if((n_tasks < 1) | (n_sets < 1))
+        {
+            fprintf(stderr,"Usage is: ./RTA_batch_benchmark_01 [n_tasks [n_sets]]\n");
+            return EXIT_FAILURE;
+        }
+
+    if(rta_batch_alloc(&b, n_tasks, n_sets) != 0) error_exit("out of memory");
+    srand(SEED);
+    generate_batch(&b);
+
+    /* the scalar analysis, kept aside for checking */
+    t_scalar = elapsed_time();
+    n_ok_scalar = rta_batch_analyse_scalar(&b);
+    t_scalar = elapsed_time() - t_scalar;
+    if(n_ok_scalar < 0) error_exit("the response times could be too large to hold exactly");
+
+    n = (size_t) n_tasks * (size_t) b.stride;
+    scalar_schedulable = (char *) malloc((size_t) b.stride);
+    scalar_R           = (double *) malloc(n * sizeof(double));
+    if((scalar_schedulable == NULL) | (scalar_R == NULL)) error_exit("out of memory");
+    for (s=0; s<n_sets; s++) scalar_schedulable[s] = b.schedulable[s];
+    for (i=0; i<(int) n; i++) scalar_R[i] = b.R[i];
+
+    /* the batched analysis */
+    t_batch = elapsed_time();
+    n_ok_batch = rta_batch_analyse(&b);
+    t_batch = elapsed_time() - t_batch;
+
+    /* both must give the same answers */
+    if(n_ok_batch != n_ok_scalar) error_exit("the scalar and batched analyses disagree");
+    for (s=0; s<n_sets; s++)
+        {
+            if(b.schedulable[s] != scalar_schedulable[s]) error_exit("the scalar and batched analyses disagree");
+            if(b.schedulable[s])
+                for (i=0; i<n_tasks; i++)
+                    if(b.R[i*b.stride + s] != scalar_R[i*b.stride + s])
+                        error_exit("the scalar and batched response times disagree");
+        }
+
+    printf("%d task sets of %d tasks, %d schedulable\n", n_sets, n_tasks, n_ok_batch);
+    printf("kernel\t\ttime (ms)\ttask sets per second\n");
+    printf("scalar\t\t%ld\t\t%.0f\n", (long) (t_scalar/1000000), ((double) n_sets) * 1e9 / ((double) t_scalar));
+    printf("%s\t\t%ld\t\t%.0f\n", rta_batch_has_avx2() ? "AVX2" : "scalar*", (long) (t_batch/1000000),
+           ((double) n_sets) * 1e9 / ((double) t_batch));
+    if(!rta_batch_has_avx2()) printf("* no AVX2 on this processor, the batch fell back to the scalar loop\n");
+    printf("speed-up\t%.2fx\n", ((double) t_scalar) / ((double) t_batch));
+
+    free(scalar_schedulable);
+    free(scalar_R);
+    rta_batch_free(&b);
+    return EXIT_SUCCESS;
+}
+
+/*-----------------------------------------------------------------------------*/
+
+/* Fill the batch with random task sets, each sorted into Rate-Monotonic order */
+static void generate_batch(struct rta_batch *b)
+{
+    int    s, i, j;
+    int    stride = b->stride;
+    double sum_U, next_sum_U, U_i;
+    long   T, C;
+
+    for (s=0; s<b->n_sets; s++)
+        {
+            sum_U = U_LOW + (U_HIGH - U_LOW) * ((double) rand() / (double) RAND_MAX);
+            for (i=0; i<b->n_tasks; i++)
+                {
+                    /* UUniFast */
+                    if(i < b->n_tasks-1)
+                        {
+                            next_sum_U = sum_U * pow((double) rand() / (double) RAND_MAX, 1.0/(double) (b->n_tasks-1-i));
+                            U_i = sum_U - next_sum_U;
+                            sum_U = next_sum_U;
+                        }
+                    else
+                        U_i = sum_U;
+
+                    T = MIN_PERIOD + rand() % (MAX_PERIOD - MIN_PERIOD + 1);
+                    C = (long) (U_i * (double) T);
+                    if(C < 1) C = 1;
+
+                    /* insertion sort by period, shortest first, to give RM priorities */
+                    for (j=i; (j > 0) && (b->T[(j-1)*stride + s] > (double) T); j--)
+                        {
+                            b->C[j*stride + s] = b->C[(j-1)*stride + s];
+                            b->T[j*stride + s] = b->T[(j-1)*stride + s];
+                        }
+                    b->C[j*stride + s] = (double) C;
+                    b->T[j*stride + s] = (double) T;
+                }
+            for (i=0; i<b->n_tasks; i++)
+                b->D[i*stride + s] = b->T[i*stride + s]; /* implicit deadlines */
+        }
+}
+
+/*-----------------------------------------------------------------------------*/
+
+/* A standard formatter for printing eror messages, and exiting */
+static void error_exit(char *s)
+{
+    fprintf(stderr, "\nerror: %s - bye!\n",s);
+    exit(1);
+}
+
+/*-----------------------------------------------------------------------------*/
+
+/* determine the elapsed time, since the program was started, in ns */
+static int64_t elapsed_time(void)
+{
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    return (int64_t) ((end.tv_sec * 1000000000) + end.tv_nsec) -
+           ((start.tv_sec * 1000000000) + start.tv_nsec);
+}
@@ -0,0 +1,192 @@
+/* RTA_incremental_01.c */
+
+/* Response-Time Analysis of a task file, and a small design-space search that
+   compares incremental re-analysis with analysing the whole set again after every change.
+
+   compilation advice:
+   gcc -std=gnu99 -Werror -Wall -Wextra -O2 -o RTA_incremental_01 RTA_incremental_01.c response_time_analysis.c task_set.c
+
+   an execution suggestion:
+   ./RTA_incremental_01 RM_example_data_s44_t3.txt
+   ./RTA_incremental_01 RTA_example_data_t20.txt 50
+
+   The optional second parameter is the number of times to repeat the search, for steadier timings.
+
+   The search is the kind of loop that a configuration tool runs:
+   for every task in turn, grow its computing time one TIME_TICK at a time
+   until the set is no longer schedulable, then put it back.
+   Each step changes only one C, so only the tasks at, or below, its priority need another look,
+   and their fixed points can start where they were.
+
+   The saving is a constant factor, not orders of magnitude. Averaged over the tasks, a step
+   still re-analyses about half of the set, and a warm start saves some of the iterations of each,
+   not all of them. Measured: 1.8x fewer iterations (1.3x the time) on RM_example_data_s44_t3.txt,
+   and 3.9x fewer iterations (about 3x the time) on RTA_example_data_t20.txt. The gain grows with
+   the number of tasks only when the changes fall on the lowest priorities, where one task,
+   rather than n, is looked at again.
+   */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>    /* defines the types int64_t, for the time functions */
+#include <time.h>      /* needed for clock_gettime(), and CLOCK_MONOTONIC */
+
+#include "task_set.h"
+#include "response_time_analysis.h"
+
+#define MIN_ARGV 2 /* There is one required command-line parameter, so we require argc >= 2 */
+
+/* function templates */
+static int64_t elapsed_time(void);
+static long search_incremental(struct rta_state *rs, long *max_C);
+static long search_full(struct rta_state *rs, long *max_C);
+
+/* Set up structures for the starting and stopping times */
+static struct timespec start, end;
+
+int main(int argc, char *argv[])
+{
+    struct task_set  ts;
+    struct rta_state rs;
+    int     i;
+    int     k;
+    int     n_repeat = 1;      /* the number of times to repeat the search */
+    long   *max_C_inc;         /* the largest schedulable C of each task, found incrementally */
+    long   *max_C_full;        /* the same, found by re-analysing the whole set */
+    long    iterations_inc  = 0;
+    long    iterations_full = 0;
+    int64_t t_inc;             /* times, in ns */
+    int64_t t_full;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    /* check for the correct number of arguments */
+    if (argc < MIN_ARGV)
+        {
+            fprintf(stderr,"Usage is: ./RTA_incremental_01 input_file [n_repeat]\n");
+            return EXIT_FAILURE;
+        }
+    if (argc > MIN_ARGV) n_repeat = atoi(argv[2]);
+    if (n_repeat < 1) n_repeat = 1;
+
+    if(read_task_set(argv[1], &ts) != 0) return EXIT_FAILURE;
+
+    if(rta_init(&rs, &ts) != 0)
+        {
+            fprintf(stderr, "rta_init(): out of memory\n");
+            return EXIT_FAILURE;
+        }
+
+    /* The plain analysis, one line per task, in the order of the task file */
+    printf("task_type\tC\tT\tD\tpriority\tR\n");
+    for (i=0; i<rs.n_tasks; i++)
+        printf("%ld\t%ld\t%ld\t%ld\t%d\t%ld%s\n", ts.task_type[i], rs.C[i], rs.T[i], rs.D[i],
+               rs.priority_of[i], rs.R[i], (rs.R[i] > rs.D[i]) ? "\tdeadline missed" : "");
+    printf("The task set is %sschedulable under RM\n\n", rta_is_schedulable(&rs) ? "" : "NOT ");
+
+    if(!rta_is_schedulable(&rs))
+        {
+            /* Nothing to search for, the set does not fit as it stands */
+            rta_free(&rs);
+            free_task_set(&ts);
+            return EXIT_SUCCESS;
+        }
+
+    max_C_inc  = (long *) malloc((size_t) (rs.n_tasks+1) * sizeof(long));
+    max_C_full = (long *) malloc((size_t) (rs.n_tasks+1) * sizeof(long));
+    if((max_C_inc == NULL) | (max_C_full == NULL))
+        {
+            fprintf(stderr, "out of memory\n");
+            return EXIT_FAILURE;
+        }
+
+    /* The same search, done both ways */
+    t_inc = elapsed_time();
+    for (k=0; k<n_repeat; k++) iterations_inc += search_incremental(&rs, max_C_inc);
+    t_inc = elapsed_time() - t_inc;
+
+    t_full = elapsed_time();
+    for (k=0; k<n_repeat; k++) iterations_full += search_full(&rs, max_C_full);
+    t_full = elapsed_time() - t_full;
+
+    printf("task_type\tC\tmax_C\n");
+    for (i=0; i<rs.n_tasks; i++)
+        {
+            printf("%ld\t%ld\t%ld\n", ts.task_type[i], rs.C[i], max_C_inc[i]);
+            if(max_C_inc[i] != max_C_full[i])
+                {
+                    fprintf(stderr, "error: incremental and full analysis disagree for task %ld (%ld, %ld)\n",
+                            ts.task_type[i], max_C_inc[i], max_C_full[i]);
+                    return EXIT_FAILURE;
+                }
+        }
+
+    printf("\nsearch\t\titerations\ttime (us)\n");
+    printf("incremental\t%ld\t\t%ld\n", iterations_inc,  (long) (t_inc/1000));
+    printf("full\t\t%ld\t\t%ld\n",      iterations_full, (long) (t_full/1000));
+    if((iterations_inc > 0) & (t_inc > 0))
+        printf("speed-up\t%.1fx\t\t%.1fx\n", ((double) iterations_full)/((double) iterations_inc),
+               ((double) t_full)/((double) t_inc));
+
+    free(max_C_inc);
+    free(max_C_full);
+    rta_free(&rs);
+    free_task_set(&ts);
+    return EXIT_SUCCESS;
+}
+
+/*-----------------------------------------------------------------------------*/
+
+/* Grow each C in turn, re-analysing incrementally, and return the number of fixed-point iterations used */
+static long search_incremental(struct rta_state *rs, long *max_C)
+{
+    int  i;
+    long C0;
+    long before = rs->n_iterations;
+
+    for (i=0; i<rs->n_tasks; i++)
+        {
+            C0 = rs->C[i];
+            while(rta_set_computing_time(rs, i, rs->C[i]+1) == 0) ;
+            max_C[i] = rs->C[i] - 1;
+            (void) rta_set_computing_time(rs, i, C0); /* put it back */
+        }
+    return rs->n_iterations - before;
+}
+
+/*-----------------------------------------------------------------------------*/
+
+/* The same search, analysing the whole set from scratch after every step */
+static long search_full(struct rta_state *rs, long *max_C)
+{
+    int  i;
+    long C0;
+    long before = rs->n_iterations;
+
+    for (i=0; i<rs->n_tasks; i++)
+        {
+            C0 = rs->C[i];
+            do
+                {
+                    rs->C[i]++;
+                }
+            while(rta_analyse_all(rs) == 0);
+            max_C[i] = rs->C[i] - 1;
+            rs->C[i] = C0; /* put it back */
+            (void) rta_analyse_all(rs);
+        }
+    return rs->n_iterations - before;
+}
+
+/*-----------------------------------------------------------------------------*/
+
+/*
+   A user function to extract the number of nanoseconds that have elapsed,
+   since the starting time was reset.
+*/
+static int64_t elapsed_time(void)
+{
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    return (int64_t) ((end.tv_sec * 1000000000) + end.tv_nsec) -
+           ((start.tv_sec * 1000000000) + start.tv_nsec);
+}
@@ -0,0 +1,92 @@
+/* chrome_trace.c */
+
+/* Chrome trace-event JSON output, see chrome_trace.h
+   The format is described in the "Trace Event Format" document, from the Chromium project. */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "chrome_trace.h"
+
+#define TRACE_BUFFER_SIZE (1<<20) /* one MB of stdio buffer, so that a million events need few write()s */
+#define TRACE_PID         1       /* every track belongs to the one simulated processor */
+
+/* function templates, for local helpers */
+static void separator(struct chrome_trace *ct);
+
+/*-----------------------------------------------------------------------------*/
+
+int chrome_trace_open(struct chrome_trace *ct, const char *file_name, const char *process_name)
+{
+    ct->n_events = 0;
+    ct->fp = fopen(file_name, "w");
+    if(!ct->fp)
+        {
+            perror("File opening failed");
+            return 1;
+        }
+
+    ct->buffer = (char *) malloc(TRACE_BUFFER_SIZE);
+    if(ct->buffer != NULL) (void) setvbuf(ct->fp, ct->buffer, _IOFBF, TRACE_BUFFER_SIZE);
+
+    fprintf(ct->fp, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+    fprintf(ct->fp, "{\"ph\":\"M\",\"name\":\"process_name\",\"pid\":%d,\"args\":{\"name\":\"%s\"}}",
+            TRACE_PID, process_name);
+    ct->n_events++;
+    return 0;
+}
+
+/*-----------------------------------------------------------------------------*/
+
+void chrome_trace_name_track(struct chrome_trace *ct, long task_type, const char *name)
+{
+    separator(ct);
+    fprintf(ct->fp, "{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":%d,\"tid\":%ld,\"args\":{\"name\":\"%s\"}}",
+            TRACE_PID, task_type, name);
+    /* keep the tracks in the order of the task types */
+    separator(ct);
+    fprintf(ct->fp, "{\"ph\":\"M\",\"name\":\"thread_sort_index\",\"pid\":%d,\"tid\":%ld,\"args\":{\"sort_index\":%ld}}",
+            TRACE_PID, task_type, task_type);
+}
+
+/*-----------------------------------------------------------------------------*/
+
+void chrome_trace_slice(struct chrome_trace *ct, long task_type, double start_us, double duration_us)
+{
+    separator(ct);
+    fprintf(ct->fp, "{\"ph\":\"X\",\"name\":\"task %ld\",\"pid\":%d,\"tid\":%ld,\"ts\":%.3f,\"dur\":%.3f}",
+            task_type, TRACE_PID, task_type, start_us, duration_us);
+}
+
+/*-----------------------------------------------------------------------------*/
+
+void chrome_trace_instant(struct chrome_trace *ct, long task_type, double time_us, const char *name)
+{
+    separator(ct);
+    fprintf(ct->fp, "{\"ph\":\"i\",\"s\":\"t\",\"name\":\"%s\",\"pid\":%d,\"tid\":%ld,\"ts\":%.3f}",
+            name, TRACE_PID, task_type, time_us);
+}
+
+/*-----------------------------------------------------------------------------*/
+
+int chrome_trace_close(struct chrome_trace *ct)
+{
+    int ret_val;
+
+    fprintf(ct->fp, "\n]}\n");
+    ret_val = fclose(ct->fp); /* flushes the buffer, before it is freed */
+    free(ct->buffer);
+    ct->fp     = NULL;
+    ct->buffer = NULL;
+    return ret_val;
+}
+
+/*-----------------------------------------------------------------------------*/
+
+/* every event after the first is separated from the one before by a comma */
+static void separator(struct chrome_trace *ct)
+{
+    fprintf(ct->fp, ",\n");
+    ct->n_events++;
+}
+/*-----------------------------------------------------------------------------*/
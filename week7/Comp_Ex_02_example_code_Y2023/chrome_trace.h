@@ -0,0 +1,42 @@
+/* chrome_trace.h */
+
+/* Writing scheduler time-lines as Chrome trace-event JSON.
+
+   The file can be opened in chrome://tracing, or at https://ui.perfetto.dev ,
+   which can scrub through millions of events, unlike a matplotlib step plot.
+   Each task type gets its own track (a "thread" in the trace-event format),
+   execution is shown as slices on that track, and arrivals, preemptions and
+   deadline misses as instant events.
+
+   Time stamps are in micro-seconds, the native unit of the trace-event format,
+   and of RM_simulator_07.c. Events are streamed to the file as they happen,
+   through a large stdio buffer, so nothing is held in memory. */
+
+#ifndef CHROME_TRACE_H
+#define CHROME_TRACE_H
+
+#include <stdio.h>
+
+struct chrome_trace
+{
+    FILE *fp;
+    long  n_events; /* the number of events written so far */
+    char *buffer;   /* the stdio buffer for fp */
+};
+
+/* create the trace file, returns 0 on success */
+int  chrome_trace_open(struct chrome_trace *ct, const char *file_name, const char *process_name);
+
+/* label the track of a task type, e.g. "task 2 (T = 150)" */
+void chrome_trace_name_track(struct chrome_trace *ct, long task_type, const char *name);
+
+/* the task ran from start_us for duration_us */
+void chrome_trace_slice(struct chrome_trace *ct, long task_type, double start_us, double duration_us);
+
+/* a moment on the track of a task: "arrival", "preemption", "deadline miss", ... */
+void chrome_trace_instant(struct chrome_trace *ct, long task_type, double time_us, const char *name);
+
+/* finish the JSON and close the file, returns 0 on success */
+int  chrome_trace_close(struct chrome_trace *ct);
+
+#endif /* CHROME_TRACE_H */
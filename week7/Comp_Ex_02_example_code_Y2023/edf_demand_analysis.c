@@ -0,0 +1,175 @@
+/* edf_demand_analysis.c */
+
+/* The Processor-Demand Criterion for EDF, by QPA, and exhaustively, see edf_demand_analysis.h */
+
+#include <limits.h>    /* needed for LONG_MAX */
+
+#include "edf_demand_analysis.h"
+
+#define BOUND_LIMIT (LONG_MAX/4) /* give up on interval bounds beyond this, rather than overflow */
+#define U_EPSILON   1e-12        /* allow for rounding in the sum of C/T, so that U == 1 is still 1 */
+
+/* function templates, for local helpers */
+static int    interval_bound(const struct task_set *ts, struct demand_result *res);
+static long   deadline_before(const struct task_set *ts, long t);
+static double utilization(const struct task_set *ts);
+
+/*-----------------------------------------------------------------------------*/
+
+long processor_demand(const struct task_set *ts, long t)
+{
+    long h = 0;
+    int  i;
+
+    for (i=0; i<ts->n_tasks; i++)
+        if(ts->deadline[i] <= t)
+            h += ((t - ts->deadline[i]) / ts->recurrence_time[i] + 1) * ts->computing_time[i];
+    return h;
+}
+
+/*-----------------------------------------------------------------------------*/
+
+int edf_qpa(const struct task_set *ts, struct demand_result *res)
+{
+    long t;
+    long h;
+    long d_min;
+    int  i;
+
+    if(interval_bound(ts, res) != 0) return 1;
+    if(!res->schedulable) return 0; /* U > 1, no need to look any further */
+
+    d_min = LONG_MAX;
+    for (i=0; i<ts->n_tasks; i++)
+        if(ts->deadline[i] < d_min) d_min = ts->deadline[i];
+
+    /* start at the last deadline before L, and work backwards */
+    t = deadline_before(ts, res->L);
+    h = processor_demand(ts, t);
+    res->n_points++;
+
+    while((h <= t) & (h > d_min))
+        {
+            if(h < t)
+                t = h;                      /* no deadline in (h, t] can fail, jump straight down */
+            else
+                t = deadline_before(ts, t); /* h(t) == t, step to the previous deadline */
+
+            h = processor_demand(ts, t);
+            res->n_points++;
+        }
+
+    res->schedulable = (h <= d_min);
+    if(!res->schedulable) res->failure_time = t;
+    return 0;
+}
+
+/*-----------------------------------------------------------------------------*/
+
+int edf_pdc_all_deadlines(const struct task_set *ts, struct demand_result *res)
+{
+    long d;
+    int  i;
+
+    if(interval_bound(ts, res) != 0) return 1;
+    if(!res->schedulable) return 0;
+
+    /* every absolute deadline of every task, below L */
+    for (i=0; i<ts->n_tasks; i++)
+        for (d=ts->deadline[i]; d<res->L; d+=ts->recurrence_time[i])
+            {
+                res->n_points++;
+                if(processor_demand(ts, d) > d)
+                    {
+                        if((res->failure_time < 0) | (d < res->failure_time)) res->failure_time = d;
+                        res->schedulable = 0;
+                        break;
+                    }
+            }
+    return 0;
+}
+
+/*-----------------------------------------------------------------------------*/
+
+/* Fill in L, the smaller of the synchronous busy period and the utilization bound,
+   and note a utilization above 1 as unschedulable. */
+static int interval_bound(const struct task_set *ts, struct demand_result *res)
+{
+    double U = utilization(ts);
+    double L_a;
+    long   L_b;
+    long   next_L_b;
+    long   D_max = 0;
+    double sum = 0.0;
+    int    i;
+
+    res->schedulable  = 1;
+    res->L            = 0;
+    res->n_points     = 0;
+    res->failure_time = -1;
+
+    if(U > 1.0 + U_EPSILON)
+        {
+            res->schedulable = 0;
+            return 0;
+        }
+
+    /* the synchronous busy period, the fixed point of w = sum ceil(w/T_i) * C_i */
+    L_b = 0;
+    for (i=0; i<ts->n_tasks; i++) L_b += ts->computing_time[i];
+    while(1)
+        {
+            next_L_b = 0;
+            for (i=0; i<ts->n_tasks; i++)
+                next_L_b += ((L_b + ts->recurrence_time[i] - 1) / ts->recurrence_time[i]) * ts->computing_time[i];
+            if(next_L_b == L_b) break;
+            if(next_L_b > BOUND_LIMIT) return 1;
+            L_b = next_L_b;
+        }
+    res->L = L_b;
+
+    /* the bound from the utilization, only available when U < 1 */
+    if(U < 1.0 - U_EPSILON)
+        {
+            for (i=0; i<ts->n_tasks; i++)
+                {
+                    if(ts->deadline[i] > D_max) D_max = ts->deadline[i];
+                    sum += ((double) (ts->recurrence_time[i] - ts->deadline[i])) *
+                           ((double) ts->computing_time[i]) / ((double) ts->recurrence_time[i]);
+                }
+            L_a = sum / (1.0 - U);
+            if(L_a < (double) D_max) L_a = (double) D_max;
+            if(L_a < (double) res->L) res->L = (long) L_a + 1; /* round up, to be safe */
+        }
+    return 0;
+}
+
+/*-----------------------------------------------------------------------------*/
+
+/* the largest absolute deadline strictly before t, or 0 if there is none */
+static long deadline_before(const struct task_set *ts, long t)
+{
+    long best = 0;
+    long d;
+    int  i;
+
+    for (i=0; i<ts->n_tasks; i++)
+        {
+            if(ts->deadline[i] >= t) continue;
+            d = ts->deadline[i] + ((t - ts->deadline[i] - 1) / ts->recurrence_time[i]) * ts->recurrence_time[i];
+            if(d > best) best = d;
+        }
+    return best;
+}
+
+/*-----------------------------------------------------------------------------*/
+
+static double utilization(const struct task_set *ts)
+{
+    double U = 0.0;
+    int    i;
+    for (i=0; i<ts->n_tasks; i++)
+        U += ((double) ts->computing_time[i]) / ((double) ts->recurrence_time[i]);
+    return U;
+}
+/*-----------------------------------------------------------------------------*/
@@ -0,0 +1,43 @@
+/* edf_demand_analysis.h */
+
+/* The exact schedulability test for EDF with constrained deadlines (D <= T),
+   the Processor-Demand Criterion (PDC):
+
+       the set is schedulable if and only if  U <= 1  and  h(t) <= t  for every absolute deadline t < L
+
+   where the processor demand in [0, t] is
+
+       h(t) = sum over tasks with D_i <= t of ( floor((t - D_i) / T_i) + 1 ) * C_i
+
+   and L bounds the interval that must be checked (the synchronous busy period,
+   or the bound from the utilization, whichever is smaller).
+
+   Quick Processor-demand Analysis (QPA, Zhang and Burns) walks backwards from L,
+   jumping straight to t = h(t) whenever h(t) < t, so it usually checks only a handful of points,
+   rather than every deadline up to L.
+
+   Times are in the units of the task file. */
+
+#ifndef EDF_DEMAND_ANALYSIS_H
+#define EDF_DEMAND_ANALYSIS_H
+
+#include "task_set.h"
+
+struct demand_result
+{
+    int  schedulable;   /* 1 if every deadline is met under EDF */
+    long L;             /* the end of the interval that had to be checked */
+    long n_points;      /* the number of times h(t) was evaluated */
+    long failure_time;  /* a t with h(t) > t, or -1, as when U > 1 is enough to fail */
+};
+
+/* the processor demand h(t) of the task set in the interval [0, t] */
+long processor_demand(const struct task_set *ts, long t);
+
+/* the exact test, by QPA. Returns 0, or non-zero if the interval bound overflows */
+int  edf_qpa(const struct task_set *ts, struct demand_result *res);
+
+/* the exact test, checking h(t) at every absolute deadline below L, for comparison */
+int  edf_pdc_all_deadlines(const struct task_set *ts, struct demand_result *res);
+
+#endif /* EDF_DEMAND_ANALYSIS_H */
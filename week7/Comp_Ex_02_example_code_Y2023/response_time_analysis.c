@@ -0,0 +1,234 @@
+/* response_time_analysis.c */
+
+/* Response-Time Analysis with incremental re-analysis, see response_time_analysis.h */
+
+#include <stdlib.h>
+
+#include "response_time_analysis.h"
+
+/* function templates, for local helpers */
+static long rta_task(struct rta_state *rs, int p, int warm);
+static void place_by_rate(struct rta_state *rs, int task);
+static int  count_unschedulable(struct rta_state *rs);
+
+/*-----------------------------------------------------------------------------*/
+
+int rta_init(struct rta_state *rs, const struct task_set *ts)
+{
+    int    i;
+    size_t n = (size_t) ts->n_tasks + 1; /* +1 keeps malloc() honest for an empty set */
+
+    rs->n_tasks      = 0; /* grows as the tasks are placed, below */
+    rs->n_iterations = 0;
+    rs->C            = (long *) malloc(n * sizeof(long));
+    rs->T            = (long *) malloc(n * sizeof(long));
+    rs->D            = (long *) malloc(n * sizeof(long));
+    rs->R            = (long *) malloc(n * sizeof(long));
+    rs->by_priority  = (int *)  malloc(n * sizeof(int));
+    rs->priority_of  = (int *)  malloc(n * sizeof(int));
+
+    if((rs->C == NULL) | (rs->T == NULL) | (rs->D == NULL) | (rs->R == NULL) |
+       (rs->by_priority == NULL) | (rs->priority_of == NULL))
+        {
+            rta_free(rs);
+            return 1;
+        }
+
+    /* Build the priority order one task at a time, like insert_task_by_rate() does for the ready queue.
+       Tasks of equal period keep the order of the task file. */
+    for (i=0; i<ts->n_tasks; i++)
+        {
+            rs->C[i] = ts->computing_time[i];
+            rs->T[i] = ts->recurrence_time[i];
+            rs->D[i] = ts->deadline[i];
+            rs->R[i] = 0;
+            rs->by_priority[i] = i;
+            rs->priority_of[i] = i;
+            rs->n_tasks = i+1;
+            place_by_rate(rs, i);
+        }
+
+    (void) rta_analyse_all(rs);
+    return 0;
+}
+
+/*-----------------------------------------------------------------------------*/
+
+void rta_free(struct rta_state *rs)
+{
+    free(rs->C);
+    free(rs->T);
+    free(rs->D);
+    free(rs->R);
+    free(rs->by_priority);
+    free(rs->priority_of);
+    rs->C = rs->T = rs->D = rs->R = NULL;
+    rs->by_priority = rs->priority_of = NULL;
+    rs->n_tasks = 0;
+}
+
+/*-----------------------------------------------------------------------------*/
+
+int rta_analyse_all(struct rta_state *rs)
+{
+    int p;
+    for (p=0; p<rs->n_tasks; p++)
+        (void) rta_task(rs, p, 0);
+    return count_unschedulable(rs);
+}
+
+/*-----------------------------------------------------------------------------*/
+
+int rta_set_computing_time(struct rta_state *rs, int task, long C)
+{
+    int p;
+    int warm; /* 1 when the change can only add interference */
+
+    if((task < 0) | (task >= rs->n_tasks) | (C <= 0)) return -1;
+    if(C == rs->C[task]) return rs->n_unschedulable;
+
+    warm = (C > rs->C[task]);
+    rs->C[task] = C;
+
+    /* Tasks of higher priority do not see this task at all, so only look downwards */
+    for (p=rs->priority_of[task]; p<rs->n_tasks; p++)
+        {
+            /* A task that already missed its deadline can only miss it by more, when interference grows */
+            if(warm & (rs->R[rs->by_priority[p]] > rs->D[rs->by_priority[p]])) continue;
+            (void) rta_task(rs, p, warm);
+        }
+
+    return count_unschedulable(rs);
+}
+
+/*-----------------------------------------------------------------------------*/
+
+int rta_set_recurrence_time(struct rta_state *rs, int task, long T)
+{
+    int p;
+    int old_p;
+    int first_p; /* the highest priority that is affected by the change */
+    int shorter; /* 1 when the period got shorter, which can only add interference to the others */
+    int j;
+
+    if((task < 0) | (task >= rs->n_tasks) | (T <= 0)) return -1;
+    if(T == rs->T[task]) return rs->n_unschedulable;
+
+    shorter = (T < rs->T[task]);
+    if(rs->D[task] == rs->T[task]) rs->D[task] = T; /* keep an implicit deadline implicit */
+    rs->T[task] = T;
+
+    /* The task may change its place in the Rate-Monotonic order */
+    old_p = rs->priority_of[task];
+    place_by_rate(rs, task);
+    first_p = (rs->priority_of[task] < old_p) ? rs->priority_of[task] : old_p;
+
+    for (p=first_p; p<rs->n_tasks; p++)
+        {
+            j = rs->by_priority[p];
+            if(j == task)
+                {
+                    /* Its own set of higher-priority tasks shrank if it moved up, and can only have grown otherwise.
+                       Its deadline may also have moved, so it is always re-evaluated. */
+                    (void) rta_task(rs, p, !shorter);
+                }
+            else
+                {
+                    if(shorter & (rs->R[j] > rs->D[j])) continue;
+                    (void) rta_task(rs, p, shorter);
+                }
+        }
+
+    return count_unschedulable(rs);
+}
+
+/*-----------------------------------------------------------------------------*/
+
+int rta_is_schedulable(const struct rta_state *rs)
+{
+    return rs->n_unschedulable == 0;
+}
+
+/*-----------------------------------------------------------------------------*/
+
+/* Iterate the response time of the task with priority p to its fixed point.
+   The cold start is C_i plus one instance of every higher-priority task,
+   a warm start may begin from the previous R, when that is known to be a lower bound.
+   The iteration stops as soon as R passes the deadline. */
+static long rta_task(struct rta_state *rs, int p, int warm)
+{
+    int  i = rs->by_priority[p];
+    int  q;
+    int  j;
+    long R;
+    long next_R;
+
+    /* the cold lower bound */
+    R = rs->C[i];
+    for (q=0; q<p; q++) R += rs->C[rs->by_priority[q]];
+
+    if(warm & (rs->R[i] > R)) R = rs->R[i];
+
+    while(1)
+        {
+            rs->n_iterations++;
+
+            next_R = rs->C[i];
+            for (q=0; q<p; q++)
+                {
+                    j = rs->by_priority[q];
+                    next_R += ((R + rs->T[j] - 1) / rs->T[j]) * rs->C[j]; /* ceil(R/T_j) * C_j */
+                }
+
+            if((next_R == R) | (next_R > rs->D[i])) break;
+            R = next_R;
+        }
+
+    rs->R[i] = next_R;
+    return next_R;
+}
+
+/*-----------------------------------------------------------------------------*/
+
+/* Move a task to its Rate-Monotonic place in by_priority[], shortest period first.
+   Ties are broken by the order in the task file. */
+static void place_by_rate(struct rta_state *rs, int task)
+{
+    int p = rs->priority_of[task];
+    int other;
+
+    /* bubble upwards */
+    while(p > 0)
+        {
+            other = rs->by_priority[p-1];
+            if((rs->T[other] < rs->T[task]) | ((rs->T[other] == rs->T[task]) & (other < task))) break;
+            rs->by_priority[p] = other;
+            rs->priority_of[other] = p;
+            p--;
+        }
+
+    /* bubble downwards */
+    while(p < rs->n_tasks-1)
+        {
+            other = rs->by_priority[p+1];
+            if((rs->T[other] > rs->T[task]) | ((rs->T[other] == rs->T[task]) & (other > task))) break;
+            rs->by_priority[p] = other;
+            rs->priority_of[other] = p;
+            p++;
+        }
+
+    rs->by_priority[p]    = task;
+    rs->priority_of[task] = p;
+}
+
+/*-----------------------------------------------------------------------------*/
+
+static int count_unschedulable(struct rta_state *rs)
+{
+    int i;
+    rs->n_unschedulable = 0;
+    for (i=0; i<rs->n_tasks; i++)
+        if(rs->R[i] > rs->D[i]) rs->n_unschedulable++;
+    return rs->n_unschedulable;
+}
+/*-----------------------------------------------------------------------------*/
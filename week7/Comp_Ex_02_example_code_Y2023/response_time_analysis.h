@@ -0,0 +1,57 @@
+/* response_time_analysis.h */
+
+/* Response-Time Analysis (RTA), the "completion-time algorithm" mentioned in RM_simulator_07.c,
+   for Rate-Monotonic priorities, with support for incremental re-analysis.
+
+   For the task of priority i, the response time is the smallest fixed point of
+
+       R = C_i + sum over higher priority tasks j of ceil(R / T_j) * C_j
+
+   and the task meets its deadline when R <= D_i.
+
+   The rta_state keeps the fixed point of every task.
+   After one task's C or T is changed, only the tasks at or below the changed priority are
+   re-analysed, and where the change can only add interference, each iteration is
+   warm-started from the previous response time, which is still a lower bound.
+   Where the change removes interference (a smaller C, or a longer T) the old response time
+   may lie beyond the new fixed point, so that task is restarted from its cold lower bound.
+
+   All times are in TIME_TICKs, as in the task files. */
+
+#ifndef RESPONSE_TIME_ANALYSIS_H
+#define RESPONSE_TIME_ANALYSIS_H
+
+#include "task_set.h"
+
+struct rta_state
+{
+    int   n_tasks;
+    long *C;               /* computing times, indexed by task, in the order of the task file */
+    long *T;               /* recurrence times */
+    long *D;               /* relative deadlines */
+    long *R;               /* response times, R[i] > D[i] means that task i misses its deadline,
+                              and R[i] is then only a lower bound */
+    int  *by_priority;     /* by_priority[p] is the task with priority p, 0 is the highest */
+    int  *priority_of;     /* the inverse of by_priority[] */
+    int   n_unschedulable; /* the number of tasks with R > D */
+    long  n_iterations;    /* the total number of fixed-point iterations so far, for measurements */
+};
+
+/* copy a task set into a new rta_state and analyse it from scratch, returns 0 on success */
+int  rta_init(struct rta_state *rs, const struct task_set *ts);
+
+/* re-analyse every task from its cold lower bound, returns the number of unschedulable tasks */
+int  rta_analyse_all(struct rta_state *rs);
+
+/* change C or T of one task and re-analyse incrementally,
+   returns the number of unschedulable tasks, or -1 for a bad argument.
+   An implicit deadline (D == T) follows a change to T. */
+int  rta_set_computing_time(struct rta_state *rs, int task, long C);
+int  rta_set_recurrence_time(struct rta_state *rs, int task, long T);
+
+/* 1 if every task meets its deadline */
+int  rta_is_schedulable(const struct rta_state *rs);
+
+void rta_free(struct rta_state *rs);
+
+#endif /* RESPONSE_TIME_ANALYSIS_H */
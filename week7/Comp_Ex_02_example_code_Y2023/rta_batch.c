@@ -0,0 +1,251 @@
+/* rta_batch.c */
+
+/* Batched struct-of-arrays Response-Time Analysis, with AVX2, see rta_batch.h */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "rta_batch.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h> /* AVX2 intrinsics, only used inside functions built for the avx2 target */
+#define HAVE_X86 1
+#else
+#define HAVE_X86 0
+#endif
+
+#define ALIGNMENT 32 /* bytes, the width of an AVX2 register */
+
+/* function templates, for local helpers */
+static double *alloc_aligned(size_t n);
+static int     times_exact(const struct rta_batch *b);
+static int     analyse_scalar(struct rta_batch *b);
+#if HAVE_X86
+static int analyse_avx2(struct rta_batch *b);
+#endif
+
+/*-----------------------------------------------------------------------------*/
+
+int rta_batch_alloc(struct rta_batch *b, int n_tasks, int n_sets)
+{
+    size_t n;
+    size_t k;
+
+    b->n_tasks = n_tasks;
+    b->n_sets  = n_sets;
+    b->stride  = ((n_sets + RTA_BATCH_LANES - 1) / RTA_BATCH_LANES) * RTA_BATCH_LANES;
+
+    n = (size_t) n_tasks * (size_t) b->stride;
+    b->C           = alloc_aligned(n);
+    b->T           = alloc_aligned(n);
+    b->D           = alloc_aligned(n);
+    b->R           = alloc_aligned(n);
+    b->schedulable = (char *) malloc((size_t) b->stride);
+
+    if((b->C == NULL) | (b->T == NULL) | (b->D == NULL) | (b->R == NULL) | (b->schedulable == NULL))
+        {
+            rta_batch_free(b);
+            return 1;
+        }
+
+    /* The padding sets, beyond n_sets, are given C = 0, T = D = 1, so that they converge at once */
+    for (k=0; k<n; k++)
+        {
+            b->C[k] = 0.0;
+            b->T[k] = 1.0;
+            b->D[k] = 1.0;
+            b->R[k] = 0.0;
+        }
+    memset(b->schedulable, 0, (size_t) b->stride);
+    return 0;
+}
+
+/*-----------------------------------------------------------------------------*/
+
+void rta_batch_free(struct rta_batch *b)
+{
+    free(b->C);
+    free(b->T);
+    free(b->D);
+    free(b->R);
+    free(b->schedulable);
+    b->C = b->T = b->D = b->R = NULL;
+    b->schedulable = NULL;
+}
+
+/*-----------------------------------------------------------------------------*/
+
+int rta_batch_has_avx2(void)
+{
+#if HAVE_X86
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2") ? 1 : 0;
+#else
+    return 0;
+#endif
+}
+
+/*-----------------------------------------------------------------------------*/
+
+int rta_batch_analyse(struct rta_batch *b)
+{
+    if(!times_exact(b)) return -1;
+#if HAVE_X86
+    if(rta_batch_has_avx2()) return analyse_avx2(b);
+#endif
+    return analyse_scalar(b);
+}
+
+/*-----------------------------------------------------------------------------*/
+
+int rta_batch_analyse_scalar(struct rta_batch *b)
+{
+    if(!times_exact(b)) return -1;
+    return analyse_scalar(b);
+}
+
+/*-----------------------------------------------------------------------------*/
+
+/* One set at a time, one task at a time, in the ordinary way.
+   Analysis of a set stops at its first missed deadline. */
+static int analyse_scalar(struct rta_batch *b)
+{
+    int  s, i, j;
+    int  n_ok = 0;
+    long R, next_R, T_j;
+    int  stride = b->stride;
+
+    for (s=0; s<b->n_sets; s++)
+        {
+            b->schedulable[s] = 1;
+            for (i=0; (i<b->n_tasks) & b->schedulable[s]; i++)
+                {
+                    R = 0;
+                    for (j=0; j<=i; j++) R += (long) b->C[j*stride + s];
+
+                    while(1)
+                        {
+                            next_R = (long) b->C[i*stride + s];
+                            for (j=0; j<i; j++)
+                                {
+                                    T_j = (long) b->T[j*stride + s];
+                                    next_R += ((R + T_j - 1) / T_j) * (long) b->C[j*stride + s];
+                                }
+                            if(next_R > (long) b->D[i*stride + s])
+                                {
+                                    b->schedulable[s] = 0;
+                                    break;
+                                }
+                            if(next_R == R) break;
+                            R = next_R;
+                        }
+                    b->R[i*stride + s] = (double) next_R;
+                }
+            n_ok += b->schedulable[s];
+        }
+    return n_ok;
+}
+
+/*-----------------------------------------------------------------------------*/
+
+#if HAVE_X86
+/* Four sets in lockstep. "alive" marks the sets that have met every deadline so far,
+   "active" the lanes whose current fixed point is still iterating. */
+__attribute__((target("avx2")))
+static int analyse_avx2(struct rta_batch *b)
+{
+    int     s, i, j, k;
+    int     n_ok = 0;
+    int     stride = b->stride;
+    int     alive_bits;
+    __m256d alive, active, R, next_R, C_i, D_i, C_j, T_j, converged, missed;
+    const __m256d all_ones = _mm256_castsi256_pd(_mm256_set1_epi64x(-1));
+
+    for (s=0; s<stride; s+=RTA_BATCH_LANES)
+        {
+            alive = all_ones;
+
+            for (i=0; i<b->n_tasks; i++)
+                {
+                    C_i = _mm256_load_pd(&b->C[i*stride + s]);
+                    D_i = _mm256_load_pd(&b->D[i*stride + s]);
+
+                    /* the cold lower bound, one instance of every task of priority 0..i */
+                    R = C_i;
+                    for (j=0; j<i; j++) R = _mm256_add_pd(R, _mm256_load_pd(&b->C[j*stride + s]));
+
+                    active = alive;
+                    while(_mm256_movemask_pd(active) != 0)
+                        {
+                            next_R = C_i;
+                            for (j=0; j<i; j++)
+                                {
+                                    C_j = _mm256_load_pd(&b->C[j*stride + s]);
+                                    T_j = _mm256_load_pd(&b->T[j*stride + s]);
+                                    /* ceil(R/T_j) * C_j */
+                                    next_R = _mm256_add_pd(next_R,
+                                                           _mm256_mul_pd(_mm256_ceil_pd(_mm256_div_pd(R, T_j)), C_j));
+                                }
+
+                            converged = _mm256_cmp_pd(next_R, R,   _CMP_EQ_OQ);
+                            missed    = _mm256_and_pd(_mm256_cmp_pd(next_R, D_i, _CMP_GT_OQ), active);
+
+                            /* only the active lanes move on */
+                            R      = _mm256_blendv_pd(R, next_R, active);
+                            alive  = _mm256_andnot_pd(missed, alive);
+                            active = _mm256_andnot_pd(_mm256_or_pd(converged, missed), active);
+                        }
+
+                    _mm256_store_pd(&b->R[i*stride + s], R);
+
+                    /* no need to analyse lower priorities when all four sets have failed */
+                    if(_mm256_movemask_pd(alive) == 0) break;
+                }
+
+            alive_bits = _mm256_movemask_pd(alive);
+            for (k=0; k<RTA_BATCH_LANES; k++)
+                if(s+k < b->n_sets)
+                    {
+                        b->schedulable[s+k] = (char) ((alive_bits >> k) & 1);
+                        n_ok += b->schedulable[s+k];
+                    }
+        }
+    return n_ok;
+}
+#endif
+
+/*-----------------------------------------------------------------------------*/
+
+/* 1 if no trial response time of any set can reach RTA_BATCH_MAX_TIME, see rta_batch.h.
+   A trial R for task i starts at S, or moves on from an R no later than D_i, so it is at most
+   C_i + sum over j < i of (max(D_i, S)/T_j + 1) * C_j, which is the bound below. */
+static int times_exact(const struct rta_batch *b)
+{
+    int    s, i;
+    int    stride = b->stride;
+    double S, U, R_max;
+
+    for (s=0; s<b->n_sets; s++)
+        {
+            S = 0.0;
+            U = 0.0;
+            for (i=0; i<b->n_tasks; i++)
+                {
+                    S += b->C[i*stride + s];
+                    R_max = (b->D[i*stride + s] > S) ? b->D[i*stride + s] : S;
+                    if(S + R_max * U >= RTA_BATCH_MAX_TIME) return 0;
+                    U += b->C[i*stride + s] / b->T[i*stride + s];
+                }
+        }
+    return 1;
+}
+
+/*-----------------------------------------------------------------------------*/
+
+static double *alloc_aligned(size_t n)
+{
+    void *p = NULL;
+    if(posix_memalign(&p, ALIGNMENT, (n+RTA_BATCH_LANES) * sizeof(double)) != 0) return NULL;
+    return (double *) p;
+}
+/*-----------------------------------------------------------------------------*/
@@ -0,0 +1,55 @@
+/* rta_batch.h */
+
+/* Response-Time Analysis of many task sets at once, for sweeps over millions of small task sets.
+
+   All the task sets in a batch have the same number of tasks, and are stored as a
+   struct-of-arrays: C[i*stride + s] is the computing time of the task of priority i in set s.
+   The tasks of each set must already be in priority order, 0 is the highest.
+
+   With AVX2, four task sets are iterated in lockstep, one per 64-bit lane,
+   and lanes whose fixed point has converged, or passed the deadline, are masked out
+   until all four are done. Without AVX2 (or on a processor other than x86) each set is
+   analysed in turn by an ordinary scalar loop, which gives the same answers.
+
+   Times are held as doubles, which represent whole numbers exactly up to 2^53. That does not
+   follow from C, T and D alone: it is every trial response time, and every partial sum of
+   ceil(R/T_j) * C_j, that must stay whole and below 2^53 (R/T_j is then rounded correctly,
+   and ceil() cannot land on the wrong side of a whole number). A trial for task i is at most
+   S + max(D_i, S) * (C_0/T_0 + ... + C_i-1/T_i-1), S = C_0 + ... + C_i, and the analysis refuses
+   a batch in which this bound reaches RTA_BATCH_MAX_TIME, which leaves a factor of two for
+   the rounding of the bound itself. */
+
+#ifndef RTA_BATCH_H
+#define RTA_BATCH_H
+
+#define RTA_BATCH_LANES    4                  /* task sets per AVX2 vector */
+#define RTA_BATCH_MAX_TIME 4503599627370496.0 /* 2^52, the largest trial response time allowed */
+
+struct rta_batch
+{
+    int     n_tasks;     /* tasks per set */
+    int     n_sets;      /* the number of task sets */
+    int     stride;      /* n_sets rounded up to a multiple of RTA_BATCH_LANES */
+    double *C;           /* computing times, [task*stride + set] */
+    double *T;           /* recurrence times */
+    double *D;           /* relative deadlines */
+    double *R;           /* response times, filled in by the analysis,
+                            only meaningful for the sets that are schedulable */
+    char   *schedulable; /* per set, 1 if every task meets its deadline */
+};
+
+/* allocate a batch, aligned for AVX2, returns 0 on success */
+int  rta_batch_alloc(struct rta_batch *b, int n_tasks, int n_sets);
+void rta_batch_free(struct rta_batch *b);
+
+/* analyse every set, with AVX2 if the processor has it, and return the number of schedulable sets,
+   or -1, analysing nothing, if some set's response times could reach RTA_BATCH_MAX_TIME */
+int  rta_batch_analyse(struct rta_batch *b);
+
+/* the same analysis, forced to the scalar loop, with the same check */
+int  rta_batch_analyse_scalar(struct rta_batch *b);
+
+/* 1 if rta_batch_analyse() will use AVX2 on this processor */
+int  rta_batch_has_avx2(void);
+
+#endif /* RTA_BATCH_H */
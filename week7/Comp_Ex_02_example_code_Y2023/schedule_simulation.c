@@ -0,0 +1,185 @@
+/* schedule_simulation.c */
+
+/* A discrete-event scheduler simulation, see schedule_simulation.h */
+
+#include <stdio.h>     /* needed for snprintf() */
+#include <stdlib.h>
+
+#include "schedule_simulation.h"
+
+#define TRACK_NAME_LENGTH 64
+
+/* function templates, for local helpers */
+static int pick_task(const struct task_set *ts, int policy, const long *remaining, const long *abs_deadline);
+
+/*-----------------------------------------------------------------------------*/
+
+int simulate_schedule(const struct task_set *ts, int policy, long horizon, struct sim_result *res)
+{
+    return simulate_schedule_with_tracer(ts, policy, horizon, NULL, res);
+}
+
+/*-----------------------------------------------------------------------------*/
+
+int simulate_schedule_with_tracer(const struct task_set *ts, int policy, long horizon,
+                                  const struct sim_tracer *tr, struct sim_result *res)
+{
+    int   n = ts->n_tasks;
+    int   i;
+    int   running;      /* the task that holds the processor, or -1 for none */
+    int   current = -1; /* the task with an open slice in the trace, or -1 */
+    long  slice_start = 0;
+    char  track_name[TRACK_NAME_LENGTH];
+    long  t = 0;        /* the simulated time */
+    long  next_t;       /* the time of the next event */
+    long *remaining;    /* the remaining computing time of the current job of each task */
+    long *abs_deadline; /* the absolute deadline of the current job of each task */
+    long *next_release; /* the arrival time of the next job of each task */
+
+    res->schedulable     = 1;
+    res->first_miss_task = -1;
+    res->first_miss_time = -1;
+    res->n_events        = 0;
+
+    if((policy != POLICY_RM) & (policy != POLICY_EDF)) return 1;
+    if(horizon <= 0) horizon = hyperperiod(ts);
+    if(horizon <= 0) return 1; /* the hyperperiod overflowed, the caller must choose a horizon */
+
+    remaining    = (long *) malloc((size_t) (n+1) * sizeof(long));
+    abs_deadline = (long *) malloc((size_t) (n+1) * sizeof(long));
+    next_release = (long *) malloc((size_t) (n+1) * sizeof(long));
+    if((remaining == NULL) | (abs_deadline == NULL) | (next_release == NULL))
+        {
+            free(remaining);
+            free(abs_deadline);
+            free(next_release);
+            return 1;
+        }
+
+    /* every task arrives at time 0, the critical instant */
+    for (i=0; i<n; i++)
+        {
+            remaining[i]    = ts->computing_time[i];
+            abs_deadline[i] = ts->deadline[i];
+            next_release[i] = ts->recurrence_time[i];
+
+            if(tr != NULL)
+                {
+                    (void) snprintf(track_name, TRACK_NAME_LENGTH, "task %ld (C = %ld, T = %ld, D = %ld)",
+                                    ts->task_type[i], ts->computing_time[i], ts->recurrence_time[i], ts->deadline[i]);
+                    tr->name_track(tr->ct, ts->task_type[i], track_name);
+                    tr->instant(tr->ct, ts->task_type[i], 0.0, "arrival");
+                }
+        }
+
+    while(t < horizon)
+        {
+            running = pick_task(ts, policy, remaining, abs_deadline);
+
+            /* a change of task closes the slice of the old one, which may have been preempted */
+            if((tr != NULL) & (running != current))
+                {
+                    if(current >= 0)
+                        {
+                            tr->slice(tr->ct, ts->task_type[current], slice_start * tr->us_per_unit, (t - slice_start) * tr->us_per_unit);
+                            if(remaining[current] > 0)
+                                tr->instant(tr->ct, ts->task_type[current], t * tr->us_per_unit, "preemption");
+                        }
+                    current     = running;
+                    slice_start = t;
+                }
+
+            /* find the next event: an arrival, a deadline of unfinished work, or the completion of the running job */
+            next_t = horizon;
+            for (i=0; i<n; i++)
+                {
+                    if(next_release[i] < next_t) next_t = next_release[i];
+                    if((remaining[i] > 0) & (abs_deadline[i] < next_t)) next_t = abs_deadline[i];
+                }
+            if((running >= 0) && (t + remaining[running] < next_t)) next_t = t + remaining[running];
+
+            /* let the running job use the interval */
+            if(running >= 0) remaining[running] -= next_t - t;
+            t = next_t;
+            res->n_events++;
+
+            if((tr != NULL) && (running >= 0) && (remaining[running] == 0))
+                {
+                    /* the running job has completed */
+                    tr->slice(tr->ct, ts->task_type[running], slice_start * tr->us_per_unit, (t - slice_start) * tr->us_per_unit);
+                    current = -1;
+                }
+
+            /* work that is still outstanding at its deadline has missed it */
+            for (i=0; i<n; i++)
+                if((remaining[i] > 0) & (abs_deadline[i] <= t))
+                    {
+                        if(res->schedulable)
+                            {
+                                res->schedulable     = 0;
+                                res->first_miss_task = i;
+                                res->first_miss_time = abs_deadline[i];
+                            }
+                        if(tr == NULL)
+                            {
+                                t = horizon; /* stop the simulation */
+                                break;
+                            }
+
+                        /* when tracing, abandon the late job and carry on */
+                        tr->instant(tr->ct, ts->task_type[i], t * tr->us_per_unit, "deadline miss");
+                        if(i == current)
+                            {
+                                tr->slice(tr->ct, ts->task_type[i], slice_start * tr->us_per_unit, (t - slice_start) * tr->us_per_unit);
+                                current = -1;
+                            }
+                        remaining[i] = 0;
+                    }
+
+            /* arrivals, with D <= T the previous job of the task has finished, or was caught above */
+            for (i=0; i<n; i++)
+                if(next_release[i] == t)
+                    {
+                        remaining[i]    = ts->computing_time[i];
+                        abs_deadline[i] = t + ts->deadline[i];
+                        next_release[i] = t + ts->recurrence_time[i];
+                        if(tr != NULL) tr->instant(tr->ct, ts->task_type[i], t * tr->us_per_unit, "arrival");
+                    }
+        }
+
+    /* close the last slice, at the horizon */
+    if((tr != NULL) & (current >= 0))
+        tr->slice(tr->ct, ts->task_type[current], slice_start * tr->us_per_unit, (t - slice_start) * tr->us_per_unit);
+
+    free(remaining);
+    free(abs_deadline);
+    free(next_release);
+    return 0;
+}
+
+/*-----------------------------------------------------------------------------*/
+
+/* Choose the task to run, from those that have work left, or -1 if the processor is idle */
+static int pick_task(const struct task_set *ts, int policy, const long *remaining, const long *abs_deadline)
+{
+    int i;
+    int best = -1;
+
+    for (i=0; i<ts->n_tasks; i++)
+        {
+            if(remaining[i] <= 0) continue;
+            /* Note the absence of "=" here, as in insert_task_by_rate(), ties keep the order of the file */
+            if(best < 0)
+                best = i;
+            else if(policy == POLICY_EDF)
+                {
+                    if(abs_deadline[i] < abs_deadline[best]) best = i;
+                }
+            else
+                {
+                    if(ts->recurrence_time[i] < ts->recurrence_time[best]) best = i;
+                }
+        }
+    return best;
+}
+/*-----------------------------------------------------------------------------*/
@@ -0,0 +1,58 @@
+/* schedule_simulation.h */
+
+/* A fast, discrete-event version of the scheduler in RM_simulator_07.c.
+
+   Instead of forking children and letting real time pass, the simulator jumps from one
+   event (an arrival, a completion, a deadline) to the next, so a whole hyperperiod of
+   a task file takes micro-seconds rather than a minute.
+   All tasks are released together at time 0, the critical instant.
+   Times are in the units of the task file (TIME_TICKs), or any multiple of them. */
+
+#ifndef SCHEDULE_SIMULATION_H
+#define SCHEDULE_SIMULATION_H
+
+#include "task_set.h"
+
+struct chrome_trace; /* see chrome_trace.h, only a traced simulation needs it */
+
+#define POLICY_RM  0 /* fixed priorities, shortest recurrence time first, as in insert_task_by_rate() */
+#define POLICY_EDF 1 /* dynamic priorities, earliest absolute deadline first */
+
+struct sim_result
+{
+    int  schedulable;     /* 1 if no deadline was missed before the horizon */
+    int  first_miss_task; /* the index of the task that missed first, or -1 */
+    long first_miss_time; /* the time of that missed deadline, or -1 */
+    long n_events;        /* the number of events that were simulated */
+};
+
+/* Simulate the task set from time 0 until the horizon, or until the first deadline miss.
+   A horizon <= 0 means the hyperperiod. Returns 0, or non-zero for a bad argument.
+   Under EDF a job released near the end of the hyperperiod may have its deadline after it,
+   so an exact EDF check needs a horizon of the hyperperiod plus the largest deadline. */
+int simulate_schedule(const struct task_set *ts, int policy, long horizon, struct sim_result *res);
+
+/* Where a traced simulation sends its time-line: the functions of chrome_trace.h fit, but they are
+   reached through these pointers, so that a program that never traces need not link chrome_trace.c */
+struct sim_tracer
+{
+    struct chrome_trace *ct;
+    double               us_per_unit;  /* micro-seconds per unit of time, e.g. TIME_TICK */
+    void (*name_track)(struct chrome_trace *ct, long task_type, const char *name);
+    void (*slice)(struct chrome_trace *ct, long task_type, double start_us, double duration_us);
+    void (*instant)(struct chrome_trace *ct, long task_type, double time_us, const char *name);
+};
+
+/* The simulation behind both of the others, with the time-line sent to tr, if it is not NULL.
+   A traced simulation does not stop at a deadline miss. The late job is abandoned,
+   so that the next job of that task starts afresh, and the rest of the run can be inspected. */
+int simulate_schedule_with_tracer(const struct task_set *ts, int policy, long horizon,
+                                  const struct sim_tracer *tr, struct sim_result *res);
+
+/* The same simulation, writing the time-line to a Chrome trace (see chrome_trace.h),
+   with us_per_unit micro-seconds per unit of time, e.g. TIME_TICK.
+   This one is in schedule_simulation_trace.c, link it, and chrome_trace.c, to use it. */
+int simulate_schedule_traced(const struct task_set *ts, int policy, long horizon,
+                             struct chrome_trace *ct, double us_per_unit, struct sim_result *res);
+
+#endif /* SCHEDULE_SIMULATION_H */
@@ -0,0 +1,27 @@
+/* schedule_simulation_trace.c */
+
+/* The traced scheduler simulation, see schedule_simulation.h
+   It is kept apart from schedule_simulation.c, so that only the programs that trace link chrome_trace.c */
+
+#include <stdlib.h>
+
+#include "schedule_simulation.h"
+#include "chrome_trace.h"
+
+/*-----------------------------------------------------------------------------*/
+
+int simulate_schedule_traced(const struct task_set *ts, int policy, long horizon,
+                             struct chrome_trace *ct, double us_per_unit, struct sim_result *res)
+{
+    struct sim_tracer tr;
+
+    tr.ct          = ct;
+    tr.us_per_unit = us_per_unit;
+    tr.name_track  = chrome_trace_name_track;
+    tr.slice       = chrome_trace_slice;
+    tr.instant     = chrome_trace_instant;
+
+    return simulate_schedule_with_tracer(ts, policy, horizon, (ct != NULL) ? &tr : NULL, res);
+}
+
+/*-----------------------------------------------------------------------------*/
@@ -0,0 +1,158 @@
+/* task_set.c */
+
+/* Reading and holding the task files used by RM_simulator_07.c, see task_set.h */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <limits.h>    /* needed for LONG_MAX */
+
+#include "task_set.h"
+
+#define LINE_LENGTH 256 /* longer lines than this are not expected in a task file */
+
+/*-----------------------------------------------------------------------------*/
+
+int alloc_task_set(struct task_set *ts, int n_tasks)
+{
+    ts->n_tasks         = n_tasks;
+    ts->task_type       = (long *) calloc((size_t) (n_tasks+1), sizeof(long));
+    ts->computing_time  = (long *) calloc((size_t) (n_tasks+1), sizeof(long));
+    ts->recurrence_time = (long *) calloc((size_t) (n_tasks+1), sizeof(long));
+    ts->deadline        = (long *) calloc((size_t) (n_tasks+1), sizeof(long));
+    /* The +1 keeps calloc() honest for an empty set */
+
+    if((ts->task_type == NULL) | (ts->computing_time == NULL) |
+       (ts->recurrence_time == NULL) | (ts->deadline == NULL))
+        {
+            free_task_set(ts);
+            return 1;
+        }
+    return 0;
+}
+
+/*-----------------------------------------------------------------------------*/
+
+void free_task_set(struct task_set *ts)
+{
+    free(ts->task_type);
+    free(ts->computing_time);
+    free(ts->recurrence_time);
+    free(ts->deadline);
+    ts->task_type       = NULL;
+    ts->computing_time  = NULL;
+    ts->recurrence_time = NULL;
+    ts->deadline        = NULL;
+    ts->n_tasks         = 0;
+}
+
+/*-----------------------------------------------------------------------------*/
+
+int read_task_set(const char *file_name, struct task_set *ts)
+{
+    char  line[LINE_LENGTH];
+    int   n_lines = 0;  /* an upper bound on the number of tasks */
+    int   i       = 0;  /* the number of tasks actually read */
+    int   scanval = 0;  /* the number of fields converted by sscanf() */
+    long  type, C, T, D;
+
+    FILE* in_fp = fopen(file_name, "r");
+    if(!in_fp)
+        {
+            perror("File opening failed");
+            return 1;
+        }
+
+    /* first pass, count the lines, so that we know how much to allocate */
+    while(fgets(line, LINE_LENGTH, in_fp) != NULL) n_lines++;
+
+    if(alloc_task_set(ts, n_lines) != 0)
+        {
+            fclose(in_fp);
+            fprintf(stderr, "read_task_set(): out of memory\n");
+            return 1;
+        }
+
+    /* second pass, read the tasks, stopping at the first line that is not a task, as RM_simulator_07.c does */
+    rewind(in_fp);
+    while(fgets(line, LINE_LENGTH, in_fp) != NULL)
+        {
+            scanval = sscanf(line, "%ld %ld %ld %ld", &type, &C, &T, &D);
+            if(scanval < 3) break;
+            if(scanval < 4) D = T; /* implicit deadline */
+
+            if((C <= 0) | (T <= 0) | (D <= 0))
+                {
+                    fprintf(stderr, "read_task_set(): %s: task %ld needs positive C, T and D\n", file_name, type);
+                    fclose(in_fp);
+                    free_task_set(ts);
+                    return 1;
+                }
+            if(D > T)
+                {
+                    /* the analyses and the simulator assume constrained deadlines */
+                    fprintf(stderr, "read_task_set(): %s: task %ld needs D <= T\n", file_name, type);
+                    fclose(in_fp);
+                    free_task_set(ts);
+                    return 1;
+                }
+
+            ts->task_type[i]       = type;
+            ts->computing_time[i]  = C;
+            ts->recurrence_time[i] = T;
+            ts->deadline[i]        = D;
+            i++;
+        }
+    fclose(in_fp);
+
+    ts->n_tasks = i;
+    return 0;
+}
+
+/*-----------------------------------------------------------------------------*/
+
+long hyperperiod(const struct task_set *ts)
+{
+    long H = 1;
+    long G;
+    int  i;
+
+    for (i=0; i<ts->n_tasks; i++)
+        {
+            G = gcd(H, ts->recurrence_time[i]);
+            if(H/G > LONG_MAX/ts->recurrence_time[i]) return -1; /* the LCM is too large to be of any use */
+            H = (H/G) * ts->recurrence_time[i];
+        }
+    return H;
+}
+
+/*-----------------------------------------------------------------------------*/
+/* Andrew's quick & dirty GCD calculator,
+   which might be handy because math.h does not have gcd() */
+long gcd(long a, long b )
+{
+
+    long c;
+    /* deal with boundary cases */
+    if(a<0) a = -a;
+    if(b<0) b= -b;
+    if(a<b)
+        {
+            /* swap a and b */
+            c=a;
+            a=b;
+            b=c;
+        }
+    if (b==0) return 0 ;
+
+    /*implement Euclid's algorithm*/
+    c = a % b;
+    while(c != 0 )
+        {
+            a = b;
+            b = c;
+            c = a % b ;
+        }
+    /* at this point: c==0 ; and a%b == 0; and b is the gcd */
+    return b;
+}
+/*-----------------------------------------------------------------------------*/
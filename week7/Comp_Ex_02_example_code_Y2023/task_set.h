@@ -0,0 +1,43 @@
+/* task_set.h */
+
+/* A task set, as read from the same Tab-Separated task files that RM_simulator_07 uses:
+
+       task_type \t computing_time \t recurrence_time [ \t deadline ] \n
+
+   e.g. RM_example_data_s44_t3.txt .
+   All times are in TIME_TICKs, exactly as they appear in the file.
+   The optional fourth column is a relative deadline, D.
+   When it is absent the deadline is implicit, D = T, as in the lectures.
+   Deadlines are constrained, D <= T.
+
+   Unlike RM_simulator_07.c there is no MAX_TASKS limit, the arrays are malloc()'ed,
+   so that large, generated task sets can be analysed as well. */
+
+#ifndef TASK_SET_H
+#define TASK_SET_H
+
+struct task_set
+{
+    int   n_tasks;          /* the number of task types in the set */
+    long *task_type;        /* labels the type of task */
+    long *computing_time;   /* C, the computing time that each task requires */
+    long *recurrence_time;  /* T, the recurrence time (period) of each task */
+    long *deadline;         /* D, the relative deadline, D = T when not given */
+};
+
+/* read a task file, returns 0 on success, non-zero (with a message on stderr) on failure */
+int  read_task_set(const char *file_name, struct task_set *ts);
+
+/* allocate an empty task set, with room for n_tasks tasks, returns 0 on success */
+int  alloc_task_set(struct task_set *ts, int n_tasks);
+
+/* release the arrays held by a task set */
+void free_task_set(struct task_set *ts);
+
+/* the LCM of the recurrence times, or -1 if it would overflow a long */
+long hyperperiod(const struct task_set *ts);
+
+/* Andrew's quick & dirty GCD calculator, as in RM_simulator_07.c */
+long gcd(long a, long b);
+
+#endif /* TASK_SET_H */